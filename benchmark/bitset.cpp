@@ -0,0 +1,66 @@
+#include <random>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/perf_counters.h"
+
+#include "include/ccollection.h"
+
+static bitset_t* make_bitset(const size_t size, const unsigned seed)
+{
+    std::mt19937_64 random(seed);
+    bitset_t * bitset = bitset_new(size);
+    for (size_t i = 0; i < size / 4; i++)
+    {
+        bitset_set(bitset, random() % size);
+    }
+    return bitset;
+}
+
+static void BM_BitsetCount(benchmark::State& state)
+{
+    bitset_t * bitset = make_bitset(state.range(0), 1);
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bitset_count(bitset));
+    }
+    perf.stop();
+    state.SetBytesProcessed(state.iterations() * state.range(0) / 8);
+    bitset_destroy(bitset);
+}
+BENCHMARK(BM_BitsetCount)->Range(1 << 12, 1 << 28);
+
+// combine two filter masks, the core query operation
+static void BM_BitsetAnd(benchmark::State& state)
+{
+    bitset_t * left = make_bitset(state.range(0), 1);
+    bitset_t * right = make_bitset(state.range(0), 2);
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        bitset_and(left, right);
+        benchmark::ClobberMemory();
+    }
+    perf.stop();
+    state.SetBytesProcessed(state.iterations() * state.range(0) / 4);
+    bitset_destroy(left);
+    bitset_destroy(right);
+}
+BENCHMARK(BM_BitsetAnd)->Range(1 << 12, 1 << 28);
+
+static void BM_BitsetSelect(benchmark::State& state)
+{
+    bitset_t * bitset = make_bitset(state.range(0), 1);
+    const size_t count = bitset_count(bitset);
+    std::mt19937_64 random(3);
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bitset_select(bitset, random() % count));
+    }
+    perf.stop();
+    bitset_destroy(bitset);
+}
+BENCHMARK(BM_BitsetSelect)->Range(1 << 12, 1 << 24);
+
+BENCHMARK_MAIN();
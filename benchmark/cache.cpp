@@ -0,0 +1,60 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/perf_counters.h"
+
+#include "include/ccollection.h"
+
+// zipf distributed keys over 1M distinct ones, a cache of state.range(0) entries in front of them
+static std::vector<uint64_t> make_trace(const size_t length)
+{
+    const size_t keys = 1 << 20;
+    std::vector<double> weights(keys);
+    for (size_t i = 0; i < keys; i++)
+    {
+        weights[i] = 1.0 / std::pow(i + 1, 0.9);
+    }
+    std::discrete_distribution<uint64_t> zipf(weights.begin(), weights.end());
+    std::mt19937_64 random(42);
+
+    std::vector<uint64_t> trace(length);
+    for (auto &key : trace)
+    {
+        key = zipf(random) * 0x9e3779b97f4a7c15ULL;
+    }
+    return trace;
+}
+
+static void BM_CacheZipf(benchmark::State& state, const cache_policy_t policy)
+{
+    static const std::vector<uint64_t> trace = make_trace(1 << 20);
+
+    cache_options_t options = {};
+    options.policy = policy;
+    options.capacity = state.range(0);
+    cache_t * cache = cache_new(sizeof(uint64_t), sizeof(uint64_t), &options);
+
+    size_t i = 0;
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        const uint64_t key = trace[i++ & (trace.size() - 1)];
+        if (cache_find(cache, &key) == NULL)
+        {
+            cache_put(cache, &key, &key);
+        }
+    }
+    perf.stop();
+
+    cache_counters_t counters;
+    cache_get_counters(cache, &counters);
+    state.counters["hit_ratio"] = (double)counters.hits / (counters.hits + counters.misses);
+    cache_destroy(cache);
+}
+BENCHMARK_CAPTURE(BM_CacheZipf, lru, CACHE_POLICY_LRU)->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_CacheZipf, clock, CACHE_POLICY_CLOCK)->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_CacheZipf, s3fifo, CACHE_POLICY_S3FIFO)->Range(1 << 10, 1 << 16);
+
+BENCHMARK_MAIN();
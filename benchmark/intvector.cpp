@@ -0,0 +1,69 @@
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/perf_counters.h"
+
+#include "include/ccollection.h"
+
+// sorted 64 bit ids with small gaps, the shape of our index columns
+static intvector_t* make_ids(const size_t count)
+{
+    std::mt19937_64 random(1);
+    intvector_t * vector = intvector_new();
+    uint64_t id = UINT64_C(1) << 40;
+    for (size_t i = 0; i < count; i++)
+    {
+        id += 1 + random() % 200;
+        intvector_push_back(vector, id);
+    }
+    return vector;
+}
+
+static void BM_IntvectorDecode(benchmark::State& state)
+{
+    intvector_t * vector = make_ids(state.range(0));
+    std::vector<uint64_t> buffer(state.range(0));
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        intvector_decode(vector, 0, buffer.size(), buffer.data());
+        benchmark::ClobberMemory();
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes_per_value"] = (double)intvector_get_memory(vector) / state.range(0);
+    intvector_destroy(vector);
+}
+BENCHMARK(BM_IntvectorDecode)->Range(1 << 10, 1 << 22);
+
+static void BM_IntvectorAt(benchmark::State& state)
+{
+    intvector_t * vector = make_ids(state.range(0));
+    std::mt19937_64 random(2);
+    uint64_t value;
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        intvector_at(vector, random() % state.range(0), &value);
+        benchmark::DoNotOptimize(value);
+    }
+    perf.stop();
+    intvector_destroy(vector);
+}
+BENCHMARK(BM_IntvectorAt)->Range(1 << 10, 1 << 22);
+
+static void BM_IntvectorPushBack(benchmark::State& state)
+{
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        intvector_t * vector = make_ids(state.range(0));
+        intvector_destroy(vector);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IntvectorPushBack)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,213 @@
+#ifndef PERF_COUNTERS_H
+
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+#if defined(CCOLLECTION_PERF_COUNTERS) && defined(__linux__)
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * hardware events reported by perf_counters_t, names are the user counters they show up as
+ */
+struct perf_event_desc_t
+{
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+};
+
+#define PERF_CACHE_MISS(cache) \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const perf_event_desc_t perf_events[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"l1d_misses", PERF_TYPE_HW_CACHE, PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_L1D)},
+    {"llc_misses", PERF_TYPE_HW_CACHE, PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_LL)},
+    {"dtlb_misses", PERF_TYPE_HW_CACHE, PERF_CACHE_MISS(PERF_COUNT_HW_CACHE_DTLB)},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+#define PERF_EVENT_COUNT    (sizeof(perf_events) / sizeof(perf_events[0]))
+
+/**
+ * value of one event together with the time it was enabled and actually counting, the two differ when the kernel
+ * multiplexes more events than the PMU has counters
+ */
+struct perf_sample_t
+{
+    uint64_t value;
+    uint64_t enabled;
+    uint64_t running;
+};
+
+/**
+ * events of the calling thread only, threads it spawns are not counted, each benchmark thread opens its own.
+ * They are opened once per thread and left counting, measurements are differences of two reads. Events the
+ * kernel or the hypervisor does not provide stay closed and are not reported.
+ */
+class perf_events_t
+{
+public:
+    perf_events_t()
+    {
+        int err = 0;
+        for (size_t i = 0; i < PERF_EVENT_COUNT; i++)
+        {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = perf_events[i].type;
+            attr.config = perf_events[i].config;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            fds[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fds[i] < 0 && err == 0)
+            {
+                err = errno;
+            }
+        }
+
+        static bool warned = false;
+        if (err != 0 && !warned)
+        {
+            warned = true;
+            fprintf(stderr, "perf counters: some events are unavailable (%s), check perf_event_paranoid or run "
+                    "outside a virtual machine\n", strerror(err));
+        }
+    }
+
+    ~perf_events_t()
+    {
+        for (size_t i = 0; i < PERF_EVENT_COUNT; i++)
+        {
+            if (fds[i] >= 0)
+            {
+                close(fds[i]);
+            }
+        }
+    }
+
+    void read_all(perf_sample_t *samples) const
+    {
+        for (size_t i = 0; i < PERF_EVENT_COUNT; i++)
+        {
+            if (fds[i] < 0 || read(fds[i], &samples[i], sizeof(samples[i])) != sizeof(samples[i]))
+            {
+                memset(&samples[i], 0, sizeof(samples[i]));
+            }
+        }
+    }
+
+    bool is_open(const size_t i) const
+    {
+        return fds[i] >= 0;
+    }
+
+    static const perf_events_t& get()
+    {
+        static thread_local perf_events_t events;
+        return events;
+    }
+
+private:
+    int fds[PERF_EVENT_COUNT];
+};
+
+/**
+ * counts hardware events from construction to stop and reports them per iteration as user counters of state.
+ * Construct it right before the timed loop and stop it right after, setup and teardown are not meant to count.
+ * Paused timing is still counted.
+ */
+class perf_counters_t
+{
+public:
+    explicit perf_counters_t(benchmark::State& state) : m_state(state), m_running(true)
+    {
+        perf_events_t::get().read_all(m_start);
+    }
+
+    ~perf_counters_t()
+    {
+        stop();
+    }
+
+    void stop()
+    {
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+
+        const perf_events_t& events = perf_events_t::get();
+        perf_sample_t end[PERF_EVENT_COUNT];
+        events.read_all(end);
+
+        double values[PERF_EVENT_COUNT];
+        bool counted[PERF_EVENT_COUNT];
+        for (size_t i = 0; i < PERF_EVENT_COUNT; i++)
+        {
+            const uint64_t enabled = end[i].enabled - m_start[i].enabled;
+            const uint64_t running = end[i].running - m_start[i].running;
+            values[i] = (double)(end[i].value - m_start[i].value);
+            if (running != 0 && running < enabled)
+            {
+                values[i] *= (double)enabled / running;
+            }
+
+            // an event that never got a counter while multiplexed has no value rather than 0
+            counted[i] = events.is_open(i) && running != 0;
+            if (counted[i])
+            {
+                m_state.counters[perf_events[i].name] =
+                    benchmark::Counter(values[i], benchmark::Counter::kAvgIterations);
+            }
+        }
+
+        // cycles and instructions are the first two events
+        if (counted[0] && counted[1] && values[0] > 0)
+        {
+            m_state.counters["ipc"] = values[1] / values[0];
+        }
+    }
+
+private:
+    benchmark::State& m_state;
+    bool m_running;
+    perf_sample_t m_start[PERF_EVENT_COUNT];
+};
+
+#else
+
+/**
+ * perf counters are disabled or not supported, nothing is counted or reported
+ */
+class perf_counters_t
+{
+public:
+    explicit perf_counters_t(benchmark::State&)
+    {
+    }
+
+    void stop()
+    {
+    }
+};
+
+#endif
+
+#endif /* end of include guard: PERF_COUNTERS_H */
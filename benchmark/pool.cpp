@@ -0,0 +1,98 @@
+#include <cstdlib>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/perf_counters.h"
+
+#include "include/ccollection.h"
+
+// keep state.range(0) objects live, release and acquire one per iteration in a scattered order
+template <typename Acquire, typename Release>
+static void churn(benchmark::State& state, Acquire acquire, Release release)
+{
+    std::vector<void*> live(state.range(0));
+    for (auto &slot : live)
+    {
+        slot = acquire();
+    }
+    size_t victim = 0;
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        victim = (victim + 7919) % live.size();
+        release(live[victim]);
+        live[victim] = acquire();
+        benchmark::DoNotOptimize(live[victim]);
+    }
+    perf.stop();
+    for (auto slot : live)
+    {
+        release(slot);
+    }
+}
+
+static void BM_MallocChurn(benchmark::State& state)
+{
+    churn(state, []() { return malloc(48); }, [](void* slot) { free(slot); });
+}
+BENCHMARK(BM_MallocChurn)->Range(1 << 8, 1 << 16);
+
+static void BM_PoolChurn(benchmark::State& state)
+{
+    pool_t * pool = pool_new(48);
+    churn(state, [&]() { return pool_acquire(pool); }, [&](void* slot) { pool_release(pool, slot); });
+    pool_destroy(pool);
+}
+BENCHMARK(BM_PoolChurn)->Range(1 << 8, 1 << 16);
+
+static void BM_PoolCacheChurn(benchmark::State& state)
+{
+    pool_t * pool = pool_new(48);
+    pool_cache_t * cache = pool_cache_new(pool, 0);
+    churn(state, [&]() { return pool_cache_acquire(cache); }, [&](void* slot) { pool_cache_release(cache, slot); });
+    pool_cache_destroy(cache);
+    pool_destroy(pool);
+}
+BENCHMARK(BM_PoolCacheChurn)->Range(1 << 8, 1 << 16);
+
+// every thread allocates through its own cache from one shared pool, created before the threads start and
+// destroyed after all of them finished
+static pool_t * shared_pool = NULL;
+
+static void shared_pool_setup(const benchmark::State&)
+{
+    shared_pool = pool_new(48);
+}
+
+static void shared_pool_teardown(const benchmark::State&)
+{
+    pool_destroy(shared_pool);
+    shared_pool = NULL;
+}
+
+static void BM_PoolCacheThreads(benchmark::State& state)
+{
+    pool_cache_t * cache = pool_cache_new(shared_pool, 0);
+    std::vector<void*> live;
+
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            live.push_back(pool_cache_acquire(cache));
+        }
+        for (auto slot : live)
+        {
+            pool_cache_release(cache, slot);
+        }
+        live.clear();
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * 64);
+    pool_cache_destroy(cache);
+}
+BENCHMARK(BM_PoolCacheThreads)->ThreadRange(1, 8)->UseRealTime()
+    ->Setup(shared_pool_setup)->Teardown(shared_pool_teardown);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,656 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <getopt.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "benchmark/trace.h"
+
+#include "include/ccollection.h"
+
+/**
+ * trace_replay generates or loads a trace of container operations and replays it, reporting throughput, latency
+ * percentiles per op and peak RSS. Unlike the microbenchmarks it interleaves operations on many containers, so
+ * growth and shrink oscillation and allocator fragmentation show up in the numbers.
+ *
+ *     trace_replay generate <trace> [--ops N] [--containers N] [--elem-size B] [--seed S]
+ *     trace_replay run <trace> [--target vector|std]
+ */
+
+#define REPLAY_MAX_ELEMENT  4096            /** larger element sizes are clamped */
+#define REPLAY_MAX_BYTES    (1ull << 30)    /** reserve and assign of more bytes are dropped */
+
+//==============================================================================
+// Targets
+//==============================================================================
+
+/**
+ * a container implementation the trace is replayed against. Ops reaching apply are valid: the container exists,
+ * indices are in range and sizes fit, see normalize. Supporting another container means another target.
+ */
+class replay_target_t
+{
+public:
+    virtual ~replay_target_t()
+    {
+    }
+
+    virtual void open(const size_t containers) = 0;
+    virtual void apply(const trace_op_t& op) = 0;
+    virtual void close() = 0;
+
+    size_t failures = 0;
+
+protected:
+    uint8_t m_item[REPLAY_MAX_ELEMENT] = {};
+};
+
+class replay_vector_t : public replay_target_t
+{
+public:
+    void open(const size_t containers) override
+    {
+        m_vectors.assign(containers, NULL);
+    }
+
+    void apply(const trace_op_t& op) override
+    {
+        vector_t *& vector = m_vectors[op.container];
+        cerror_t err = ERROR_NONE;
+        switch (op.op)
+        {
+            case TRACE_NEW:
+                vector = vector_new(op.size);
+                err = vector != NULL ? ERROR_NONE : ERROR_FAILED;
+                break;
+            case TRACE_DESTROY:
+                err = vector_destroy(vector);
+                vector = NULL;
+                break;
+            case TRACE_PUSH_BACK:
+                err = vector_push_back(vector, m_item);
+                break;
+            case TRACE_POP_BACK:
+                err = vector_pop_back(vector);
+                break;
+            case TRACE_INSERT:
+                err = vector_insert(vector, (pos_t)op.index, m_item);
+                break;
+            case TRACE_ERASE:
+                err = vector_erase(vector, (pos_t)op.index);
+                break;
+            case TRACE_AT:
+                err = vector_at(vector, (pos_t)op.index, m_item);
+                break;
+            case TRACE_RESERVE:
+                err = vector_reserve(vector, op.size);
+                break;
+            case TRACE_ASSIGN:
+                err = vector_assign_n(vector, op.size, m_item);
+                break;
+            case TRACE_CLEAR:
+                err = vector_clear(vector);
+                break;
+        }
+        failures += err != ERROR_NONE;
+    }
+
+    void close() override
+    {
+        for (vector_t * vector : m_vectors)
+        {
+            if (vector != NULL)
+            {
+                vector_destroy(vector);
+            }
+        }
+        m_vectors.clear();
+    }
+
+private:
+    std::vector<vector_t*> m_vectors;
+};
+
+/**
+ * std::vector of bytes holding the same elements, the baseline vector_t is compared against
+ */
+class replay_std_t : public replay_target_t
+{
+public:
+    void open(const size_t containers) override
+    {
+        m_vectors.resize(containers);
+        m_elem_sizes.assign(containers, 0);
+    }
+
+    void apply(const trace_op_t& op) override
+    {
+        std::vector<uint8_t>& vector = m_vectors[op.container];
+        const size_t elem_size = m_elem_sizes[op.container];
+        switch (op.op)
+        {
+            case TRACE_NEW:
+                m_elem_sizes[op.container] = op.size;
+                break;
+            case TRACE_DESTROY:
+                std::vector<uint8_t>().swap(vector);
+                break;
+            case TRACE_PUSH_BACK:
+                vector.insert(vector.end(), m_item, m_item + elem_size);
+                break;
+            case TRACE_POP_BACK:
+                vector.resize(vector.size() - elem_size);
+                break;
+            case TRACE_INSERT:
+                vector.insert(vector.begin() + op.index * elem_size, m_item, m_item + elem_size);
+                break;
+            case TRACE_ERASE:
+                vector.erase(vector.begin() + op.index * elem_size, vector.begin() + (op.index + 1) * elem_size);
+                break;
+            case TRACE_AT:
+                memcpy(m_item, vector.data() + op.index * elem_size, elem_size);
+                break;
+            case TRACE_RESERVE:
+                vector.reserve(op.size * elem_size);
+                break;
+            case TRACE_ASSIGN:
+                vector.resize(std::max<size_t>(vector.size(), op.size * elem_size));
+                for (size_t i = 0; i < op.size; i++)
+                {
+                    memcpy(vector.data() + i * elem_size, m_item, elem_size);
+                }
+                break;
+            case TRACE_CLEAR:
+                vector.clear();
+                break;
+        }
+    }
+
+    void close() override
+    {
+        m_vectors.clear();
+        m_elem_sizes.clear();
+    }
+
+private:
+    std::vector<std::vector<uint8_t>> m_vectors;
+    std::vector<size_t> m_elem_sizes;
+};
+
+static replay_target_t* replay_target_new(const std::string& name)
+{
+    if (name == "vector")
+    {
+        return new replay_vector_t();
+    }
+    if (name == "std")
+    {
+        return new replay_std_t();
+    }
+    return NULL;
+}
+
+//==============================================================================
+// Normalization
+//==============================================================================
+
+/**
+ * make every op valid for any target by tracking container sizes: indices wrap into range and ops on missing
+ * containers, pops of empty ones and oversized requests are dropped. Container ids are renumbered densely in the
+ * order they first appear, returns the number of distinct ids.
+ */
+static size_t normalize(std::vector<trace_op_t>* ops, size_t* dropped)
+{
+    struct state_t
+    {
+        bool alive;
+        uint64_t size;
+        uint64_t elem_size;
+    };
+    std::vector<state_t> states;
+    std::unordered_map<uint32_t, uint32_t> ids;
+
+    size_t kept = 0;
+    for (trace_op_t op : *ops)
+    {
+        const auto id = ids.emplace(op.container, (uint32_t)states.size());
+        if (id.second)
+        {
+            states.push_back(state_t());
+        }
+        op.container = id.first->second;
+        state_t& state = states[op.container];
+
+        bool valid = state.alive || op.op == TRACE_NEW;
+        switch (op.op)
+        {
+            case TRACE_NEW:
+                valid = !state.alive;
+                op.size = std::min<uint64_t>(std::max<uint64_t>(op.size, 1), REPLAY_MAX_ELEMENT);
+                if (valid)
+                {
+                    state = state_t{true, 0, op.size};
+                }
+                break;
+            case TRACE_DESTROY:
+                state.alive = false;
+                break;
+            case TRACE_PUSH_BACK:
+                state.size++;
+                break;
+            case TRACE_POP_BACK:
+                valid = valid && state.size > 0;
+                state.size -= valid;
+                break;
+            case TRACE_INSERT:
+                op.index = valid ? op.index % (state.size + 1) : 0;
+                state.size += valid;
+                break;
+            case TRACE_ERASE:
+            case TRACE_AT:
+                valid = valid && state.size > 0;
+                op.index = valid ? op.index % state.size : 0;
+                state.size -= valid && op.op == TRACE_ERASE;
+                break;
+            case TRACE_RESERVE:
+            case TRACE_ASSIGN:
+                // vector_assign_n takes at least one element
+                valid = valid && op.size <= REPLAY_MAX_BYTES / state.elem_size &&
+                    (op.size > 0 || op.op == TRACE_RESERVE);
+                if (valid && op.op == TRACE_ASSIGN)
+                {
+                    state.size = std::max(state.size, op.size);
+                }
+                break;
+            case TRACE_CLEAR:
+                state.size = 0;
+                break;
+        }
+
+        if (valid)
+        {
+            (*ops)[kept++] = op;
+        }
+    }
+
+    *dropped = ops->size() - kept;
+    ops->resize(kept);
+    return states.size();
+}
+
+//==============================================================================
+// Generation
+//==============================================================================
+
+/**
+ * synthetic workload: 80% of the ops go to a hot fifth of the containers, each container grows to a random
+ * target and then shrinks well below it, and containers are destroyed and recreated now and then
+ */
+static bool generate(const char* path, const size_t count, const uint32_t containers, const uint32_t elem_size,
+        const uint64_t seed)
+{
+    struct state_t
+    {
+        bool alive;
+        bool growing;
+        uint64_t size;
+        uint64_t target;
+    };
+    static const uint32_t elem_sizes[] = {4, 8, 16, 64};
+
+    std::mt19937_64 random(seed);
+    std::vector<state_t> states(containers, state_t());
+    trace_writer_t writer;
+    if (!writer.open(path))
+    {
+        return false;
+    }
+
+    auto new_target = [&random]() { return 1 + random() % (1u << (random() % 14)); };
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint32_t hot = std::max<uint32_t>(containers / 5, 1);
+        const uint32_t id = random() % 100 < 80 ? random() % hot : random() % containers;
+        state_t& state = states[id];
+        bool ok = true;
+
+        if (!state.alive)
+        {
+            ok = writer.record(TRACE_NEW, id, 0, elem_size != 0 ? elem_size : elem_sizes[random() % 4]);
+            state = state_t{true, true, 0, new_target()};
+            if (!ok)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        const uint64_t roll = random() % 1000;
+        const uint64_t kind = random() % 100;
+        if (roll < 5)
+        {
+            ok = writer.record(TRACE_DESTROY, id);
+            state.alive = false;
+        }
+        else if (roll < 300 && state.size > 0)
+        {
+            ok = writer.record(TRACE_AT, id, random() % state.size);
+        }
+        else if (state.growing)
+        {
+            if (kind < 85)
+            {
+                ok = writer.record(TRACE_PUSH_BACK, id);
+                state.size++;
+            }
+            else if (kind < 95)
+            {
+                ok = writer.record(TRACE_INSERT, id, random() % (state.size + 1));
+                state.size++;
+            }
+            else if (kind < 97)
+            {
+                ok = writer.record(TRACE_RESERVE, id, 0, state.target);
+            }
+            else
+            {
+                ok = writer.record(TRACE_ASSIGN, id, 0, std::max<uint64_t>(state.target / 2, 1));
+                state.size = std::max<uint64_t>(state.size, std::max<uint64_t>(state.target / 2, 1));
+            }
+
+            if (state.size >= state.target)
+            {
+                state.growing = false;
+                state.target = state.size / (2 + random() % 7);
+            }
+        }
+        else
+        {
+            if (kind < 80)
+            {
+                ok = writer.record(TRACE_POP_BACK, id);
+                state.size--;
+            }
+            else if (kind < 99)
+            {
+                ok = writer.record(TRACE_ERASE, id, random() % state.size);
+                state.size--;
+            }
+            else
+            {
+                ok = writer.record(TRACE_CLEAR, id);
+                state.size = 0;
+            }
+
+            if (state.size <= state.target)
+            {
+                state.growing = true;
+                state.target = new_target();
+            }
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return writer.close();
+}
+
+//==============================================================================
+// Replay
+//==============================================================================
+
+static double now_ns()
+{
+    return std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double resident_mb()
+{
+    long pages = 0, resident = 0;
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm != NULL)
+    {
+        if (fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+        {
+            resident = 0;
+        }
+        fclose(statm);
+    }
+    return (double)resident * sysconf(_SC_PAGESIZE) / (1 << 20);
+}
+
+/**
+ * reset the resident high-water mark to the current RSS, so the peak measured afterwards leaves out the trace
+ * loader's buffers. Returns false if the kernel does not support it.
+ */
+static bool reset_peak_resident()
+{
+    FILE *clear_refs = fopen("/proc/self/clear_refs", "w");
+    if (clear_refs == NULL)
+    {
+        return false;
+    }
+    const bool reset = fputs("5", clear_refs) >= 0;
+    return fclose(clear_refs) == 0 && reset;
+}
+
+/**
+ * peak RSS since the last reset_peak_resident, or over the whole process if VmHWM can not be read
+ */
+static double peak_resident_mb()
+{
+    long peak_kb = -1;
+    char line[256];
+    FILE *status = fopen("/proc/self/status", "r");
+    if (status != NULL)
+    {
+        while (peak_kb < 0 && fgets(line, sizeof(line), status) != NULL)
+        {
+            if (sscanf(line, "VmHWM: %ld kB", &peak_kb) != 1)
+            {
+                peak_kb = -1;
+            }
+        }
+        fclose(status);
+    }
+    if (peak_kb < 0)
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        peak_kb = usage.ru_maxrss;
+    }
+    return peak_kb / 1024.0;
+}
+
+/**
+ * smallest cost of reading the clock twice, subtracted from every latency sample
+ */
+static double timer_overhead_ns()
+{
+    double overhead = 1e9;
+    for (int i = 0; i < 1000; i++)
+    {
+        const double start = now_ns();
+        overhead = std::min(overhead, now_ns() - start);
+    }
+    return overhead;
+}
+
+static void print_percentiles(const char* name, std::vector<float>& samples)
+{
+    if (samples.empty())
+    {
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](const double q)
+    {
+        return samples[std::min(samples.size() - 1, (size_t)(q * samples.size()))];
+    };
+    printf("%-10s %10zu %8.0f %8.0f %8.0f %8.0f %10.0f\n", name, samples.size(), at(0.5), at(0.9), at(0.99),
+            at(0.999), samples.back());
+}
+
+static int run(const char* path, const std::string& target_name)
+{
+    std::vector<trace_op_t> ops;
+    std::string error;
+    if (!trace_load(path, &ops, &error))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return EXIT_FAILURE;
+    }
+
+    replay_target_t *target = replay_target_new(target_name);
+    if (target == NULL)
+    {
+        fprintf(stderr, "unknown target %s, use vector or std\n", target_name.c_str());
+        return EXIT_FAILURE;
+    }
+
+    size_t dropped = 0;
+    const size_t containers = normalize(&ops, &dropped);
+    printf("trace %s: %zu ops on %zu containers, %zu invalid ops dropped\n", path, ops.size(), containers, dropped);
+
+    // first pass untimed per op for throughput and memory, the allocator state it leaves behind is reused.
+    // The loader's peak is forgotten first so the peak below is the replay's own
+    if (!reset_peak_resident())
+    {
+        printf("could not reset the RSS high-water mark, peak RSS includes loading the trace\n");
+    }
+    const double resident = resident_mb();
+    target->open(containers);
+    const double start = now_ns();
+    for (const trace_op_t& op : ops)
+    {
+        target->apply(op);
+    }
+    const double elapsed = now_ns() - start;
+    target->close();
+    const double peak = peak_resident_mb();
+
+    printf("target %s: %.2f Mops/s, %.1f ns/op, peak RSS %.1f MiB (+%.1f MiB during replay), %zu failed ops\n",
+            target_name.c_str(), ops.size() * 1e3 / elapsed, elapsed / std::max<size_t>(ops.size(), 1), peak,
+            std::max(0.0, peak - resident), target->failures);
+
+    // second pass timing every op
+    std::vector<std::vector<float>> latencies(TRACE_OP_COUNT);
+    std::vector<float> all;
+    all.reserve(ops.size());
+    const double overhead = timer_overhead_ns();
+
+    target->open(containers);
+    for (const trace_op_t& op : ops)
+    {
+        const double begin = now_ns();
+        target->apply(op);
+        const float latency = (float)std::max(0.0, now_ns() - begin - overhead);
+        latencies[op.op].push_back(latency);
+        all.push_back(latency);
+    }
+    target->close();
+
+    printf("\nlatency in ns, %.0f ns timer overhead subtracted\n", overhead);
+    printf("%-10s %10s %8s %8s %8s %8s %10s\n", "op", "count", "p50", "p90", "p99", "p99.9", "max");
+    for (int op = 0; op < TRACE_OP_COUNT; op++)
+    {
+        print_percentiles(trace_op_names[op], latencies[op]);
+    }
+    print_percentiles("all", all);
+
+    delete target;
+    return EXIT_SUCCESS;
+}
+
+//==============================================================================
+// Command line
+//==============================================================================
+
+static void usage(const char* name)
+{
+    fprintf(stderr, "usage: %s generate <trace> [--ops N] [--containers N] [--elem-size B] [--seed S]\n"
+            "       %s run <trace> [--target vector|std]\n"
+            "an element size of 0 mixes 4, 8, 16 and 64 byte elements\n", name, name);
+}
+
+int main(int argc, char** argv)
+{
+    static const struct option options[] = {
+        {"ops", required_argument, NULL, 'o'},
+        {"containers", required_argument, NULL, 'c'},
+        {"elem-size", required_argument, NULL, 'e'},
+        {"seed", required_argument, NULL, 's'},
+        {"target", required_argument, NULL, 't'},
+        {NULL, 0, NULL, 0},
+    };
+
+    size_t ops = 1000000;
+    uint32_t containers = 1000;
+    uint32_t elem_size = 0;
+    uint64_t seed = 1;
+    std::string target = "vector";
+
+    int option;
+    while ((option = getopt_long(argc, argv, "o:c:e:s:t:", options, NULL)) != -1)
+    {
+        switch (option)
+        {
+            case 'o':
+                ops = strtoull(optarg, NULL, 0);
+                break;
+            case 'c':
+                containers = std::max<uint32_t>(strtoul(optarg, NULL, 0), 1);
+                break;
+            case 'e':
+                elem_size = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 0);
+                break;
+            case 't':
+                target = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 2)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const std::string command = argv[optind];
+    const char *path = argv[optind + 1];
+    if (command == "generate")
+    {
+        if (!generate(path, ops, containers, elem_size, seed))
+        {
+            fprintf(stderr, "%s: %s\n", path, strerror(errno));
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    if (command == "run")
+    {
+        return run(path, target);
+    }
+
+    usage(argv[0]);
+    return EXIT_FAILURE;
+}
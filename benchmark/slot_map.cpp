@@ -0,0 +1,82 @@
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/perf_counters.h"
+
+#include "include/ccollection.h"
+
+// churn a table of state.range(0) elements: erase a random element and insert a new one
+static void BM_SlotMapChurn(benchmark::State& state)
+{
+    slot_map_t * map = slot_map_new(sizeof(int64_t));
+    std::vector<slot_handle_t> handles(state.range(0));
+    std::mt19937 random(42);
+
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+        slot_map_insert(map, &i, &handles[i]);
+    }
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        size_t victim = random() % handles.size();
+        int64_t item = victim;
+        slot_map_erase(map, handles[victim]);
+        slot_map_insert(map, &item, &handles[victim]);
+    }
+    perf.stop();
+    slot_map_destroy(map);
+}
+BENCHMARK(BM_SlotMapChurn)->Range(1 << 8, 1 << 16);
+
+// the same churn on a vector, erase shifts the tail and positions are the only handles
+static void BM_VectorChurn(benchmark::State& state)
+{
+    vector_t * vector = vector_new(sizeof(int64_t));
+    std::mt19937 random(42);
+
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+        vector_push_back(vector, &i);
+    }
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        int64_t item = random() % state.range(0);
+        vector_erase(vector, item);
+        vector_push_back(vector, &item);
+    }
+    perf.stop();
+    vector_destroy(vector);
+}
+BENCHMARK(BM_VectorChurn)->Range(1 << 8, 1 << 16);
+
+// walk every element through the dense array
+static void BM_SlotMapIterate(benchmark::State& state)
+{
+    slot_map_t * map = slot_map_new(sizeof(int64_t));
+    slot_handle_t handle;
+
+    for (int64_t i = 0; i < state.range(0); i++)
+    {
+        slot_map_insert(map, &i, &handle);
+    }
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        int64_t sum = 0;
+        iterator_t it;
+        for (slot_map_cbegin(map, &it); iterator_valid(&it); iterator_next(&it))
+        {
+            sum += *(const int64_t*)iterator_get(&it);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    slot_map_destroy(map);
+}
+BENCHMARK(BM_SlotMapIterate)->Range(1 << 8, 1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,215 @@
+#ifndef TRACE_H
+
+#define TRACE_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * compact binary traces of container operations, replayed by trace_replay.
+ *
+ * A trace is the 8 byte magic "CCTRACE1" followed by one record per operation: the op byte and then, as LEB128
+ * varints, the container id and whichever of index and size the op takes (see trace_op_fields). Most records
+ * are 2 to 5 bytes. Container ids are any 32 bit values, small ones encode shorter and replay renumbers them
+ * densely; NEW sets the element size of an id and may reuse the id of a destroyed container.
+ */
+
+enum trace_op_kind_t
+{
+    TRACE_NEW,          /** create container, size is the element size */
+    TRACE_DESTROY,      /** destroy container */
+    TRACE_PUSH_BACK,    /** append one element */
+    TRACE_POP_BACK,     /** remove the last element */
+    TRACE_INSERT,       /** insert one element before index */
+    TRACE_ERASE,        /** remove the element at index */
+    TRACE_AT,           /** read the element at index */
+    TRACE_RESERVE,      /** reserve size elements */
+    TRACE_ASSIGN,       /** overwrite the first size elements with one element, growing to size if smaller */
+    TRACE_CLEAR,        /** remove every element */
+    TRACE_OP_COUNT
+};
+
+#define TRACE_FIELD_INDEX   1
+#define TRACE_FIELD_SIZE    2
+
+static const uint8_t trace_op_fields[TRACE_OP_COUNT] = {
+    TRACE_FIELD_SIZE, 0, 0, 0, TRACE_FIELD_INDEX, TRACE_FIELD_INDEX, TRACE_FIELD_INDEX, TRACE_FIELD_SIZE,
+    TRACE_FIELD_SIZE, 0,
+};
+
+static const char * const trace_op_names[TRACE_OP_COUNT] = {
+    "new", "destroy", "push_back", "pop_back", "insert", "erase", "at", "reserve", "assign", "clear",
+};
+
+static const char trace_magic[8] = {'C', 'C', 'T', 'R', 'A', 'C', 'E', '1'};
+
+/**
+ * one decoded record, index and size are 0 for ops that do not take them
+ */
+struct trace_op_t
+{
+    uint8_t op;
+    uint32_t container;
+    uint64_t index;
+    uint64_t size;
+};
+
+//==============================================================================
+// Recording
+//==============================================================================
+
+/**
+ * appends records to a trace file, services can include this header to record their own workloads
+ */
+class trace_writer_t
+{
+public:
+    trace_writer_t() : m_file(NULL), m_used(0)
+    {
+    }
+
+    ~trace_writer_t()
+    {
+        close();
+    }
+
+    bool open(const char* path)
+    {
+        m_file = fopen(path, "wb");
+        return m_file != NULL && fwrite(trace_magic, sizeof(trace_magic), 1, m_file) == 1;
+    }
+
+    bool record(const uint8_t op, const uint32_t container, const uint64_t index = 0, const uint64_t size = 0)
+    {
+        if (op >= TRACE_OP_COUNT || (m_used + 32 > sizeof(m_buffer) && !flush()))
+        {
+            return false;
+        }
+
+        m_buffer[m_used++] = op;
+        put_varint(container);
+        if (trace_op_fields[op] & TRACE_FIELD_INDEX)
+        {
+            put_varint(index);
+        }
+        if (trace_op_fields[op] & TRACE_FIELD_SIZE)
+        {
+            put_varint(size);
+        }
+        return true;
+    }
+
+    bool close()
+    {
+        bool ok = true;
+        if (m_file != NULL)
+        {
+            ok = flush();
+            ok = fclose(m_file) == 0 && ok;
+            m_file = NULL;
+        }
+        return ok;
+    }
+
+private:
+    void put_varint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            m_buffer[m_used++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        m_buffer[m_used++] = (uint8_t)value;
+    }
+
+    bool flush()
+    {
+        bool ok = m_used == 0 || fwrite(m_buffer, m_used, 1, m_file) == 1;
+        m_used = 0;
+        return ok;
+    }
+
+    FILE *m_file;
+    size_t m_used;
+    uint8_t m_buffer[1 << 16];
+};
+
+//==============================================================================
+// Loading
+//==============================================================================
+
+static bool trace_get_varint(const std::vector<uint8_t>& data, size_t* pos, uint64_t* value)
+{
+    *value = 0;
+    for (unsigned shift = 0; shift < 64 && *pos < data.size(); shift += 7)
+    {
+        const uint8_t byte = data[(*pos)++];
+        *value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * decode the whole trace at path into ops, on failure error describes what is wrong with it
+ */
+static bool trace_load(const char* path, std::vector<trace_op_t>* ops, std::string* error)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        *error = std::string(path) + ": " + strerror(errno);
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[1 << 16];
+    size_t count;
+    while ((count = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + count);
+    }
+    fclose(file);
+
+    if (data.size() < sizeof(trace_magic) || memcmp(data.data(), trace_magic, sizeof(trace_magic)) != 0)
+    {
+        *error = std::string(path) + ": not a trace";
+        return false;
+    }
+
+    ops->clear();
+    size_t pos = sizeof(trace_magic);
+    while (pos < data.size())
+    {
+        const size_t start = pos;
+        trace_op_t op = {};
+        uint64_t container = 0;
+        op.op = data[pos++];
+        bool ok = op.op < TRACE_OP_COUNT && trace_get_varint(data, &pos, &container) && container <= UINT32_MAX;
+        if (ok && (trace_op_fields[op.op] & TRACE_FIELD_INDEX))
+        {
+            ok = trace_get_varint(data, &pos, &op.index);
+        }
+        if (ok && (trace_op_fields[op.op] & TRACE_FIELD_SIZE))
+        {
+            ok = trace_get_varint(data, &pos, &op.size);
+        }
+        if (!ok)
+        {
+            *error = std::string(path) + ": bad record at offset " + std::to_string(start);
+            return false;
+        }
+        op.container = (uint32_t)container;
+        ops->push_back(op);
+    }
+    return true;
+}
+
+#endif /* end of include guard: TRACE_H */
@@ -0,0 +1,115 @@
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark/perf_counters.h"
+
+#include "include/ccollection.h"
+
+// short strings like identifiers or tags, allocated in a shuffled order as a long running service would
+static std::vector<std::string> make_strings(const size_t count)
+{
+    std::mt19937 random(42);
+    std::vector<std::string> strings(count);
+    for (auto &value : strings)
+    {
+        value = std::string(4 + random() % 28, 'a' + random() % 26);
+    }
+    return strings;
+}
+
+static void BM_VarvectorScan(benchmark::State& state)
+{
+    const std::vector<std::string> strings = make_strings(state.range(0));
+    varvector_t * vector = varvector_new();
+    for (auto &value : strings)
+    {
+        varvector_push_back(vector, value.data(), value.size());
+    }
+
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        const varvector_span_t *spans = varvector_spans(vector);
+        const uint8_t *arena = varvector_arena(vector);
+        size_t count = 0;
+        for (size_t i = 0; i < strings.size(); i++)
+        {
+            count += arena[spans[i].offset] == 'e';
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    varvector_destroy(vector);
+}
+BENCHMARK(BM_VarvectorScan)->Range(1 << 10, 1 << 22);
+
+// the layout varvector replaces, a vector of pointers to separately allocated strings
+static void BM_PointerVectorScan(benchmark::State& state)
+{
+    const std::vector<std::string> strings = make_strings(state.range(0));
+    std::vector<char*> buffers(strings.size());
+    std::vector<size_t> order(strings.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    for (size_t i : order)
+    {
+        buffers[i] = strdup(strings[i].c_str());
+    }
+
+    vector_t * vector = vector_new(sizeof(char*));
+    for (char *buffer : buffers)
+    {
+        vector_push_back(vector, &buffer);
+    }
+
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        char * const *items = (char * const *)vector_cdata(vector);
+        size_t count = 0;
+        for (size_t i = 0; i < strings.size(); i++)
+        {
+            count += items[i][0] == 'e';
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+
+    vector_destroy(vector);
+    for (char *buffer : buffers)
+    {
+        free(buffer);
+    }
+}
+BENCHMARK(BM_PointerVectorScan)->Range(1 << 10, 1 << 22);
+
+static void BM_VarvectorPushBack(benchmark::State& state)
+{
+    const std::vector<std::string> strings = make_strings(state.range(0));
+
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        varvector_t * vector = varvector_new();
+        for (auto &value : strings)
+        {
+            varvector_push_back(vector, value.data(), value.size());
+        }
+        varvector_destroy(vector);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VarvectorPushBack)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
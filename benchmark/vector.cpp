@@ -1,17 +1,22 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
+#include <unistd.h>
 
 #include "benchmark/benchmark.h"
+#include "benchmark/perf_counters.h"
 
 #include "include/ccollection.h"
 
 static void BM_VectorNew(benchmark::State& state)
 {
     vector_t * vector = NULL;
+    perf_counters_t perf(state);
     while(state.KeepRunning())
     {
         vector = vector_new(sizeof(int));
     }
+    perf.stop();
 }
 BENCHMARK(BM_VectorNew);
 
@@ -19,11 +24,13 @@ BENCHMARK(BM_VectorNew);
 static void BM_VectorDestroy(benchmark::State& state)
 {
     vector_t * vector = NULL;
+    perf_counters_t perf(state);
     while(state.KeepRunning())
     {
         vector = vector_new(sizeof(int));
         vector_destroy(vector);
     }
+    perf.stop();
 }
 BENCHMARK(BM_VectorDestroy);
 #endif
@@ -32,16 +39,256 @@ static void BM_VectorPushBack(benchmark::State& state)
 {
 
     vector_t * vector = vector_new(sizeof(int));
+    perf_counters_t perf(state);
     while(state.KeepRunning())
     {
 
-        for (int i = 0; i < state.range_x(); i++)
+        for (int i = 0; i < state.range(0); i++)
         {
             vector_push_back(vector, &i);
         }
     }
+    perf.stop();
     vector_destroy(vector);
 }
 BENCHMARK(BM_VectorPushBack)->RangeMultiplier(2)->Range(1, 1 << 2);
 
-BENCHMARK_MAIN()
+static vector_t* gather_vector(const size_t size)
+{
+    vector_t * vector = vector_new(sizeof(uint64_t));
+    vector_reserve(vector, size);
+    for (uint64_t i = 0; i < size; i++)
+    {
+        vector_push_back(vector, &i);
+    }
+    return vector;
+}
+
+static std::vector<pos_t> gather_indices(const size_t n, const size_t size)
+{
+    std::vector<pos_t> indices(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        indices[i] = rand() % size;
+    }
+    return indices;
+}
+
+// random lookups in a vector larger than the last level cache, one vector_at per index
+static void BM_VectorAtRandom(benchmark::State& state)
+{
+    vector_t * vector = gather_vector(1 << 23);
+    std::vector<pos_t> indices = gather_indices(state.range(0), 1 << 23);
+    std::vector<uint64_t> out(indices.size());
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            vector_at(vector, indices[i], &out[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * indices.size());
+    vector_destroy(vector);
+}
+BENCHMARK(BM_VectorAtRandom)->Arg(1 << 16);
+
+// the same lookups batched, range(1) is the prefetch distance
+static void BM_VectorGather(benchmark::State& state)
+{
+    vector_t * vector = gather_vector(1 << 23);
+    std::vector<pos_t> indices = gather_indices(state.range(0), 1 << 23);
+    std::vector<uint64_t> out(indices.size());
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        vector_gather_prefetch(vector, indices.data(), indices.size(), out.data(), state.range(1));
+        benchmark::DoNotOptimize(out.data());
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * indices.size());
+    vector_destroy(vector);
+}
+BENCHMARK(BM_VectorGather)->Args({1 << 16, 0})->Args({1 << 16, 8})->Args({1 << 16, VECTOR_PREFETCH_DISTANCE})
+    ->Args({1 << 16, 32});
+
+static void BM_VectorScatter(benchmark::State& state)
+{
+    vector_t * vector = gather_vector(1 << 23);
+    std::vector<pos_t> indices = gather_indices(state.range(0), 1 << 23);
+    std::vector<uint64_t> in(indices.size(), 1);
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        vector_scatter_prefetch(vector, indices.data(), indices.size(), in.data(), state.range(1));
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * indices.size());
+    vector_destroy(vector);
+}
+BENCHMARK(BM_VectorScatter)->Args({1 << 16, 0})->Args({1 << 16, VECTOR_PREFETCH_DISTANCE});
+
+static vector_t* sorted_ids(const size_t n, const uint32_t range)
+{
+    std::vector<uint32_t> ids(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        ids[i] = rand() % range;
+    }
+    std::sort(ids.begin(), ids.end());
+
+    vector_t * vector = vector_new(sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++)
+    {
+        vector_push_back(vector, &ids[i]);
+    }
+    vector_unique(vector, NULL);
+    return vector;
+}
+
+// id lists of range(0) and range(1) elements drawn from the same range, skewed sizes gallop
+static void BM_VectorIntersection(benchmark::State& state)
+{
+    const uint32_t range = 4 * MAX(state.range(0), state.range(1));
+    vector_t * first = sorted_ids(state.range(0), range);
+    vector_t * second = sorted_ids(state.range(1), range);
+    vector_t * out = vector_new(sizeof(uint32_t));
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        vector_intersection(first, second, out, NULL);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * (vector_get_size(first) + vector_get_size(second)));
+    vector_destroy(first);
+    vector_destroy(second);
+    vector_destroy(out);
+}
+BENCHMARK(BM_VectorIntersection)->Args({1 << 16, 1 << 16})->Args({1 << 8, 1 << 16});
+
+static void BM_VectorUnion(benchmark::State& state)
+{
+    vector_t * first = sorted_ids(state.range(0), 4 * state.range(0));
+    vector_t * second = sorted_ids(state.range(0), 4 * state.range(0));
+    vector_t * out = vector_new(sizeof(uint32_t));
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        vector_union(first, second, out, NULL);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * (vector_get_size(first) + vector_get_size(second)));
+    vector_destroy(first);
+    vector_destroy(second);
+    vector_destroy(out);
+}
+BENCHMARK(BM_VectorUnion)->Arg(1 << 16);
+
+static vector_t* random_keys(const size_t n)
+{
+    vector_t * vector = vector_new(sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++)
+    {
+        uint32_t key = rand();
+        vector_push_back(vector, &key);
+    }
+    return vector;
+}
+
+// median of range(0) keys against sorting all of them, the copy is timed in both
+static void BM_VectorNthElement(benchmark::State& state)
+{
+    vector_t * keys = random_keys(state.range(0));
+    vector_t * vector = vector_new(sizeof(uint32_t));
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        vector_clear(vector);
+        for (size_t i = 0; i < vector_get_size(keys); i++)
+        {
+            vector_push_back(vector, (const uint32_t*)vector_cdata(keys) + i);
+        }
+        vector_nth_element(vector, vector_get_size(vector) / 2, NULL);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    vector_destroy(vector);
+    vector_destroy(keys);
+}
+BENCHMARK(BM_VectorNthElement)->Arg(1 << 20);
+
+static void BM_VectorSort(benchmark::State& state)
+{
+    vector_t * keys = random_keys(state.range(0));
+    vector_t * vector = vector_new(sizeof(uint32_t));
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        vector_clear(vector);
+        for (size_t i = 0; i < vector_get_size(keys); i++)
+        {
+            vector_push_back(vector, (const uint32_t*)vector_cdata(keys) + i);
+        }
+        vector_partial_sort(vector, vector_get_size(vector), NULL);
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    vector_destroy(vector);
+    vector_destroy(keys);
+}
+BENCHMARK(BM_VectorSort)->Arg(1 << 20);
+
+// top 100 of range(0) keys pushed in batches of 4096
+static void BM_VectorTopK(benchmark::State& state)
+{
+    vector_t * keys = random_keys(state.range(0));
+    vector_topk_t * topk = vector_topk_new(sizeof(uint32_t), 100, NULL);
+    const uint32_t * data = (const uint32_t*)vector_cdata(keys);
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        vector_topk_clear(topk);
+        for (size_t i = 0; i < vector_get_size(keys); i += 4096)
+        {
+            vector_topk_push_n(topk, data + i, MIN(4096, vector_get_size(keys) - i));
+        }
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    vector_topk_destroy(topk);
+    vector_destroy(keys);
+}
+BENCHMARK(BM_VectorTopK)->Arg(1 << 20);
+
+// external sort of range(0) MB of 64 bit keys with a budget of range(1) MB
+static void BM_VectorSortFile(benchmark::State& state)
+{
+    char input[] = "/tmp/ccollection_bench_sort_XXXXXX";
+    char output[] = "/tmp/ccollection_bench_sorted_XXXXXX";
+    close(mkstemp(output));
+    FILE * file = fdopen(mkstemp(input), "wb");
+    const size_t count = (state.range(0) << 20) / sizeof(uint64_t);
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t key = ((uint64_t)rand() << 32) | rand();
+        fwrite(&key, sizeof(key), 1, file);
+    }
+    fclose(file);
+
+    vector_sort_options_t options = {};
+    options.memory_budget = state.range(1) << 20;
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        vector_sort_file(input, output, sizeof(uint64_t), NULL, &options);
+    }
+    perf.stop();
+    state.SetBytesProcessed(state.iterations() * (state.range(0) << 20));
+    unlink(input);
+    unlink(output);
+}
+BENCHMARK(BM_VectorSortFile)->Args({64, 64})->Args({64, 8})->Args({64, 1})->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
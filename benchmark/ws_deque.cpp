@@ -0,0 +1,79 @@
+#include "benchmark/benchmark.h"
+#include "benchmark/perf_counters.h"
+
+#include "include/ccollection.h"
+
+static void BM_WsDequePushPop(benchmark::State& state)
+{
+    ws_deque_t * deque = ws_deque_new(sizeof(int), 16);
+    int out;
+    perf_counters_t perf(state);
+    while(state.KeepRunning())
+    {
+        for (int i = 0; i < state.range(0); i++)
+        {
+            ws_deque_push(deque, &i);
+        }
+        for (int i = 0; i < state.range(0); i++)
+        {
+            ws_deque_pop(deque, &out);
+        }
+    }
+    perf.stop();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    ws_deque_destroy(deque);
+}
+BENCHMARK(BM_WsDequePushPop)->RangeMultiplier(8)->Range(8, 1 << 12);
+
+// thread 0 owns the deque and keeps it fed, every other thread steals from it
+static ws_deque_t * shared_deque = NULL;
+
+static void BM_WsDequeSteal(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        shared_deque = ws_deque_new(sizeof(int), 1 << 10);
+    }
+
+    int out;
+    int64_t stolen = 0;
+    int64_t popped = 0;
+    perf_counters_t perf(state);
+    for (auto _ : state)
+    {
+        if (state.thread_index() == 0)
+        {
+            for (int i = 0; i < 64; i++)
+            {
+                ws_deque_push(shared_deque, &i);
+            }
+            // take back whatever the thieves left, like a worker running its own tasks
+            while (ws_deque_get_size(shared_deque) > 32 && ws_deque_pop(shared_deque, &out) == ERROR_NONE)
+            {
+                popped++;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < 64; i++)
+            {
+                if (ws_deque_steal(shared_deque, &out) == ERROR_NONE)
+                {
+                    stolen++;
+                }
+            }
+        }
+    }
+    perf.stop();
+    state.counters["stolen"] = benchmark::Counter(stolen, benchmark::Counter::kIsRate);
+    state.counters["popped"] = benchmark::Counter(popped, benchmark::Counter::kIsRate);
+
+    if (state.thread_index() == 0)
+    {
+        ws_deque_destroy(shared_deque);
+        shared_deque = NULL;
+    }
+}
+BENCHMARK(BM_WsDequeSteal)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,162 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BITSET_H
+
+#define BITSET_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * growable packed bit vector, one bit per flag in 64 bit words. Counting and the bulk operations between
+ * bitsets work a word at a time, with AVX2 and POPCNT kernels picked at runtime when the CPU has them.
+ */
+typedef struct bitset_t bitset_t;
+
+/**
+ * returned by the search functions when there is no such bit
+ */
+#define BITSET_NPOS     ((size_t)-1)
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a pointer to a bitset of size bits, all clear. NULL if out of memory.
+ */
+bitset_t* bitset_new(const size_t size);
+/**
+ * free the bitset
+ */
+cerror_t bitset_destroy(bitset_t* bitset);
+
+
+//==============================================================================
+// Capacity
+//==============================================================================
+
+/**
+ * get number of bits
+ */
+size_t bitset_get_size(const bitset_t* bitset);
+/**
+ * change the number of bits, bits added at the end are clear
+ */
+cerror_t bitset_resize(bitset_t* bitset, const size_t size);
+/**
+ * reserve room for size bits
+ */
+cerror_t bitset_reserve(bitset_t* bitset, const size_t size);
+
+
+//==============================================================================
+// Bit access
+//==============================================================================
+
+/**
+ * set bit index. Returns ERROR_FAILED and sets errno to EOUTOFRANGE if index >= size, like every function
+ * taking an index.
+ */
+cerror_t bitset_set(bitset_t* bitset, const size_t index);
+/**
+ * clear bit index
+ */
+cerror_t bitset_reset(bitset_t* bitset, const size_t index);
+/**
+ * set bit index to value
+ */
+cerror_t bitset_assign(bitset_t* bitset, const size_t index, const bool value);
+/**
+ * invert bit index
+ */
+cerror_t bitset_flip(bitset_t* bitset, const size_t index);
+/**
+ * check if bit index is set, false if index >= size
+ */
+bool bitset_test(const bitset_t* bitset, const size_t index);
+/**
+ * append a bit, the bitset doubles when full
+ */
+cerror_t bitset_push_back(bitset_t* bitset, const bool value);
+/**
+ * set or clear every bit
+ */
+cerror_t bitset_fill(bitset_t* bitset, const bool value);
+/**
+ * get the words holding the bits, bit i is bit i % 64 of word i / 64. Bits past size in the last word are 0.
+ */
+const uint64_t* bitset_cdata(const bitset_t* bitset);
+
+
+//==============================================================================
+// Queries
+//==============================================================================
+
+/**
+ * get number of set bits
+ */
+size_t bitset_count(const bitset_t* bitset);
+/**
+ * get number of set bits before index, index may be size
+ */
+size_t bitset_rank(const bitset_t* bitset, const size_t index);
+/**
+ * get the position of the set bit with rank rank, counting from 0, or BITSET_NPOS if fewer bits are set
+ */
+size_t bitset_select(const bitset_t* bitset, const size_t rank);
+/**
+ * get the position of the first set bit at or after from, or BITSET_NPOS if there is none
+ */
+size_t bitset_find_next(const bitset_t* bitset, const size_t from);
+/**
+ * get the position of the first set bit, or BITSET_NPOS if there is none
+ */
+size_t bitset_find_first(const bitset_t* bitset);
+
+
+//==============================================================================
+// Bulk operations
+//==============================================================================
+
+/**
+ * combine other into bitset bit by bit, bitset keeps its size. other is treated as clear past its size.
+ */
+cerror_t bitset_and(bitset_t* bitset, const bitset_t* other);
+cerror_t bitset_or(bitset_t* bitset, const bitset_t* other);
+cerror_t bitset_xor(bitset_t* bitset, const bitset_t* other);
+/**
+ * clear every bit of bitset which is set in other
+ */
+cerror_t bitset_andnot(bitset_t* bitset, const bitset_t* other);
+
+EXTERN_C_END
+
+#endif /* end of include guard: BITSET_H */
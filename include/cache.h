@@ -0,0 +1,162 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CACHE_H
+
+#define CACHE_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * bounded key value cache. Keys and values are fixed size opaque byte strings copied into the cache, keys are
+ * compared bytewise. Every array is allocated once for the full capacity, entries are addressed by index and
+ * the replacement policy keeps its metadata in flat arrays next to them, so get, put and eviction are O(1)
+ * and never allocate.
+ *
+ * A cache must not be used by several threads at the same time.
+ */
+typedef struct cache_t cache_t;
+
+/**
+ * replacement policies
+ */
+typedef enum cache_policy_t
+{
+    CACHE_POLICY_LRU,           /** evict the least recently used entry */
+    CACHE_POLICY_CLOCK,         /** evict the first entry the clock hand finds unreferenced since its last pass */
+    CACHE_POLICY_S3FIFO         /** small probation FIFO, main FIFO with reinsertion and a ghost FIFO of evicted keys */
+} cache_policy_t;
+
+/**
+ * called with the key and value of every entry the policy evicts, before its slot is reused
+ */
+typedef void (*cache_evict_fn)(const item_t* key, item_t* value, void* context);
+
+/**
+ * cache configuration
+ */
+typedef struct cache_options_t
+{
+    cache_policy_t policy;      /** replacement policy */
+    size_t capacity;            /** maximum number of entries, 0 to derive it from max_bytes */
+    size_t max_bytes;           /** memory budget of the whole cache, used when capacity is 0 */
+    cache_evict_fn evict;       /** eviction callback, may be NULL */
+    void *context;              /** passed to evict */
+} cache_options_t;
+
+/**
+ * access counters, updated by cache_get, cache_find and cache_put
+ */
+typedef struct cache_counters_t
+{
+    size_t hits;                /** lookups which found their key */
+    size_t misses;              /** lookups which did not */
+    size_t insertions;          /** entries added by cache_put */
+    size_t evictions;           /** entries evicted by the policy */
+} cache_counters_t;
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a pointer to an empty cache_t. Returns NULL and sets errno if key_size or value_size <= 0, or if
+ * the options allow no entry.
+ */
+cache_t* cache_new(const size_t key_size, const size_t value_size, const cache_options_t* options);
+/**
+ * free the cache, the eviction callback is not called for remaining entries
+ */
+cerror_t cache_destroy(cache_t* cache);
+
+
+//==============================================================================
+// Capacity
+//==============================================================================
+
+/**
+ * get number of entries in the cache
+ */
+size_t cache_get_size(const cache_t* cache);
+/**
+ * get maximum number of entries
+ */
+size_t cache_get_capacity(const cache_t* cache);
+/**
+ * get number of bytes allocated by the cache
+ */
+size_t cache_get_memory(const cache_t* cache);
+/**
+ * copy the access counters into counters
+ */
+cerror_t cache_get_counters(const cache_t* cache, cache_counters_t* counters);
+/**
+ * reset the access counters to 0
+ */
+cerror_t cache_reset_counters(cache_t* cache);
+
+
+//==============================================================================
+// Lookup
+//==============================================================================
+
+/**
+ * copy the value of key into value and record the access.
+ * Returns ERROR_FAILED and sets errno to ENOENT if key is not cached.
+ */
+cerror_t cache_get(cache_t* cache, const item_t* key, item_t* value);
+/**
+ * get a pointer to the value of key and record the access, NULL if key is not cached. The pointer is valid
+ * until the next cache_put or cache_erase.
+ */
+item_t* cache_find(cache_t* cache, const item_t* key);
+
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+
+/**
+ * insert key or replace its value, evicting an entry if the cache is full
+ */
+cerror_t cache_put(cache_t* cache, const item_t* key, const item_t* value);
+/**
+ * remove key without calling the eviction callback.
+ * Returns ERROR_FAILED and sets errno to ENOENT if key is not cached.
+ */
+cerror_t cache_erase(cache_t* cache, const item_t* key);
+/**
+ * remove every entry without calling the eviction callback
+ */
+cerror_t cache_clear(cache_t* cache);
+
+EXTERN_C_END
+
+#endif /* end of include guard: CACHE_H */
@@ -52,6 +52,21 @@
 #define MAX(a,b)    ((a) > (b) ? (a) : (b))
 #define MIN(a,b)    ((a) < (b) ? (a) : (b))
 
+//==============================================================================
+// Compiler hints
+//==============================================================================
+#if defined(__GNUC__) || defined(__clang__)
+    #define ccollection_prefetch(addr)      __builtin_prefetch((const void*)(addr))
+    #define ccollection_prefetch_write(addr) __builtin_prefetch((const void*)(addr), 1)
+    #define ccollection_likely(expr)        __builtin_expect(!!(expr), 1)
+    #define ccollection_unlikely(expr)      __builtin_expect(!!(expr), 0)
+#else
+    #define ccollection_prefetch(addr)
+    #define ccollection_prefetch_write(addr)
+    #define ccollection_likely(expr)        (expr)
+    #define ccollection_unlikely(expr)      (expr)
+#endif
+
 //==============================================================================
 // Header files used in almost all files
 //==============================================================================
@@ -70,6 +85,11 @@ EXTERN_C_BEGIN
 #define EBADELEMSIZE        (EOFFSET + 1)           /** Invalid element size */
 #define EBADPOINTER         (EOFFSET + 2)           /** pointer points to NULL */
 #define EOUTOFRANGE         (EOFFSET + 3)           /** Index was out of range */
+#define EBADFORMAT          (EOFFSET + 4)           /** Data was not written by ccollection */
+#define EREADONLY           (EOFFSET + 5)           /** Container can not be modified */
+#define EEMPTY              (EOFFSET + 6)           /** Container has no element to remove */
+#define EBADHANDLE          (EOFFSET + 7)           /** Handle is stale or was never issued */
+#define EFULL               (EOFFSET + 8)           /** Fixed capacity container can not grow */
 
 #define ERROR_NONE          0                       /** No error */
 #define ERROR_FAILED        -1                      /** function did not execute successfully */
@@ -101,6 +121,7 @@ EXTERN_C_BEGIN
         free(ptr);
 
 #define ccollection_copy(dst, src, size)    memcpy((void*)(dst), (void*)(src), size)
+#define ccollection_move(dst, src, size)    memmove((void*)(dst), (void*)(src), size)
 
 //==============================================================================
 // Aliases / typedefs
@@ -36,6 +36,16 @@ const char* ccollection_strerror(int err);
 
 EXTERN_C_END
 
+#include "include/stats.h"
 #include "include/vector.h"
+#include "include/varvector.h"
+#include "include/bitset.h"
+#include "include/intvector.h"
+#include "include/concurrent_vector.h"
+#include "include/slot_map.h"
+#include "include/pool.h"
+#include "include/cache.h"
+#include "include/ws_deque.h"
+#include "include/ebr.h"
 
 #endif /* end of include guard: CCOLLECTION_H */
@@ -0,0 +1,115 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CONCURRENT_VECTOR_H
+
+#define CONCURRENT_VECTOR_H
+
+#include "include/ccollection-internal.h"
+#include "include/iterator.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * grow only vector which many threads can append to concurrently. Elements are stored in segments of
+ * geometrically increasing size which are never moved or freed before the vector is destroyed, so pointers
+ * to elements stay valid while other threads append. Appending reserves indices with a single atomic
+ * fetch-add, there is no lock and no appender waits for another.
+ *
+ * Every element is marked ready once its appender wrote it, readers never see an index that is reserved but
+ * not written yet: at and get fail with EOUTOFRANGE for it and iterators stop in front of it. An index whose
+ * segment could not be allocated is never marked ready.
+ */
+typedef struct concurrent_vector_t concurrent_vector_t;
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a pointer to an empty concurrent_vector_t. Returns NULL if elem_size <= 0 and sets errno.
+ */
+concurrent_vector_t* concurrent_vector_new(const size_t elem_size);
+/**
+ * free all segments, no other thread may use the vector any more
+ */
+cerror_t concurrent_vector_destroy(concurrent_vector_t* vector);
+
+
+//==============================================================================
+// Capacity
+//==============================================================================
+
+/**
+ * get number of indices reserved so far, some may still be being written by other threads
+ */
+size_t concurrent_vector_get_size(const concurrent_vector_t* vector);
+/**
+ * allocate segments for at least count elements up front so appends do not have to
+ */
+cerror_t concurrent_vector_reserve(concurrent_vector_t* vector, const size_t count);
+
+
+//==============================================================================
+// Modifiers, safe to call from any number of threads
+//==============================================================================
+
+/**
+ * append one element. If index is not NULL it receives the position of the element.
+ */
+cerror_t concurrent_vector_push_back(concurrent_vector_t* vector, const item_t* item, size_t* index);
+/**
+ * append n consecutive elements from items with a single reservation. If index is not NULL it receives the
+ * position of the first element.
+ */
+cerror_t concurrent_vector_push_back_n(concurrent_vector_t* vector, const item_t* items, const size_t n,
+        size_t* index);
+
+
+//==============================================================================
+// Elements access, safe to call while other threads append
+//==============================================================================
+
+/**
+ * copy the element at index into item
+ */
+cerror_t concurrent_vector_at(const concurrent_vector_t* vector, const size_t index, item_t* item);
+/**
+ * get a pointer to the element at index, it stays valid until the vector is destroyed.
+ * Returns NULL and sets errno to EOUTOFRANGE if the index is not reserved or not written yet.
+ */
+item_t* concurrent_vector_get(const concurrent_vector_t* vector, const size_t index);
+/**
+ * point iterator to the first element, the iterator walks segment by segment up to the size at the time
+ * it enters each segment and stops at the first element not written yet
+ */
+cerror_t concurrent_vector_cbegin(const concurrent_vector_t* vector, iterator_t* iterator);
+
+EXTERN_C_END
+
+#endif /* end of include guard: CONCURRENT_VECTOR_H */
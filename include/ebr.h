@@ -0,0 +1,117 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef EBR_H
+
+#define EBR_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * epoch based reclamation domain. Lock-free containers retire memory which concurrent readers may still be
+ * using instead of freeing it, the domain frees it once every thread has left the critical regions it was
+ * in at retirement time.
+ *
+ * Every thread touching the protected structure registers once, wraps each access in ebr_enter/ebr_exit and
+ * retires unlinked memory with ebr_retire. Retired memory is reclaimed in batches from the retiring thread.
+ */
+typedef struct ebr_t ebr_t;
+/**
+ * per thread state, must only be used by the thread which registered it
+ */
+typedef struct ebr_thread_t ebr_thread_t;
+
+/**
+ * frees memory passed to ebr_retire
+ */
+typedef void (*ebr_free_fn)(void* ptr);
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a new reclamation domain, NULL if out of memory
+ */
+ebr_t* ebr_new(void);
+/**
+ * free all memory still waiting for reclamation and the domain itself, no thread may use it any more
+ */
+cerror_t ebr_destroy(ebr_t* ebr);
+
+
+//==============================================================================
+// Threads
+//==============================================================================
+
+/**
+ * register the calling thread, records of unregistered threads are reused
+ */
+ebr_thread_t* ebr_register(ebr_t* ebr);
+/**
+ * unregister the calling thread, memory it retired is reclaimed by the next thread reusing the record
+ * or by ebr_destroy
+ */
+cerror_t ebr_unregister(ebr_thread_t* thread);
+
+
+//==============================================================================
+// Critical regions
+//==============================================================================
+
+/**
+ * enter a critical region, memory retired from now on is not freed before the matching ebr_exit.
+ * Regions may be nested.
+ */
+cerror_t ebr_enter(ebr_thread_t* thread);
+/**
+ * leave a critical region, pointers read inside it must not be used any more
+ */
+cerror_t ebr_exit(ebr_thread_t* thread);
+
+
+//==============================================================================
+// Reclamation
+//==============================================================================
+
+/**
+ * hand ptr over to the domain, free_fn(ptr) is called once no thread can still be reading it.
+ * free_fn NULL frees ptr like ccollection_free. Every few retirements reclamation runs on the calling thread.
+ */
+cerror_t ebr_retire(ebr_thread_t* thread, void* ptr, ebr_free_fn free_fn);
+/**
+ * try to advance the global epoch and free memory this thread retired which became safe to free.
+ * Returns the number of pointers freed.
+ */
+size_t ebr_collect(ebr_thread_t* thread);
+
+EXTERN_C_END
+
+#endif /* end of include guard: EBR_H */
@@ -0,0 +1,117 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef INTVECTOR_H
+
+#define INTVECTOR_H
+
+#include "include/ccollection-internal.h"
+#include "include/vector.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * append only vector of unsigned 64 bit integers stored compressed. Values are encoded in blocks of
+ * INTVECTOR_BLOCK_SIZE, each block stores its values either as offsets from the block minimum (frame of
+ * reference) or as differences to the previous value (delta, for sorted runs), bit packed with the width of
+ * the largest one. A header per block keeps random access cheap, the values appended since the last full
+ * block are kept uncompressed.
+ *
+ * Sorted ids with small gaps take one or two bytes per value instead of eight.
+ */
+typedef struct intvector_t intvector_t;
+
+/**
+ * number of values per compressed block
+ */
+#define INTVECTOR_BLOCK_SIZE    128
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a pointer to an empty intvector_t, NULL if out of memory
+ */
+intvector_t* intvector_new(void);
+/**
+ * returns an intvector_t holding the elements of vector, which must be unsigned integers of 1, 2, 4 or 8
+ * bytes. Returns NULL and sets errno to EBADELEMSIZE for other element sizes.
+ */
+intvector_t* intvector_from_vector(const vector_t* vector);
+/**
+ * free the intvector
+ */
+cerror_t intvector_destroy(intvector_t* vector);
+
+
+//==============================================================================
+// Capacity
+//==============================================================================
+
+/**
+ * get number of values
+ */
+size_t intvector_get_size(const intvector_t* vector);
+/**
+ * get number of bytes the values take, block headers and the uncompressed tail included
+ */
+size_t intvector_get_memory(const intvector_t* vector);
+
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+
+/**
+ * append value, a block is encoded every INTVECTOR_BLOCK_SIZE values
+ */
+cerror_t intvector_push_back(intvector_t* vector, const uint64_t value);
+/**
+ * append n values
+ */
+cerror_t intvector_push_back_n(intvector_t* vector, const uint64_t* values, const size_t n);
+
+
+//==============================================================================
+// Element access
+//==============================================================================
+
+/**
+ * copy value index into value. O(1) for frame of reference blocks, delta blocks sum up to one block of
+ * differences. Returns ERROR_FAILED and sets errno to EOUTOFRANGE if index >= size.
+ */
+cerror_t intvector_at(const intvector_t* vector, const size_t index, uint64_t* value);
+/**
+ * decode count values starting at start into values, a whole block at a time
+ */
+cerror_t intvector_decode(const intvector_t* vector, const size_t start, const size_t count, uint64_t* values);
+
+EXTERN_C_END
+
+#endif /* end of include guard: INTVECTOR_H */
@@ -0,0 +1,119 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ITERATOR_H
+
+#define ITERATOR_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+typedef struct iterator_t iterator_t;
+
+/**
+ * called by iterator_next when current reaches end, moves the iterator to the next non empty run of elements and
+ * returns true, or returns false when the container is exhausted. Contiguous containers leave it NULL.
+ */
+typedef bool (*iterator_refill_t)(iterator_t* iterator);
+
+/**
+ * cursor over the elements of a container. It lives on the stack, is initialized by the begin function of
+ * a container (e.g. vector_begin) and walks a run of elements placed stride bytes apart, asking the container
+ * for the next run through refill. Every step is inline and hands out pointers, elements are never copied.
+ *
+ *     iterator_t it;
+ *     for (vector_cbegin(vector, &it); iterator_valid(&it); iterator_next(&it))
+ *     {
+ *         const int *value = iterator_get(&it);
+ *     }
+ *
+ * Modifying the container invalidates its iterators.
+ */
+struct iterator_t
+{
+    uint8_t *current;           /** element the iterator points to */
+    uint8_t *end;               /** one past the last element of the current run */
+    size_t stride;              /** distance between two elements */
+    size_t prefetch;            /** bytes ahead of current prefetched by iterator_next, 0 disables prefetching */
+    iterator_refill_t refill;   /** fetches the next run, NULL if there is none */
+    const void *container;      /** container being iterated, for use by refill */
+    size_t position;            /** container defined position of the current run, for use by refill */
+};
+
+//==============================================================================
+// Iteration
+//==============================================================================
+
+/**
+ * check if the iterator points to an element
+ */
+static inline bool iterator_valid(const iterator_t* iterator)
+{
+    return iterator->current < iterator->end;
+}
+
+/**
+ * get a pointer to the element the iterator points to, iterator must be valid
+ */
+static inline item_t* iterator_get(const iterator_t* iterator)
+{
+    return iterator->current;
+}
+
+/**
+ * advance to the next element, returns false once the iterator moved past the last element
+ */
+static inline bool iterator_next(iterator_t* iterator)
+{
+    iterator->current += iterator->stride;
+
+    if (iterator->prefetch != 0 && (size_t)(iterator->end - iterator->current) > iterator->prefetch)
+    {
+        ccollection_prefetch(iterator->current + iterator->prefetch);
+    }
+    if (ccollection_likely(iterator->current < iterator->end))
+    {
+        return true;
+    }
+
+    return iterator->refill != NULL && iterator->refill(iterator);
+}
+
+/**
+ * prefetch the element distance positions ahead of the iterator on every step, 0 disables prefetching.
+ * Only pays off for large elements or containers whose runs the hardware prefetcher can not follow.
+ */
+static inline void iterator_set_prefetch(iterator_t* iterator, const size_t distance)
+{
+    iterator->prefetch = distance * iterator->stride;
+}
+
+EXTERN_C_END
+
+#endif /* end of include guard: ITERATOR_H */
@@ -0,0 +1,116 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef POOL_H
+
+#define POOL_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * fixed size object pool. Slots of element_size bytes are carved from slabs allocated in bulk, released
+ * slots are threaded on an intrusive free list and handed out again first, so acquire and release are O(1)
+ * and live objects stay packed in a few slabs. Slabs are only freed with the pool.
+ *
+ * The pool is thread safe behind a mutex. Threads acquiring and releasing at high rates should go through a
+ * pool_cache_t, which only takes the lock to move whole batches of slots.
+ */
+typedef struct pool_t pool_t;
+/**
+ * per thread cache of free slots in front of a pool, must only be used by one thread at a time
+ */
+typedef struct pool_cache_t pool_cache_t;
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a pointer to an empty pool_t handing out elem_size byte slots aligned for any object of that size,
+ * up to the alignment of malloc. Returns NULL if elem_size <= 0 and sets errno.
+ */
+pool_t* pool_new(const size_t elem_size);
+/**
+ * free the pool and every slab, including slots which were not released. Caches of the pool must be
+ * destroyed first.
+ */
+cerror_t pool_destroy(pool_t* pool);
+/**
+ * returns a cache taking batch slots from pool at a time, batch 0 picks a default
+ */
+pool_cache_t* pool_cache_new(pool_t* pool, const size_t batch);
+/**
+ * return the free slots of the cache to its pool and free the cache
+ */
+cerror_t pool_cache_destroy(pool_cache_t* cache);
+
+
+//==============================================================================
+// Capacity
+//==============================================================================
+
+/**
+ * get number of slots taken from the pool, slots held by caches count as taken
+ */
+size_t pool_get_size(pool_t* pool);
+/**
+ * get number of slots the slabs allocated so far hold
+ */
+size_t pool_get_capacity(pool_t* pool);
+/**
+ * allocate slabs until they hold at least count slots
+ */
+cerror_t pool_reserve(pool_t* pool, const size_t count);
+
+
+//==============================================================================
+// Allocation
+//==============================================================================
+
+/**
+ * get an uninitialized slot, NULL if out of memory
+ */
+item_t* pool_acquire(pool_t* pool);
+/**
+ * give a slot back to the pool, it must have been acquired from the same pool or one of its caches
+ */
+cerror_t pool_release(pool_t* pool, item_t* item);
+/**
+ * get an uninitialized slot from the cache, refilling it from the pool when empty. NULL if out of memory.
+ */
+item_t* pool_cache_acquire(pool_cache_t* cache);
+/**
+ * give a slot back to the cache, half of the cache goes back to the pool when it holds two batches
+ */
+cerror_t pool_cache_release(pool_cache_t* cache, item_t* item);
+
+EXTERN_C_END
+
+#endif /* end of include guard: POOL_H */
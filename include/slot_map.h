@@ -0,0 +1,153 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SLOT_MAP_H
+
+#define SLOT_MAP_H
+
+#include "include/ccollection-internal.h"
+#include "include/iterator.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * unordered container handing out stable handles to its elements. Elements are kept packed in a dense array
+ * so iterating them is a linear scan, handles reach them through an indirection table. Erasing moves the last
+ * element into the hole in O(1), which changes the order and the position of elements but not their handles.
+ *
+ * A handle carries the generation of its slot. Erasing an element bumps the generation, so handles to erased
+ * elements are detected as stale even after the slot was reused.
+ */
+typedef struct slot_map_t slot_map_t;
+
+/**
+ * handle to an element of a slot map, slot index in the low 32 bits and generation in the high 32 bits
+ */
+typedef uint64_t slot_handle_t;
+
+/**
+ * handle which never refers to an element
+ */
+#define SLOT_HANDLE_NULL    ((slot_handle_t)0)
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a pointer to an empty slot_map_t. Returns NULL if elem_size <= 0 and sets errno.
+ */
+slot_map_t* slot_map_new(const size_t elem_size);
+/**
+ * free the slot map, every handle becomes invalid
+ */
+cerror_t slot_map_destroy(slot_map_t* map);
+
+
+//==============================================================================
+// Capacity
+//==============================================================================
+
+/**
+ * reserve room for count elements
+ */
+cerror_t slot_map_reserve(slot_map_t* map, const size_t count);
+/**
+ * get number of elements in the slot map
+ */
+size_t slot_map_get_size(const slot_map_t* map);
+
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+
+/**
+ * copy item into the slot map and return its handle in handle
+ */
+cerror_t slot_map_insert(slot_map_t* map, const item_t* item, slot_handle_t* handle);
+/**
+ * erase the element of handle, the last element takes its position.
+ * Returns ERROR_FAILED and sets errno to EBADHANDLE if handle is stale.
+ */
+cerror_t slot_map_erase(slot_map_t* map, const slot_handle_t handle);
+/**
+ * erase every element, all handles become stale
+ */
+cerror_t slot_map_clear(slot_map_t* map);
+
+
+//==============================================================================
+// Element access
+//==============================================================================
+
+/**
+ * check if handle refers to an element of the slot map
+ */
+bool slot_map_contains(const slot_map_t* map, const slot_handle_t handle);
+/**
+ * copy the element of handle into item.
+ * Returns ERROR_FAILED and sets errno to EBADHANDLE if handle is stale.
+ */
+cerror_t slot_map_at(const slot_map_t* map, const slot_handle_t handle, item_t* item);
+/**
+ * get a pointer to the element of handle, or NULL if handle is stale. The pointer is valid until the slot
+ * map is modified.
+ */
+item_t* slot_map_get(const slot_map_t* map, const slot_handle_t handle);
+/**
+ * get the handle of the element at position in the dense array.
+ * Returns SLOT_HANDLE_NULL and sets errno to EOUTOFRANGE if position >= size.
+ */
+slot_handle_t slot_map_handle_at(const slot_map_t* map, const size_t position);
+/**
+ * get the handle of the element element points to, e.g. the element of an iterator.
+ * Returns SLOT_HANDLE_NULL and sets errno to EOUTOFRANGE if element is not in the dense array.
+ */
+slot_handle_t slot_map_handle_of(const slot_map_t* map, const item_t* element);
+/**
+ * get the dense array of elements, in no particular order
+ */
+item_t* slot_map_data(slot_map_t* map);
+const item_t* slot_map_cdata(const slot_map_t* map);
+
+
+//==============================================================================
+// Iterators
+//==============================================================================
+
+/**
+ * initialize iterator to walk the dense array, slot_map_handle_of(map, iterator_get(iterator)) gives the
+ * handle of the current element
+ */
+cerror_t slot_map_begin(slot_map_t* map, iterator_t* iterator);
+cerror_t slot_map_cbegin(const slot_map_t* map, iterator_t* iterator);
+
+EXTERN_C_END
+
+#endif /* end of include guard: SLOT_MAP_H */
@@ -0,0 +1,76 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef STATS_H
+
+#define STATS_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// Container statistics
+//
+// Only collected when the library is built with CCOLLECTION_STATS defined
+// (cmake -DCCOLLECTION_ENABLE_STATS=ON). Otherwise nothing is counted, the
+// containers carry no extra state and every function below fails with ENOTSUP.
+//==============================================================================
+
+/**
+ * counters kept per container and summed over all containers
+ */
+typedef struct ccollection_stats_t
+{
+    uint64_t allocations;       /** items buffers allocated for an empty container */
+    uint64_t reallocations;     /** items buffers grown or shrunk */
+    uint64_t shrinks;           /** reallocations which reduced capacity */
+    uint64_t bytes_moved;       /** bytes copied to shift elements on insert and erase */
+    size_t peak_size;           /** largest number of elements, the largest of any container for global stats */
+    size_t peak_capacity;       /** largest capacity, the largest of any container for global stats */
+} ccollection_stats_t;
+
+/**
+ * called by ccollection_stats_foreach for every live container, type is a static string such as "vector"
+ */
+typedef void (*ccollection_stats_fn)(const char* type, const void* container, const ccollection_stats_t* stats,
+        void* context);
+
+/**
+ * copy the counters summed over every container created since the program started
+ */
+cerror_t ccollection_stats_global(ccollection_stats_t* stats);
+/**
+ * call fn for every live container. Counters of containers modified concurrently by other threads may be
+ * torn, the registry itself is safe to walk while containers are created and destroyed.
+ */
+cerror_t ccollection_stats_foreach(ccollection_stats_fn fn, void* context);
+/**
+ * print global counters followed by one line per live container
+ */
+cerror_t ccollection_stats_dump(FILE* file);
+
+EXTERN_C_END
+
+#endif /* end of include guard: STATS_H */
@@ -0,0 +1,146 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VARVECTOR_H
+
+#define VARVECTOR_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * vector of variable length byte strings. Payloads are packed back to back in one byte arena and a parallel
+ * array of spans locates each of them, like a string column of a columnar format. Scanning every element
+ * streams the two arrays instead of following a pointer per element.
+ *
+ * Erasing or replacing an element leaves its old bytes in the arena as garbage, varvector_compact rewrites
+ * the arena without it. Compaction also runs on its own once garbage takes more than half of the arena.
+ */
+typedef struct varvector_t varvector_t;
+
+/**
+ * location of one element in the arena
+ */
+typedef struct varvector_span_t
+{
+    uint64_t offset;            /** first byte of the element in the arena */
+    uint64_t length;            /** number of bytes */
+} varvector_span_t;
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a pointer to an empty varvector_t, NULL if out of memory
+ */
+varvector_t* varvector_new(void);
+/**
+ * free the spans, the arena and the vector
+ */
+cerror_t varvector_destroy(varvector_t* vector);
+
+
+//==============================================================================
+// Capacity
+//==============================================================================
+
+/**
+ * reserve room for count elements holding bytes bytes in total
+ */
+cerror_t varvector_reserve(varvector_t* vector, const size_t count, const size_t bytes);
+/**
+ * get number of elements
+ */
+size_t varvector_get_size(const varvector_t* vector);
+/**
+ * get number of payload bytes of all elements
+ */
+size_t varvector_get_bytes(const varvector_t* vector);
+/**
+ * get number of bytes used in the arena, payload and garbage
+ */
+size_t varvector_get_arena_size(const varvector_t* vector);
+
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+
+/**
+ * append a copy of length bytes at data, length may be 0
+ */
+cerror_t varvector_push_back(varvector_t* vector, const void* data, const size_t length);
+/**
+ * append n elements whose payloads are packed back to back at data, element i is lengths[i] bytes long
+ */
+cerror_t varvector_push_back_n(varvector_t* vector, const void* data, const size_t* lengths, const size_t n);
+/**
+ * replace element index with a copy of length bytes at data, in place if the new payload is not longer
+ */
+cerror_t varvector_set(varvector_t* vector, const size_t index, const void* data, const size_t length);
+/**
+ * erase element index, the following elements move one position down
+ */
+cerror_t varvector_erase(varvector_t* vector, const size_t index);
+/**
+ * erase the last element
+ */
+cerror_t varvector_pop_back(varvector_t* vector);
+/**
+ * erase every element
+ */
+cerror_t varvector_clear(varvector_t* vector);
+/**
+ * rewrite the arena with the payloads in element order and without garbage
+ */
+cerror_t varvector_compact(varvector_t* vector);
+
+
+//==============================================================================
+// Element access
+//==============================================================================
+
+/**
+ * get a pointer to the payload of element index and its length in length. The pointer is valid until the
+ * vector is modified. Returns NULL and sets errno to EOUTOFRANGE if index >= size.
+ */
+const void* varvector_get(const varvector_t* vector, const size_t index, size_t* length);
+/**
+ * get the span array, one span per element
+ */
+const varvector_span_t* varvector_spans(const varvector_t* vector);
+/**
+ * get the arena the spans point into
+ */
+const uint8_t* varvector_arena(const varvector_t* vector);
+
+EXTERN_C_END
+
+#endif /* end of include guard: VARVECTOR_H */
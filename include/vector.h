@@ -27,6 +27,9 @@
 #define VECTOR_H
 
 #include "include/ccollection-internal.h"
+#include "include/iterator.h"
+#include "include/stats.h"
+#include "include/ebr.h"
 
 EXTERN_C_BEGIN
 
@@ -35,6 +38,74 @@ EXTERN_C_BEGIN
 //==============================================================================
 
 typedef struct vector_t vector_t;
+typedef struct vector_snapshot_t vector_snapshot_t;
+typedef struct vector_topk_t vector_topk_t;
+
+/**
+ * bytes needed to hold a vector_t, statistics make every container larger
+ */
+#ifdef CCOLLECTION_STATS
+    #define VECTOR_HEADER_SIZE  160
+#else
+    #define VECTOR_HEADER_SIZE  64
+#endif
+
+/**
+ * caller owned storage for a vector_t, e.g. a member of another struct or a local variable. It is opaque,
+ * vector_init turns it into a vector. The library and its users must agree on CCOLLECTION_STATS.
+ */
+typedef union vector_header_t
+{
+    uint8_t bytes[VECTOR_HEADER_SIZE];
+    void *align_pointer;
+    uint64_t align_integer;
+} vector_header_t;
+
+/**
+ * where the items buffer of a vector lives, decides how it is grown and released
+ */
+typedef enum vector_storage_t
+{
+    VECTOR_STORAGE_HEAP = 0,    /** items are allocated with ccollection_realloc */
+    VECTOR_STORAGE_MAPPED,      /** items live in a shared file mapping, see vector_mmap.c */
+    VECTOR_STORAGE_VIEW,        /** items belong to the caller and are read only, see vector_serialize.c */
+    VECTOR_STORAGE_PAGED,       /** items live in an anonymous mapping, see vector_paged.c */
+    VECTOR_STORAGE_ALIGNED,     /** items are allocated with posix_memalign, see vector_aligned.c */
+    VECTOR_STORAGE_SHARED,      /** items are shared copy on write with clones, see vector_cow.c */
+    VECTOR_STORAGE_FIXED,       /** items belong to the caller and never move, see vector_wrap */
+} vector_storage_t;
+
+/**
+ * leading fields of every vector_t, so that inline code such as include/vector.hpp reaches the elements without
+ * a call. They are read only outside the library, modify the vector through the functions below.
+ */
+typedef struct vector_layout_t
+{
+    uint8_t *items;             /** stores all elements of the container */
+    size_t element_size;        /** size of one element */
+    size_t stride;              /** distance between two elements, element_size unless padded */
+    size_t alignment;           /** alignment of items, 0 for the default malloc alignment */
+    size_t size;                /** total number of elements in container */
+    size_t capacity;            /** capacity of the container */
+    vector_storage_t storage;   /** backend owning the items buffer */
+} vector_layout_t;
+
+/**
+ * the leading fields of vector
+ */
+static inline const vector_layout_t* vector_layout(const vector_t* vector)
+{
+    return (const vector_layout_t*)vector;
+}
+
+/**
+ * true if the items of a vector can be written in place. Otherwise vector_data has to run first, it gives a
+ * clone its own buffer or fails for read only views.
+ */
+static inline bool vector_layout_writable(const vector_layout_t* layout)
+{
+    return layout->storage != VECTOR_STORAGE_SHARED && layout->storage != VECTOR_STORAGE_VIEW;
+}
 
 //==============================================================================
 // ctors and dtors
@@ -49,6 +120,149 @@ vector_t* vector_new(const size_t elem_size);
  * destroy all elements and cleanup all elements
  */
 cerror_t vector_destroy(vector_t* vector);
+/**
+ * returns a pointer to vector_t whose items start at a multiple of alignment, which must be a power of 2.
+ * Alignment is kept across growth. Returns NULL and sets errno to EINVAL if alignment is not a power of 2.
+ */
+vector_t* vector_new_aligned(const size_t elem_size, const size_t alignment);
+/**
+ * same as vector_new_aligned, but the distance between two elements is also rounded up to a multiple of
+ * alignment so every element is aligned and none straddles an alignment boundary.
+ */
+vector_t* vector_new_aligned_padded(const size_t elem_size, const size_t alignment);
+
+
+//==============================================================================
+// Caller owned storage
+//==============================================================================
+
+/**
+ * initialize a vector in header instead of allocating one and return it, the items are allocated as with
+ * vector_new. Returns NULL and sets errno if elem_size <= 0.
+ */
+vector_t* vector_init(vector_header_t* header, const size_t elem_size);
+/**
+ * initialize a vector in header whose items are the capacity elements at buffer. It never reallocates,
+ * growing past capacity fails with EFULL. The buffer stays owned by the caller.
+ */
+vector_t* vector_init_wrap(vector_header_t* header, void* buffer, const size_t capacity, const size_t elem_size);
+/**
+ * same as vector_init_wrap with a heap allocated header, free it with vector_destroy
+ */
+vector_t* vector_wrap(void* buffer, const size_t capacity, const size_t elem_size);
+/**
+ * release the items of a vector but not the vector itself, for vectors made by vector_init and
+ * vector_init_wrap. vector_destroy does the same for them.
+ */
+cerror_t vector_deinit(vector_t* vector);
+
+
+//==============================================================================
+// Page backed vectors
+//==============================================================================
+
+/**
+ * kind of pages backing a page backed vector
+ */
+typedef enum vector_pages_t
+{
+    VECTOR_PAGES_DEFAULT = 0,   /** normal pages */
+    VECTOR_PAGES_TRANSPARENT,   /** normal pages advised with MADV_HUGEPAGE so the kernel backs them with THP */
+    VECTOR_PAGES_HUGETLB,       /** explicit 2M pages from the hugetlb pool, transparent pages if the pool is empty */
+} vector_pages_t;
+
+/**
+ * NUMA placement of a page backed vector, applied with mbind
+ */
+typedef enum vector_numa_t
+{
+    VECTOR_NUMA_DEFAULT = 0,    /** first touch placement */
+    VECTOR_NUMA_BIND,           /** allocate only from numa_nodes */
+    VECTOR_NUMA_INTERLEAVE,     /** interleave pages round robin across numa_nodes */
+} vector_numa_t;
+
+/**
+ * creation options of a page backed vector
+ */
+typedef struct vector_page_options_t
+{
+    vector_pages_t pages;       /** kind of pages to request */
+    vector_numa_t numa;         /** NUMA policy of the pages */
+    unsigned long numa_nodes;   /** bit mask of NUMA nodes used by VECTOR_NUMA_BIND and VECTOR_NUMA_INTERLEAVE */
+} vector_page_options_t;
+
+/**
+ * returns a pointer to vector_t whose items are an anonymous mapping grown with mremap instead of realloc.
+ * Meant for very large vectors. The mapping is rounded up to whole pages while the capacity stays the requested
+ * element count, growing within the last page does not remap it. Huge pages and NUMA policies are best effort:
+ * if the kernel refuses them the vector falls back to normal pages and default placement, vector_get_pages tells
+ * which pages it got.
+ * Returns NULL and sets errno on failure.
+ */
+vector_t* vector_new_paged(const size_t elem_size, const vector_page_options_t* options);
+/**
+ * kind of pages a vector is using. A page backed vector created with VECTOR_PAGES_HUGETLB reports
+ * VECTOR_PAGES_TRANSPARENT once the hugetlb pool ran dry, other vectors report VECTOR_PAGES_DEFAULT.
+ */
+vector_pages_t vector_get_pages(const vector_t* vector);
+
+
+//==============================================================================
+// File backed vectors
+//==============================================================================
+
+/**
+ * returns a pointer to vector_t whose elements live in a shared mapping of the file at path. The file is
+ * created or truncated. Growth extends the file and remaps it, vector_destroy unmaps and closes it.
+ * Returns NULL and sets errno on failure.
+ */
+vector_t* vector_new_mapped(const char* path, const size_t elem_size);
+/**
+ * map an existing file written by a file backed vector, the returned vector is populated with the elements
+ * present at the last vector_flush or vector_destroy. Element size is read from the file. Returns NULL and
+ * sets errno to EBADFORMAT if the file was not written by vector_new_mapped.
+ */
+vector_t* vector_open_mapped(const char* path);
+/**
+ * write size of the vector to the file header and synchronously flush dirty pages to the file.
+ * Nothing happens for vectors which are not file backed.
+ */
+cerror_t vector_flush(vector_t* vector);
+
+
+//==============================================================================
+// Serialization
+//==============================================================================
+
+/**
+ * number of bytes vector_serialize writes for the vector: a versioned header (magic, element size, count,
+ * checksum) followed by all elements as one contiguous payload in host byte order
+ */
+size_t vector_serialized_size(const vector_t* vector);
+/**
+ * write the vector into buffer, buffer_size must be at least vector_serialized_size bytes.
+ * Returns ERROR_FAILED and sets errno to ENOBUFS if it is not.
+ */
+cerror_t vector_serialize(const vector_t* vector, void* buffer, const size_t buffer_size);
+/**
+ * write the vector to a file descriptor at its current offset
+ */
+cerror_t vector_serialize_fd(const vector_t* vector, const int fd);
+/**
+ * returns a new vector holding a copy of the elements serialized in buffer. Returns NULL and sets errno to
+ * EBADFORMAT if the header is invalid, the buffer is truncated or the checksum does not match.
+ */
+vector_t* vector_deserialize(const void* buffer, const size_t buffer_size);
+/**
+ * read a serialized vector from a file descriptor at its current offset
+ */
+vector_t* vector_deserialize_fd(const int fd);
+/**
+ * returns a read only vector whose elements are the payload of buffer, nothing is copied and the checksum is
+ * not verified so pages of a mapped buffer are only touched when read. buffer must outlive the vector and
+ * be aligned for the element type. Modifiers fail with EREADONLY.
+ */
+vector_t* vector_view(const void* buffer, const size_t buffer_size);
 
 
 //==============================================================================
@@ -74,6 +288,10 @@ size_t vector_get_capacity(const vector_t* vector);
  * check if vector is empty
  */
 bool vector_is_empty(const vector_t* vector);
+/**
+ * copy the statistics collected for this vector, fails with ENOTSUP unless built with CCOLLECTION_STATS
+ */
+cerror_t vector_get_stats(const vector_t* vector, ccollection_stats_t* stats);
 
 
 //==============================================================================
@@ -125,6 +343,224 @@ cerror_t vector_clear(vector_t* vector);
  * call ccollection_strerror to get the error string;
  */
 cerror_t vector_at(const vector_t* vector, const pos_t index, item_t* item);
+/**
+ * get a pointer to the first element, element i starts at i * vector_get_stride() bytes from it.
+ * The pointer is invalidated by any modifier that grows or shrinks the vector.
+ * Returns NULL and sets errno to EREADONLY for read only vectors, use vector_cdata for those.
+ */
+item_t* vector_data(vector_t* vector);
+/**
+ * get a read only pointer to the first element
+ */
+const item_t* vector_cdata(const vector_t* vector);
+/**
+ * get distance in bytes between two consecutive elements, larger than the element size for padded vectors
+ */
+size_t vector_get_stride(const vector_t* vector);
+
+
+//==============================================================================
+// Copy on write
+//==============================================================================
+
+/**
+ * returns a new vector with the same elements in O(1). Both vectors share one items buffer through an atomic
+ * reference count and the first one to be modified copies it. File and page backed vectors can not share
+ * their mapping and are copied into a heap vector.
+ * Cloning a vector which other threads are cloning at the same time is only safe once it is shared, e.g.
+ * after it has been cloned once or published with vector_snapshot_publish.
+ */
+vector_t* vector_clone(vector_t* vector);
+/**
+ * returns a snapshot holder publishing vector to readers, the holder owns vector from now on
+ */
+vector_snapshot_t* vector_snapshot_new(vector_t* vector);
+/**
+ * destroy the holder and the vector it publishes, no thread may read it any more
+ */
+cerror_t vector_snapshot_destroy(vector_snapshot_t* snapshot);
+/**
+ * atomically replace the published vector, readers either see the old or the new vector in full. The holder
+ * owns vector from now on, it must not be modified any more. The previous vector is retired through the
+ * epoch domain of thread and destroyed once no reader can see it.
+ */
+cerror_t vector_snapshot_publish(vector_snapshot_t* snapshot, vector_t* vector, ebr_thread_t* thread);
+/**
+ * enter a read region and get the published vector, it stays valid until vector_snapshot_read_end
+ */
+const vector_t* vector_snapshot_read_begin(vector_snapshot_t* snapshot, ebr_thread_t* thread);
+/**
+ * leave the read region entered by vector_snapshot_read_begin
+ */
+cerror_t vector_snapshot_read_end(vector_snapshot_t* snapshot, ebr_thread_t* thread);
+/**
+ * get an O(1) clone of the published vector which the caller owns and must destroy. It stays consistent
+ * whatever is published later and copies the elements only if the caller modifies it.
+ */
+vector_t* vector_snapshot_acquire(vector_snapshot_t* snapshot, ebr_thread_t* thread);
+
+
+//==============================================================================
+// Batched random access
+//==============================================================================
+
+/**
+ * elements ahead of the current one prefetched by vector_gather and vector_scatter
+ */
+#define VECTOR_PREFETCH_DISTANCE    16
+
+/**
+ * copy the elements at indices[0..n) to out, packed element_size bytes apart. All indices are checked before
+ * any element is copied, fails with EOUTOFRANGE if one is out of range.
+ */
+cerror_t vector_gather(const vector_t* vector, const pos_t* indices, const size_t n, item_t* out);
+/**
+ * copy the n packed elements at in to the positions indices[0..n) of vector, in order so the last of
+ * duplicate indices wins. All indices are checked before any element is written.
+ */
+cerror_t vector_scatter(vector_t* vector, const pos_t* indices, const size_t n, const item_t* in);
+/**
+ * vector_gather prefetching the element distance indices ahead, 0 disables prefetching
+ */
+cerror_t vector_gather_prefetch(const vector_t* vector, const pos_t* indices, const size_t n, item_t* out,
+        const size_t distance);
+/**
+ * vector_scatter prefetching the element distance indices ahead, 0 disables prefetching
+ */
+cerror_t vector_scatter_prefetch(vector_t* vector, const pos_t* indices, const size_t n, const item_t* in,
+        const size_t distance);
+
+
+//==============================================================================
+// Sorted sets
+//==============================================================================
+
+/**
+ * three way comparison of two elements, negative, 0 or positive as first is smaller, equal or larger
+ */
+typedef int (*vector_compare_t)(const item_t* first, const item_t* second);
+
+/**
+ * remove adjacent equal elements in place keeping the first of each run, a sorted vector becomes a set.
+ * A NULL compare orders the elements as unsigned integers of element_size 1, 2, 4 or 8 bytes, the same holds
+ * for the set operations below.
+ */
+cerror_t vector_unique(vector_t* vector, vector_compare_t compare);
+/**
+ * replace the elements of out with all elements of the sorted vectors first and second in sorted order,
+ * duplicates are kept. out must be a different vector with the same element size.
+ */
+cerror_t vector_merge(const vector_t* first, const vector_t* second, vector_t* out, vector_compare_t compare);
+/**
+ * replace the elements of out with the elements found in first or second. first and second must be sorted
+ * by compare, out is sorted without duplicates whether or not the inputs have any.
+ */
+cerror_t vector_union(const vector_t* first, const vector_t* second, vector_t* out, vector_compare_t compare);
+/**
+ * replace the elements of out with the elements found in both first and second, sorted without duplicates
+ */
+cerror_t vector_intersection(const vector_t* first, const vector_t* second, vector_t* out,
+        vector_compare_t compare);
+/**
+ * replace the elements of out with the elements of first not found in second, sorted without duplicates
+ */
+cerror_t vector_difference(const vector_t* first, const vector_t* second, vector_t* out,
+        vector_compare_t compare);
+
+
+//==============================================================================
+// Selection
+//==============================================================================
+
+/**
+ * reorder the elements so that the one at nth is the one a full sort by compare would put there, with no
+ * larger element before it and no smaller one after it. Linear on average and O(n log n) at worst.
+ */
+cerror_t vector_nth_element(vector_t* vector, const pos_t nth, vector_compare_t compare);
+/**
+ * move the count smallest elements to the front in sorted order, the order of the others is unspecified.
+ * O(n + count log count), a count of at least the size sorts the whole vector.
+ */
+cerror_t vector_partial_sort(vector_t* vector, const size_t count, vector_compare_t compare);
+
+/**
+ * returns an accumulator of the k largest elements pushed to it. It keeps at most 2k candidates and drops
+ * elements not larger than the smallest of the best k it has seen, so pushing n elements costs O(n).
+ */
+vector_topk_t* vector_topk_new(const size_t elem_size, const size_t k, vector_compare_t compare);
+/**
+ * destroy the accumulator
+ */
+cerror_t vector_topk_destroy(vector_topk_t* topk);
+/**
+ * offer the n elements packed at items
+ */
+cerror_t vector_topk_push_n(vector_topk_t* topk, const item_t* items, const size_t n);
+/**
+ * offer every element of vector, which must have the element size of the accumulator
+ */
+cerror_t vector_topk_push_vector(vector_topk_t* topk, const vector_t* vector);
+/**
+ * replace the elements of out with the best k elements pushed so far, largest first
+ */
+cerror_t vector_topk_get(vector_topk_t* topk, vector_t* out);
+/**
+ * number of elements vector_topk_get returns, k once k elements were pushed
+ */
+size_t vector_topk_get_size(const vector_topk_t* topk);
+/**
+ * forget every element pushed so far
+ */
+cerror_t vector_topk_clear(vector_topk_t* topk);
+
+
+//==============================================================================
+// External sort
+//==============================================================================
+
+/**
+ * memory budget of an external sort when none is given
+ */
+#define VECTOR_SORT_DEFAULT_BUDGET  (64 << 20)
+
+/**
+ * settings of an external sort, zeroed fields take the defaults
+ */
+typedef struct vector_sort_options_t
+{
+    size_t memory_budget;       /** bytes of record buffers, VECTOR_SORT_DEFAULT_BUDGET if 0 */
+    const char *temp_dir;       /** directory of the run files, $TMPDIR or /tmp if NULL */
+} vector_sort_options_t;
+
+/**
+ * sort the records of elem_size bytes read from input up to end of file and write them to output, which
+ * must be another file. Input that does not fit in the budget is sorted in runs spilled to an unlinked
+ * temporary file and k-way merged, in several passes if there are too many runs for the budget. A background
+ * thread reads ahead and writes behind so I/O overlaps sorting. Either descriptor may be a pipe. Fails with
+ * EBADFORMAT if the input is not a whole number of records.
+ */
+cerror_t vector_sort_fd(const int input, const int output, const size_t elem_size, vector_compare_t compare,
+        const vector_sort_options_t* options);
+/**
+ * vector_sort_fd from the file at input_path to the file at output_path, which is created or truncated
+ */
+cerror_t vector_sort_file(const char* input_path, const char* output_path, const size_t elem_size,
+        vector_compare_t compare, const vector_sort_options_t* options);
+
+
+//==============================================================================
+// Iterators
+//==============================================================================
+
+/**
+ * point iterator to the first element of the vector, elements returned by iterator_get may be modified.
+ * Fails with EREADONLY for read only vectors.
+ */
+cerror_t vector_begin(vector_t* vector, iterator_t* iterator);
+/**
+ * point iterator to the first element of the vector, elements must not be modified through it
+ */
+cerror_t vector_cbegin(const vector_t* vector, iterator_t* iterator);
 
 EXTERN_C_END
 
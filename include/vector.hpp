@@ -0,0 +1,642 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VECTOR_HPP
+
+#define VECTOR_HPP
+
+#include "include/ccollection.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+/**
+ * header only C++ interface over vector_t. It adds no state and no indirection of its own: ccollection::vector<T>
+ * is a single vector_t pointer, elements are laid out exactly as the C functions see them and iterators are plain
+ * pointers, so everything in <algorithm> runs on them at full speed.
+ */
+namespace ccollection
+{
+
+//==============================================================================
+// Errors
+//==============================================================================
+
+/**
+ * error category of the errno values set by the library, messages come from ccollection_strerror
+ */
+class error_category_t : public std::error_category
+{
+public:
+    const char* name() const noexcept override
+    {
+        return "ccollection";
+    }
+
+    std::string message(int err) const override
+    {
+        return ccollection_strerror(err);
+    }
+};
+
+inline const std::error_category& error_category()
+{
+    static const error_category_t category;
+    return category;
+}
+
+/**
+ * throw std::system_error for err, the errno left behind by a failed call
+ */
+[[noreturn]] inline void throw_error(const int err)
+{
+    throw std::system_error(err, error_category());
+}
+
+/**
+ * throw unless a call into the library succeeded
+ */
+inline void check(const cerror_t result)
+{
+    if (result != ERROR_NONE)
+    {
+        throw_error(errno);
+    }
+}
+
+//==============================================================================
+// Comparison
+//==============================================================================
+
+/**
+ * orders two elements with operator<
+ */
+template <typename T>
+int compare_less(const item_t* first, const item_t* second)
+{
+    const T& a = *static_cast<const T*>(first);
+    const T& b = *static_cast<const T*>(second);
+
+    return (b < a) - (a < b);
+}
+
+/**
+ * true if the typed and SIMD kernels of the library order T, which holds for unsigned integers of 1, 2, 4 or
+ * 8 bytes
+ */
+template <typename T>
+constexpr bool library_ordered()
+{
+    return std::is_integral<T>::value && std::is_unsigned<T>::value &&
+            (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+}
+
+/**
+ * true if vector<T> orders T with the standard algorithms, which compare signed integers and floating point
+ * values inline where compare_less would cost a call per comparison. NaN has no place in that order.
+ */
+template <typename T>
+constexpr bool inline_ordered()
+{
+    return std::is_arithmetic<T>::value && !library_ordered<T>();
+}
+
+/**
+ * comparator the C functions should use for T. Types the library orders get NULL so they run its typed
+ * kernels, everything else is ordered by operator< through compare_less.
+ */
+template <typename T>
+constexpr vector_compare_t compare()
+{
+    return library_ordered<T>() ? nullptr : &compare_less<T>;
+}
+
+//==============================================================================
+// vector
+//==============================================================================
+
+/**
+ * owning wrapper of a vector_t holding elements of type T. The element size is sizeof(T) and over aligned types
+ * get an aligned vector. It is move only, copies must be asked for with clone, which shares the buffer until
+ * either side is modified. A moved from vector may only be destroyed or assigned to.
+ *
+ * The C core moves elements with memcpy and never runs constructors or destructors, so T must be trivially
+ * copyable. Failures are thrown as std::system_error in error_category.
+ *
+ * Element access reads the vector_t through vector_layout and compiles to pointer arithmetic. Mutable access
+ * only calls into the library when the buffer is still shared with a clone.
+ */
+template <typename T>
+class vector
+{
+    static_assert(std::is_trivially_copyable<T>::value, "ccollection::vector needs a trivially copyable type");
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    //==========================================================================
+    // ctors and dtors
+    //==========================================================================
+
+    vector() : m_vector(create())
+    {
+    }
+
+    // the other constructors delegate to vector() so the destructor runs when their body throws
+    explicit vector(const size_type count, const T& value = T()) : vector()
+    {
+        assign(count, value);
+    }
+
+    vector(std::initializer_list<T> values) : vector(values.begin(), values.end())
+    {
+    }
+
+    template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    vector(InputIt first, InputIt last) : vector()
+    {
+        append(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    vector(const vector&) = delete;
+    vector& operator=(const vector&) = delete;
+
+    vector(vector&& other) noexcept : m_vector(other.m_vector)
+    {
+        other.m_vector = nullptr;
+    }
+
+    vector& operator=(vector&& other) noexcept
+    {
+        std::swap(m_vector, other.m_vector);
+        return *this;
+    }
+
+    ~vector()
+    {
+        if (m_vector != nullptr)
+        {
+            vector_destroy(m_vector);
+        }
+    }
+
+    /**
+     * returns a copy, the buffer is shared until one of the two is modified
+     */
+    vector clone() const
+    {
+        vector_t* copy = vector_clone(m_vector);
+        if (copy == nullptr)
+        {
+            throw_error(errno);
+        }
+        return vector(adopt_t(), copy);
+    }
+
+    /**
+     * the underlying vector_t, for the C functions this class does not wrap. It stays owned by this object.
+     */
+    vector_t* get() const noexcept
+    {
+        return m_vector;
+    }
+
+    /**
+     * give up ownership of the underlying vector_t, the caller must vector_destroy it
+     */
+    vector_t* release() noexcept
+    {
+        vector_t* released = m_vector;
+        m_vector = nullptr;
+        return released;
+    }
+
+    //==========================================================================
+    // Capacity
+    //==========================================================================
+
+    size_type size() const noexcept
+    {
+        return vector_layout(m_vector)->size;
+    }
+
+    size_type capacity() const noexcept
+    {
+        return vector_layout(m_vector)->capacity;
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    void reserve(const size_type count)
+    {
+        check(vector_reserve(m_vector, count));
+    }
+
+    //==========================================================================
+    // Modifiers
+    //==========================================================================
+
+    void push_back(const T& value)
+    {
+        // value may refer to an element of this vector, which growing moves
+        const T copy = value;
+        check(vector_push_back(m_vector, &copy));
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        const T value(std::forward<Args>(args)...);
+        push_back(value);
+        return back();
+    }
+
+    void pop_back()
+    {
+        check(vector_pop_back(m_vector));
+    }
+
+    /**
+     * insert value before pos, returns an iterator to the inserted element
+     */
+    iterator insert(const_iterator pos, const T& value)
+    {
+        const difference_type index = pos - cbegin();
+        const T copy = value;
+        check(vector_insert(m_vector, static_cast<pos_t>(index), &copy));
+        return begin() + index;
+    }
+
+    /**
+     * remove the element at pos, returns an iterator to the element that followed it
+     */
+    iterator erase(const_iterator pos)
+    {
+        const difference_type index = pos - cbegin();
+        check(vector_erase(m_vector, static_cast<pos_t>(index)));
+        return begin() + index;
+    }
+
+    /**
+     * replace the elements with count copies of value. vector_assign_n only overwrites the first count elements,
+     * so the vector is cleared first.
+     */
+    void assign(const size_type count, const T& value)
+    {
+        const T copy = value;
+        clear();
+        if (count > 0)
+        {
+            check(vector_assign_n(m_vector, count, &copy));
+        }
+    }
+
+    /**
+     * drop elements past count or append copies of value up to count
+     */
+    void resize(const size_type count, const T& value = T())
+    {
+        const T copy = value;
+        size_type current = size();
+        if (count > current)
+        {
+            reserve(count);
+        }
+        for (; current > count; current--)
+        {
+            pop_back();
+        }
+        for (; current < count; current++)
+        {
+            check(vector_push_back(m_vector, &copy));
+        }
+    }
+
+    void clear()
+    {
+        check(vector_clear(m_vector));
+    }
+
+    void swap(vector& other) noexcept
+    {
+        std::swap(m_vector, other.m_vector);
+    }
+
+    //==========================================================================
+    // Elements access
+    //==========================================================================
+
+    /**
+     * pointer to the first element, it is invalidated by modifiers that grow or shrink the vector
+     */
+    pointer data()
+    {
+        const vector_layout_t* layout = vector_layout(m_vector);
+        if (ccollection_unlikely(!vector_layout_writable(layout)))
+        {
+            return detach();
+        }
+        return reinterpret_cast<pointer>(layout->items);
+    }
+
+    const_pointer data() const noexcept
+    {
+        return reinterpret_cast<const_pointer>(vector_layout(m_vector)->items);
+    }
+
+    reference operator[](const size_type index)
+    {
+        return data()[index];
+    }
+
+    const_reference operator[](const size_type index) const noexcept
+    {
+        return data()[index];
+    }
+
+    /**
+     * bounds checked access, throws EOUTOFRANGE past the last element
+     */
+    reference at(const size_type index)
+    {
+        bounds(index);
+        return data()[index];
+    }
+
+    const_reference at(const size_type index) const
+    {
+        bounds(index);
+        return data()[index];
+    }
+
+    reference front()
+    {
+        return data()[0];
+    }
+
+    const_reference front() const noexcept
+    {
+        return data()[0];
+    }
+
+    reference back()
+    {
+        return data()[size() - 1];
+    }
+
+    const_reference back() const noexcept
+    {
+        return data()[size() - 1];
+    }
+
+    //==========================================================================
+    // Iterators
+    //==========================================================================
+
+    iterator begin()
+    {
+        return data();
+    }
+
+    iterator end()
+    {
+        return data() + size();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return data();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return data() + size();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    //==========================================================================
+    // Algorithms, running the kernels of the C library, see compare()
+    //==========================================================================
+
+    /**
+     * sort the elements in ascending order
+     */
+    void sort()
+    {
+        partial_sort(size());
+    }
+
+    /**
+     * move the count smallest elements to the front in ascending order
+     */
+    void partial_sort(const size_type count)
+    {
+        partial_sort(count, ordered_t());
+    }
+
+    /**
+     * put the element a full sort would place at nth there, smaller ones before it and larger ones after it
+     */
+    void nth_element(const size_type nth)
+    {
+        nth_element(nth, ordered_t());
+    }
+
+    /**
+     * remove adjacent equal elements, a sorted vector becomes a set
+     */
+    void unique()
+    {
+        unique(ordered_t());
+    }
+
+private:
+    /**
+     * tag of the constructor taking ownership of a vector_t, a plain pointer argument would make vector(0)
+     * ambiguous
+     */
+    struct adopt_t
+    {
+    };
+
+    vector(adopt_t, vector_t* adopted) noexcept : m_vector(adopted)
+    {
+    }
+
+    static vector_t* create()
+    {
+        vector_t* created = alignof(T) > alignof(std::max_align_t)
+            ? vector_new_aligned(sizeof(T), alignof(T))
+            : vector_new(sizeof(T));
+        if (created == nullptr)
+        {
+            throw_error(errno);
+        }
+        return created;
+    }
+
+    /**
+     * give a clone its own buffer, or throw for a read only vector
+     */
+    pointer detach()
+    {
+        item_t* items = vector_data(m_vector);
+        if (items == nullptr)
+        {
+            throw_error(errno);
+        }
+        return static_cast<pointer>(items);
+    }
+
+    /**
+     * selects the algorithms below, true_type for the inline ordered types
+     */
+    typedef std::integral_constant<bool, inline_ordered<T>()> ordered_t;
+
+    void partial_sort(const size_type count, std::false_type)
+    {
+        check(vector_partial_sort(m_vector, count, compare<T>()));
+    }
+
+    void partial_sort(const size_type count, std::true_type)
+    {
+        // same as the library: select the boundary in linear time, then only the front needs sorting
+        const size_type n = count < size() ? count : size();
+        if (n == 0)
+        {
+            return;
+        }
+        if (n < size())
+        {
+            std::nth_element(begin(), begin() + (n - 1), end());
+        }
+        std::sort(begin(), begin() + n);
+    }
+
+    void nth_element(const size_type nth, std::false_type)
+    {
+        check(vector_nth_element(m_vector, static_cast<pos_t>(nth), compare<T>()));
+    }
+
+    void nth_element(const size_type nth, std::true_type)
+    {
+        bounds(nth);
+        std::nth_element(begin(), begin() + nth, end());
+    }
+
+    void unique(std::false_type)
+    {
+        check(vector_unique(m_vector, compare<T>()));
+    }
+
+    void unique(std::true_type)
+    {
+        resize(static_cast<size_type>(std::unique(begin(), end()) - begin()));
+    }
+
+    void bounds(const size_type index) const
+    {
+        if (index >= size())
+        {
+            throw_error(EOUTOFRANGE);
+        }
+    }
+
+    template <typename InputIt>
+    void append(InputIt first, InputIt last, std::input_iterator_tag)
+    {
+        for (; first != last; ++first)
+        {
+            push_back(*first);
+        }
+    }
+
+    template <typename ForwardIt>
+    void append(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+        reserve(size() + static_cast<size_type>(std::distance(first, last)));
+        append(first, last, std::input_iterator_tag());
+    }
+
+    vector_t* m_vector;     /** owned vector, NULL once moved from or released */
+};
+
+template <typename T>
+void swap(vector<T>& first, vector<T>& second) noexcept
+{
+    first.swap(second);
+}
+
+} // namespace ccollection
+
+#endif /* end of include guard: VECTOR_HPP */
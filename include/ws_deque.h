@@ -0,0 +1,105 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WS_DEQUE_H
+
+#define WS_DEQUE_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// forward declarations
+//==============================================================================
+
+/**
+ * Chase-Lev work stealing deque. One owner thread pushes and pops elements at the bottom without locking,
+ * any number of thief threads steal elements from the top with a single CAS. Elements are element_size
+ * bytes copied in and out of a growable circular buffer, at most WS_DEQUE_MAX_ELEMENT_SIZE bytes so thieves
+ * can copy them to their stack before they claim them.
+ *
+ * ws_deque_push and ws_deque_pop must only be called by the owner thread, ws_deque_steal by any thread.
+ */
+typedef struct ws_deque_t ws_deque_t;
+
+/**
+ * largest element ws_deque_t holds, bigger tasks should be pushed by pointer
+ */
+#define WS_DEQUE_MAX_ELEMENT_SIZE   128
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+
+/**
+ * returns a pointer to an empty ws_deque_t with room for at least capacity elements before it grows.
+ * Returns NULL if elem_size <= 0 or elem_size > WS_DEQUE_MAX_ELEMENT_SIZE and sets errno.
+ */
+ws_deque_t* ws_deque_new(const size_t elem_size, const size_t capacity);
+/**
+ * free the deque and every buffer it used, no thread may use the deque any more
+ */
+cerror_t ws_deque_destroy(ws_deque_t* deque);
+
+
+//==============================================================================
+// Capacity
+//==============================================================================
+
+/**
+ * get number of elements in the deque, only a snapshot when thieves are active
+ */
+size_t ws_deque_get_size(const ws_deque_t* deque);
+
+
+//==============================================================================
+// Owner operations
+//==============================================================================
+
+/**
+ * push an element at the bottom, the buffer doubles when full
+ */
+cerror_t ws_deque_push(ws_deque_t* deque, const item_t* item);
+/**
+ * pop the element at the bottom into item, the most recently pushed one.
+ * Returns ERROR_FAILED and sets errno to EEMPTY if there is none left, item is left untouched then.
+ */
+cerror_t ws_deque_pop(ws_deque_t* deque, item_t* item);
+
+
+//==============================================================================
+// Thief operations
+//==============================================================================
+
+/**
+ * steal the element at the top into item, the least recently pushed one.
+ * Returns ERROR_FAILED and sets errno to EEMPTY if the deque is empty, or to EAGAIN if another thread
+ * took the element first, in which case trying again may succeed. item is only written on success.
+ */
+cerror_t ws_deque_steal(ws_deque_t* deque, item_t* item);
+
+EXTERN_C_END
+
+#endif /* end of include guard: WS_DEQUE_H */
@@ -0,0 +1,549 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/bitset.h"
+#include "src/vector-internal.h"
+#include "src/cpu-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#ifdef CCOLLECTION_SIMD
+    #include <immintrin.h>
+#endif
+
+EXTERN_C_BEGIN
+
+#define BITSET_WORD_BITS        64
+#define BITSET_WORDS(bits)      (((bits) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+#define BITSET_ALIGNMENT        64
+#define BITSET_SELECT_BLOCK     8
+
+/**
+ * bitset data structure defenition. words is an aligned vector of uint64_t holding BITSET_WORDS(size) words,
+ * the bits past size in the last word are always 0.
+ */
+struct bitset_t
+{
+    vector_t *words;            /** bits */
+    size_t size;                /** number of bits */
+};
+
+/**
+ * word kernels, one set per instruction set
+ */
+typedef struct bitset_kernels_t
+{
+    size_t (*count)(const uint64_t* words, const size_t n);
+    void (*and)(uint64_t* dst, const uint64_t* src, const size_t n);
+    void (*or)(uint64_t* dst, const uint64_t* src, const size_t n);
+    void (*xor)(uint64_t* dst, const uint64_t* src, const size_t n);
+    void (*andnot)(uint64_t* dst, const uint64_t* src, const size_t n);
+} bitset_kernels_t;
+
+//==============================================================================
+// Baseline kernels
+//==============================================================================
+
+static size_t bitset_count_generic(const uint64_t* words, const size_t n)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+static void bitset_and_generic(uint64_t* dst, const uint64_t* src, const size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        dst[i] &= src[i];
+    }
+}
+
+static void bitset_or_generic(uint64_t* dst, const uint64_t* src, const size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        dst[i] |= src[i];
+    }
+}
+
+static void bitset_xor_generic(uint64_t* dst, const uint64_t* src, const size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        dst[i] ^= src[i];
+    }
+}
+
+static void bitset_andnot_generic(uint64_t* dst, const uint64_t* src, const size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        dst[i] &= ~src[i];
+    }
+}
+
+static const bitset_kernels_t bitset_kernels_generic = {
+    bitset_count_generic,
+    bitset_and_generic,
+    bitset_or_generic,
+    bitset_xor_generic,
+    bitset_andnot_generic,
+};
+
+//==============================================================================
+// SIMD kernels
+//==============================================================================
+#ifdef CCOLLECTION_SIMD
+
+CCOLLECTION_TARGET("popcnt")
+static size_t bitset_count_popcnt(const uint64_t* words, const size_t n)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        count += _mm_popcnt_u64(words[i]);
+    }
+    return count;
+}
+
+/**
+ * count bits with a nibble lookup table in every byte lane, summing the bytes into 64 bit lanes with sad
+ */
+CCOLLECTION_TARGET("avx2,popcnt")
+static size_t bitset_count_avx2(const uint64_t* words, const size_t n)
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(words + i));
+        const __m256i low = _mm256_and_si256(v, low_mask);
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+
+    size_t count = _mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) +
+        _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3);
+    for (; i < n; i++)
+    {
+        count += _mm_popcnt_u64(words[i]);
+    }
+    return count;
+}
+
+#define BITSET_AVX2_OP(name, expr, tail)                                                \
+    CCOLLECTION_TARGET("avx2")                                                          \
+    static void bitset_##name##_avx2(uint64_t* dst, const uint64_t* src, const size_t n) \
+    {                                                                                   \
+        size_t i = 0;                                                                   \
+        for (; i + 4 <= n; i += 4)                                                      \
+        {                                                                               \
+            const __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));            \
+            const __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));            \
+            _mm256_storeu_si256((__m256i*)(dst + i), expr);                             \
+        }                                                                               \
+        for (; i < n; i++)                                                              \
+        {                                                                               \
+            dst[i] = tail;                                                              \
+        }                                                                               \
+    }
+
+BITSET_AVX2_OP(and, _mm256_and_si256(a, b), dst[i] & src[i])
+BITSET_AVX2_OP(or, _mm256_or_si256(a, b), dst[i] | src[i])
+BITSET_AVX2_OP(xor, _mm256_xor_si256(a, b), dst[i] ^ src[i])
+BITSET_AVX2_OP(andnot, _mm256_andnot_si256(b, a), dst[i] & ~src[i])
+
+static const bitset_kernels_t bitset_kernels_popcnt = {
+    bitset_count_popcnt,
+    bitset_and_generic,
+    bitset_or_generic,
+    bitset_xor_generic,
+    bitset_andnot_generic,
+};
+
+static const bitset_kernels_t bitset_kernels_avx2 = {
+    bitset_count_avx2,
+    bitset_and_avx2,
+    bitset_or_avx2,
+    bitset_xor_avx2,
+    bitset_andnot_avx2,
+};
+
+#endif
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static const bitset_kernels_t *bitset_active_kernels = &bitset_kernels_generic;
+static pthread_once_t bitset_kernels_once = PTHREAD_ONCE_INIT;
+
+static void bitset_select_kernels(void)
+{
+#ifdef CCOLLECTION_SIMD
+    if (ccollection_cpu_avx2() && ccollection_cpu_popcnt())
+    {
+        bitset_active_kernels = &bitset_kernels_avx2;
+    }
+    else if (ccollection_cpu_popcnt())
+    {
+        bitset_active_kernels = &bitset_kernels_popcnt;
+    }
+#endif
+}
+
+static inline const bitset_kernels_t* bitset_kernels(void)
+{
+    pthread_once(&bitset_kernels_once, bitset_select_kernels);
+    return bitset_active_kernels;
+}
+
+static inline uint64_t* bitset_words(const bitset_t* bitset)
+{
+    return (uint64_t*)bitset->words->items;
+}
+
+static inline size_t bitset_word_count(const bitset_t* bitset)
+{
+    return BITSET_WORDS(bitset->size);
+}
+
+/**
+ * clear the bits past size in the last word
+ */
+static inline void bitset_trim(bitset_t* bitset)
+{
+    const size_t bits = bitset->size % BITSET_WORD_BITS;
+    if (bits != 0)
+    {
+        bitset_words(bitset)[bitset->size / BITSET_WORD_BITS] &= (UINT64_C(1) << bits) - 1;
+    }
+}
+
+/**
+ * position of the set bit with rank rank inside word
+ */
+static inline size_t bitset_select_word(uint64_t word, size_t rank)
+{
+    while (rank-- > 0)
+    {
+        word &= word - 1;
+    }
+    return __builtin_ctzll(word);
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+bitset_t* bitset_new(const size_t size)
+{
+    errno = 0;
+
+    bitset_t *bitset = ccollection_calloc(sizeof(bitset_t));
+    ASSERT(bitset != NULL, NULL);
+
+    bitset->words = vector_new_aligned(sizeof(uint64_t), BITSET_ALIGNMENT);
+    if (bitset->words == NULL || bitset_resize(bitset, size) != ERROR_NONE)
+    {
+        bitset_destroy(bitset);
+        return NULL;
+    }
+
+    return bitset;
+}
+
+cerror_t bitset_destroy(bitset_t* bitset)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+
+    if (bitset->words != NULL)
+        vector_destroy(bitset->words);
+    ccollection_free(bitset);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Capacity
+//==============================================================================
+size_t bitset_get_size(const bitset_t* bitset)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, 0);
+
+    return bitset->size;
+}
+
+cerror_t bitset_resize(bitset_t* bitset, const size_t size)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector_t *words = bitset->words;
+    const size_t count = BITSET_WORDS(size);
+
+    if (count > words->capacity)
+    {
+        ASSERT(vector_reserve(words, count) == ERROR_NONE, ERROR_FAILED);
+    }
+    if (count > words->size)
+    {
+        memset(VECTOR_ITEM(words, words->size), 0, (count - words->size) * sizeof(uint64_t));
+    }
+    words->size = count;
+    bitset->size = size;
+    bitset_trim(bitset);
+
+    return ERROR_NONE;
+}
+
+cerror_t bitset_reserve(bitset_t* bitset, const size_t size)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+
+    return vector_reserve(bitset->words, BITSET_WORDS(size));
+}
+
+//==============================================================================
+// Bit access
+//==============================================================================
+cerror_t bitset_set(bitset_t* bitset, const size_t index)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(index < bitset->size, EOUTOFRANGE, ERROR_FAILED);
+
+    bitset_words(bitset)[index / BITSET_WORD_BITS] |= UINT64_C(1) << (index % BITSET_WORD_BITS);
+
+    return ERROR_NONE;
+}
+
+cerror_t bitset_reset(bitset_t* bitset, const size_t index)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(index < bitset->size, EOUTOFRANGE, ERROR_FAILED);
+
+    bitset_words(bitset)[index / BITSET_WORD_BITS] &= ~(UINT64_C(1) << (index % BITSET_WORD_BITS));
+
+    return ERROR_NONE;
+}
+
+cerror_t bitset_assign(bitset_t* bitset, const size_t index, const bool value)
+{
+    return value ? bitset_set(bitset, index) : bitset_reset(bitset, index);
+}
+
+cerror_t bitset_flip(bitset_t* bitset, const size_t index)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(index < bitset->size, EOUTOFRANGE, ERROR_FAILED);
+
+    bitset_words(bitset)[index / BITSET_WORD_BITS] ^= UINT64_C(1) << (index % BITSET_WORD_BITS);
+
+    return ERROR_NONE;
+}
+
+bool bitset_test(const bitset_t* bitset, const size_t index)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, false);
+    ASSERT(index < bitset->size, false);
+
+    return (bitset_words(bitset)[index / BITSET_WORD_BITS] >> (index % BITSET_WORD_BITS)) & 1;
+}
+
+cerror_t bitset_push_back(bitset_t* bitset, const bool value)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector_t *words = bitset->words;
+    if (bitset->size % BITSET_WORD_BITS == 0 && words->size == words->capacity)
+    {
+        ASSERT(vector_reserve(words, MAX(words->capacity * 2, 1)) == ERROR_NONE, ERROR_FAILED);
+    }
+    ASSERT(bitset_resize(bitset, bitset->size + 1) == ERROR_NONE, ERROR_FAILED);
+
+    return value ? bitset_set(bitset, bitset->size - 1) : ERROR_NONE;
+}
+
+cerror_t bitset_fill(bitset_t* bitset, const bool value)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+
+    memset(bitset_words(bitset), value ? 0xff : 0, bitset_word_count(bitset) * sizeof(uint64_t));
+    bitset_trim(bitset);
+
+    return ERROR_NONE;
+}
+
+const uint64_t* bitset_cdata(const bitset_t* bitset)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, NULL);
+
+    return bitset_words(bitset);
+}
+
+//==============================================================================
+// Queries
+//==============================================================================
+size_t bitset_count(const bitset_t* bitset)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, 0);
+
+    return bitset_kernels()->count(bitset_words(bitset), bitset_word_count(bitset));
+}
+
+size_t bitset_rank(const bitset_t* bitset, const size_t index)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, 0);
+    ASSERT_E(index <= bitset->size, EOUTOFRANGE, 0);
+
+    const uint64_t *words = bitset_words(bitset);
+    const size_t word = index / BITSET_WORD_BITS;
+    const size_t bits = index % BITSET_WORD_BITS;
+
+    size_t rank = bitset_kernels()->count(words, word);
+    if (bits != 0)
+    {
+        rank += __builtin_popcountll(words[word] & ((UINT64_C(1) << bits) - 1));
+    }
+    return rank;
+}
+
+size_t bitset_select(const bitset_t* bitset, const size_t rank)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, BITSET_NPOS);
+
+    const bitset_kernels_t *kernels = bitset_kernels();
+    const uint64_t *words = bitset_words(bitset);
+    const size_t n = bitset_word_count(bitset);
+    size_t remaining = rank;
+    size_t i = 0;
+
+    // skip whole blocks with the vectorized count, then words
+    for (; i + BITSET_SELECT_BLOCK <= n; i += BITSET_SELECT_BLOCK)
+    {
+        const size_t count = kernels->count(words + i, BITSET_SELECT_BLOCK);
+        if (count > remaining)
+        {
+            break;
+        }
+        remaining -= count;
+    }
+    for (; i < n; i++)
+    {
+        const size_t count = __builtin_popcountll(words[i]);
+        if (count > remaining)
+        {
+            return i * BITSET_WORD_BITS + bitset_select_word(words[i], remaining);
+        }
+        remaining -= count;
+    }
+
+    return BITSET_NPOS;
+}
+
+size_t bitset_find_next(const bitset_t* bitset, const size_t from)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, BITSET_NPOS);
+    ASSERT(from < bitset->size, BITSET_NPOS);
+
+    const uint64_t *words = bitset_words(bitset);
+    const size_t n = bitset_word_count(bitset);
+    size_t i = from / BITSET_WORD_BITS;
+
+    uint64_t word = words[i] & (~UINT64_C(0) << (from % BITSET_WORD_BITS));
+    while (word == 0)
+    {
+        if (++i == n)
+        {
+            return BITSET_NPOS;
+        }
+        word = words[i];
+    }
+
+    return i * BITSET_WORD_BITS + __builtin_ctzll(word);
+}
+
+size_t bitset_find_first(const bitset_t* bitset)
+{
+    return bitset_find_next(bitset, 0);
+}
+
+//==============================================================================
+// Bulk operations
+//==============================================================================
+
+/**
+ * apply op to the words both bitsets have, the rest of bitset is cleared if clear_tail is set
+ */
+static cerror_t bitset_combine(bitset_t* bitset, const bitset_t* other,
+        void (*op)(uint64_t*, const uint64_t*, const size_t), const bool clear_tail)
+{
+    ASSERT_E(bitset != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(other != NULL, EBADPOINTER, ERROR_FAILED);
+
+    const size_t n = bitset_word_count(bitset);
+    const size_t common = MIN(n, bitset_word_count(other));
+
+    op(bitset_words(bitset), bitset_words(other), common);
+    if (clear_tail && common < n)
+    {
+        memset(bitset_words(bitset) + common, 0, (n - common) * sizeof(uint64_t));
+    }
+    bitset_trim(bitset);
+
+    return ERROR_NONE;
+}
+
+cerror_t bitset_and(bitset_t* bitset, const bitset_t* other)
+{
+    return bitset_combine(bitset, other, bitset_kernels()->and, true);
+}
+
+cerror_t bitset_or(bitset_t* bitset, const bitset_t* other)
+{
+    return bitset_combine(bitset, other, bitset_kernels()->or, false);
+}
+
+cerror_t bitset_xor(bitset_t* bitset, const bitset_t* other)
+{
+    return bitset_combine(bitset, other, bitset_kernels()->xor, false);
+}
+
+cerror_t bitset_andnot(bitset_t* bitset, const bitset_t* other)
+{
+    return bitset_combine(bitset, other, bitset_kernels()->andnot, false);
+}
+
+EXTERN_C_END
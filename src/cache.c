@@ -0,0 +1,641 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+#define CACHE_NIL               UINT32_MAX
+#define CACHE_MAX_ENTRIES       (UINT32_MAX - 1)
+#define CACHE_MAX_FREQUENCY     3
+
+/**
+ * lists an entry can be linked in
+ */
+typedef enum cache_queue_t
+{
+    CACHE_QUEUE_MAIN,           /** recency list of LRU, main FIFO of S3-FIFO */
+    CACHE_QUEUE_SMALL,          /** probation FIFO of S3-FIFO */
+    CACHE_QUEUE_COUNT,
+    CACHE_QUEUE_FREE = CACHE_QUEUE_COUNT    /** unused entry, linked in the free list */
+} cache_queue_t;
+
+/**
+ * doubly linked list threaded through the prev and next arrays, newest entry at head
+ */
+typedef struct cache_list_t
+{
+    uint32_t head;
+    uint32_t tail;
+    size_t size;
+} cache_list_t;
+
+/**
+ * cache data structure defenition. Entry i owns keys[i * key_size], values[i * value_size] and element i of
+ * every metadata array. The index is an open addressing table of entry + 1, 0 marks an empty bucket.
+ */
+struct cache_t
+{
+    size_t key_size;            /** size of one key */
+    size_t value_size;          /** size of one value */
+    size_t capacity;            /** number of entries */
+    size_t size;                /** entries in use */
+    cache_policy_t policy;      /** replacement policy */
+    uint8_t *keys;              /** capacity keys */
+    uint8_t *values;            /** capacity values */
+    uint64_t *hashes;           /** hash of every key */
+    uint32_t *prev;             /** previous entry in its list */
+    uint32_t *next;             /** next entry in its list or in the free list */
+    uint8_t *queue;             /** cache_queue_t of every entry */
+    uint8_t *frequency;         /** CLOCK reference bit, S3-FIFO access frequency */
+    uint32_t *index;            /** hash table of entries */
+    size_t index_mask;          /** buckets - 1 */
+    uint64_t *ghost;            /** S3-FIFO hashes of recently evicted keys, direct mapped */
+    size_t ghost_mask;          /** ghost slots - 1 */
+    size_t small_capacity;      /** S3-FIFO probation FIFO target size */
+    cache_list_t lists[CACHE_QUEUE_COUNT];
+    uint32_t free_head;         /** first unused entry */
+    uint32_t hand;              /** CLOCK hand */
+    cache_evict_fn evict;       /** eviction callback */
+    void *context;              /** eviction callback context */
+    cache_counters_t counters;  /** access counters */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static inline uint64_t cache_mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * hash key eight bytes at a time, never returns 0 which marks empty ghost slots
+ */
+static uint64_t cache_hash(const uint8_t* key, size_t size)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+    uint64_t word;
+
+    for (; size >= sizeof(word); size -= sizeof(word), key += sizeof(word))
+    {
+        memcpy(&word, key, sizeof(word));
+        h = (h ^ cache_mix(word)) * 0x9e3779b97f4a7c15ULL;
+    }
+    if (size > 0)
+    {
+        word = 0;
+        memcpy(&word, key, size);
+        h = (h ^ cache_mix(word)) * 0x9e3779b97f4a7c15ULL;
+    }
+    h = cache_mix(h);
+
+    return h != 0 ? h : 1;
+}
+
+static inline uint8_t* cache_key(const cache_t* cache, const uint32_t entry)
+{
+    return cache->keys + (size_t)entry * cache->key_size;
+}
+
+static inline uint8_t* cache_value(const cache_t* cache, const uint32_t entry)
+{
+    return cache->values + (size_t)entry * cache->value_size;
+}
+
+/**
+ * upper bound of the memory one entry takes, rounding the index and the ghost up to a power of 2 can double them
+ */
+static size_t cache_entry_size(const size_t key_size, const size_t value_size, const cache_policy_t policy)
+{
+    // key, value, hash, links, queue, frequency and index buckets
+    size_t size = key_size + value_size + sizeof(uint64_t) + 2 * sizeof(uint32_t) + 2 + 4 * sizeof(uint32_t);
+
+    return policy == CACHE_POLICY_S3FIFO ? size + 2 * sizeof(uint64_t) : size;
+}
+
+static size_t cache_pow2(const size_t n)
+{
+    size_t p = 1;
+    while (p < n)
+    {
+        p <<= 1;
+    }
+    return p;
+}
+
+static uint32_t cache_lookup(const cache_t* cache, const item_t* key, const uint64_t hash)
+{
+    for (size_t bucket = hash & cache->index_mask; ; bucket = (bucket + 1) & cache->index_mask)
+    {
+        const uint32_t slot = cache->index[bucket];
+        if (slot == 0)
+        {
+            return CACHE_NIL;
+        }
+        if (cache->hashes[slot - 1] == hash && memcmp(cache_key(cache, slot - 1), key, cache->key_size) == 0)
+        {
+            return slot - 1;
+        }
+    }
+}
+
+static void cache_index_insert(cache_t* cache, const uint32_t entry)
+{
+    size_t bucket = cache->hashes[entry] & cache->index_mask;
+    while (cache->index[bucket] != 0)
+    {
+        bucket = (bucket + 1) & cache->index_mask;
+    }
+    cache->index[bucket] = entry + 1;
+}
+
+/**
+ * remove entry from the index, shifting later entries of its probe sequence back instead of leaving a tombstone
+ */
+static void cache_index_remove(cache_t* cache, const uint32_t entry)
+{
+    size_t hole = cache->hashes[entry] & cache->index_mask;
+    while (cache->index[hole] != entry + 1)
+    {
+        hole = (hole + 1) & cache->index_mask;
+    }
+
+    for (size_t bucket = (hole + 1) & cache->index_mask; cache->index[bucket] != 0;
+            bucket = (bucket + 1) & cache->index_mask)
+    {
+        const size_t home = cache->hashes[cache->index[bucket] - 1] & cache->index_mask;
+
+        // move the entry into the hole unless its home bucket lies cyclically in (hole, bucket]
+        if (((bucket - home) & cache->index_mask) >= ((bucket - hole) & cache->index_mask))
+        {
+            cache->index[hole] = cache->index[bucket];
+            hole = bucket;
+        }
+    }
+    cache->index[hole] = 0;
+}
+
+static void cache_list_push(cache_t* cache, const cache_queue_t queue, const uint32_t entry)
+{
+    cache_list_t *list = &cache->lists[queue];
+
+    cache->queue[entry] = queue;
+    cache->prev[entry] = CACHE_NIL;
+    cache->next[entry] = list->head;
+    if (list->head != CACHE_NIL)
+    {
+        cache->prev[list->head] = entry;
+    }
+    else
+    {
+        list->tail = entry;
+    }
+    list->head = entry;
+    list->size++;
+}
+
+static void cache_list_unlink(cache_t* cache, const uint32_t entry)
+{
+    cache_list_t *list = &cache->lists[cache->queue[entry]];
+
+    if (cache->prev[entry] != CACHE_NIL)
+    {
+        cache->next[cache->prev[entry]] = cache->next[entry];
+    }
+    else
+    {
+        list->head = cache->next[entry];
+    }
+    if (cache->next[entry] != CACHE_NIL)
+    {
+        cache->prev[cache->next[entry]] = cache->prev[entry];
+    }
+    else
+    {
+        list->tail = cache->prev[entry];
+    }
+    list->size--;
+}
+
+/**
+ * record a hit on entry
+ */
+static inline void cache_touch(cache_t* cache, const uint32_t entry)
+{
+    switch (cache->policy)
+    {
+        case CACHE_POLICY_LRU:
+            if (cache->lists[CACHE_QUEUE_MAIN].head != entry)
+            {
+                cache_list_unlink(cache, entry);
+                cache_list_push(cache, CACHE_QUEUE_MAIN, entry);
+            }
+            break;
+        case CACHE_POLICY_CLOCK:
+            cache->frequency[entry] = 1;
+            break;
+        case CACHE_POLICY_S3FIFO:
+            if (cache->frequency[entry] < CACHE_MAX_FREQUENCY)
+            {
+                cache->frequency[entry]++;
+            }
+            break;
+    }
+}
+
+/**
+ * pick the entry to evict and unlink it from its list
+ */
+static uint32_t cache_victim(cache_t* cache)
+{
+    uint32_t entry;
+
+    switch (cache->policy)
+    {
+        case CACHE_POLICY_LRU:
+            entry = cache->lists[CACHE_QUEUE_MAIN].tail;
+            cache_list_unlink(cache, entry);
+            return entry;
+
+        case CACHE_POLICY_CLOCK:
+            for (;;)
+            {
+                entry = cache->hand;
+                cache->hand = cache->hand + 1 == cache->capacity ? 0 : cache->hand + 1;
+
+                if (cache->queue[entry] == CACHE_QUEUE_FREE)
+                {
+                    continue;
+                }
+                if (cache->frequency[entry] == 0)
+                {
+                    return entry;
+                }
+                cache->frequency[entry] = 0;
+            }
+
+        case CACHE_POLICY_S3FIFO:
+        default:
+            for (;;)
+            {
+                cache_list_t *small = &cache->lists[CACHE_QUEUE_SMALL];
+
+                if (small->size > 0 &&
+                        (small->size >= cache->small_capacity || cache->lists[CACHE_QUEUE_MAIN].size == 0))
+                {
+                    // entries accessed again while on probation are promoted, the others leave a ghost
+                    entry = small->tail;
+                    cache_list_unlink(cache, entry);
+                    if (cache->frequency[entry] > 1)
+                    {
+                        cache->frequency[entry] = 0;
+                        cache_list_push(cache, CACHE_QUEUE_MAIN, entry);
+                        continue;
+                    }
+                    cache->ghost[cache->hashes[entry] & cache->ghost_mask] = cache->hashes[entry];
+                    return entry;
+                }
+
+                entry = cache->lists[CACHE_QUEUE_MAIN].tail;
+                cache_list_unlink(cache, entry);
+                if (cache->frequency[entry] > 0)
+                {
+                    cache->frequency[entry]--;
+                    cache_list_push(cache, CACHE_QUEUE_MAIN, entry);
+                    continue;
+                }
+                return entry;
+            }
+    }
+}
+
+/**
+ * link a new entry where the policy admits it
+ */
+static void cache_admit(cache_t* cache, const uint32_t entry)
+{
+    cache->frequency[entry] = 0;
+
+    switch (cache->policy)
+    {
+        case CACHE_POLICY_LRU:
+            cache_list_push(cache, CACHE_QUEUE_MAIN, entry);
+            break;
+        case CACHE_POLICY_CLOCK:
+            cache->queue[entry] = CACHE_QUEUE_MAIN;
+            break;
+        case CACHE_POLICY_S3FIFO:
+        {
+            uint64_t *ghost = &cache->ghost[cache->hashes[entry] & cache->ghost_mask];
+
+            // keys evicted from probation recently come back straight into main
+            if (*ghost == cache->hashes[entry])
+            {
+                *ghost = 0;
+                cache_list_push(cache, CACHE_QUEUE_MAIN, entry);
+            }
+            else
+            {
+                cache_list_push(cache, CACHE_QUEUE_SMALL, entry);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * unlink entry from the policy and the index and put it on the free list
+ */
+static void cache_release(cache_t* cache, const uint32_t entry)
+{
+    if (cache->policy != CACHE_POLICY_CLOCK)
+    {
+        cache_list_unlink(cache, entry);
+    }
+    cache_index_remove(cache, entry);
+
+    cache->queue[entry] = CACHE_QUEUE_FREE;
+    cache->next[entry] = cache->free_head;
+    cache->free_head = entry;
+    cache->size--;
+}
+
+static void cache_reset(cache_t* cache)
+{
+    for (size_t i = 0; i < cache->capacity; i++)
+    {
+        cache->queue[i] = CACHE_QUEUE_FREE;
+        cache->next[i] = i + 1 < cache->capacity ? i + 1 : CACHE_NIL;
+    }
+    for (size_t i = 0; i < CACHE_QUEUE_COUNT; i++)
+    {
+        cache->lists[i].head = CACHE_NIL;
+        cache->lists[i].tail = CACHE_NIL;
+        cache->lists[i].size = 0;
+    }
+    memset(cache->index, 0, (cache->index_mask + 1) * sizeof(uint32_t));
+
+    cache->free_head = 0;
+    cache->hand = 0;
+    cache->size = 0;
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+cache_t* cache_new(const size_t key_size, const size_t value_size, const cache_options_t* options)
+{
+    errno = 0;
+    ASSERT_E(key_size > 0 && value_size > 0, EBADELEMSIZE, NULL);
+    ASSERT_E(options != NULL, EBADPOINTER, NULL);
+    ASSERT_E(options->policy <= CACHE_POLICY_S3FIFO, EINVAL, NULL);
+
+    size_t capacity = options->capacity;
+    if (capacity == 0)
+    {
+        const size_t budget = options->max_bytes > sizeof(cache_t) ? options->max_bytes - sizeof(cache_t) : 0;
+        capacity = budget / cache_entry_size(key_size, value_size, options->policy);
+    }
+    ASSERT_E(capacity > 0 && capacity <= CACHE_MAX_ENTRIES, EINVAL, NULL);
+
+    cache_t *cache = ccollection_calloc(sizeof(cache_t));
+    ASSERT(cache != NULL, NULL);
+
+    cache->key_size = key_size;
+    cache->value_size = value_size;
+    cache->capacity = capacity;
+    cache->policy = options->policy;
+    cache->evict = options->evict;
+    cache->context = options->context;
+    cache->small_capacity = MAX(capacity / 10, 1);
+
+    // at most half of the buckets are used, probe sequences stay short
+    cache->index_mask = cache_pow2(2 * capacity) - 1;
+
+    cache->keys = ccollection_calloc(capacity * key_size);
+    cache->values = ccollection_calloc(capacity * value_size);
+    cache->hashes = ccollection_calloc(capacity * sizeof(uint64_t));
+    cache->prev = ccollection_calloc(capacity * sizeof(uint32_t));
+    cache->next = ccollection_calloc(capacity * sizeof(uint32_t));
+    cache->queue = ccollection_calloc(capacity);
+    cache->frequency = ccollection_calloc(capacity);
+    cache->index = ccollection_calloc((cache->index_mask + 1) * sizeof(uint32_t));
+
+    if (cache->policy == CACHE_POLICY_S3FIFO)
+    {
+        cache->ghost_mask = cache_pow2(capacity) - 1;
+        cache->ghost = ccollection_calloc((cache->ghost_mask + 1) * sizeof(uint64_t));
+    }
+
+    if (cache->keys == NULL || cache->values == NULL || cache->hashes == NULL || cache->prev == NULL ||
+            cache->next == NULL || cache->queue == NULL || cache->frequency == NULL || cache->index == NULL ||
+            (cache->policy == CACHE_POLICY_S3FIFO && cache->ghost == NULL))
+    {
+        cache_destroy(cache);
+        errno = ENOMEM;
+        return NULL;
+    }
+    cache_reset(cache);
+
+    return cache;
+}
+
+cerror_t cache_destroy(cache_t* cache)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, ERROR_FAILED);
+
+    ccollection_free(cache->keys);
+    ccollection_free(cache->values);
+    ccollection_free(cache->hashes);
+    ccollection_free(cache->prev);
+    ccollection_free(cache->next);
+    ccollection_free(cache->queue);
+    ccollection_free(cache->frequency);
+    ccollection_free(cache->index);
+    ccollection_free(cache->ghost);
+    ccollection_free(cache);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Capacity
+//==============================================================================
+size_t cache_get_size(const cache_t* cache)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, 0);
+
+    return cache->size;
+}
+
+size_t cache_get_capacity(const cache_t* cache)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, 0);
+
+    return cache->capacity;
+}
+
+size_t cache_get_memory(const cache_t* cache)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, 0);
+
+    return sizeof(cache_t) +
+        cache->capacity * (cache->key_size + cache->value_size + sizeof(uint64_t) + 2 * sizeof(uint32_t) + 2) +
+        (cache->index_mask + 1) * sizeof(uint32_t) +
+        (cache->ghost != NULL ? (cache->ghost_mask + 1) * sizeof(uint64_t) : 0);
+}
+
+cerror_t cache_get_counters(const cache_t* cache, cache_counters_t* counters)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(counters != NULL, EBADPOINTER, ERROR_FAILED);
+
+    *counters = cache->counters;
+
+    return ERROR_NONE;
+}
+
+cerror_t cache_reset_counters(cache_t* cache)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, ERROR_FAILED);
+
+    memset(&cache->counters, 0, sizeof(cache_counters_t));
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Lookup
+//==============================================================================
+cerror_t cache_get(cache_t* cache, const item_t* key, item_t* value)
+{
+    ASSERT_E(value != NULL, EBADPOINTER, ERROR_FAILED);
+
+    const item_t *found = cache_find(cache, key);
+    ASSERT(found != NULL, ERROR_FAILED);
+
+    ccollection_copy(value, found, cache->value_size);
+
+    return ERROR_NONE;
+}
+
+item_t* cache_find(cache_t* cache, const item_t* key)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, NULL);
+    ASSERT_E(key != NULL, EBADPOINTER, NULL);
+
+    const uint32_t entry = cache_lookup(cache, key, cache_hash(key, cache->key_size));
+    if (entry == CACHE_NIL)
+    {
+        cache->counters.misses++;
+        errno = ENOENT;
+        return NULL;
+    }
+    cache->counters.hits++;
+    cache_touch(cache, entry);
+
+    return cache_value(cache, entry);
+}
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+cerror_t cache_put(cache_t* cache, const item_t* key, const item_t* value)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(key != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(value != NULL, EBADPOINTER, ERROR_FAILED);
+
+    const uint64_t hash = cache_hash(key, cache->key_size);
+
+    uint32_t entry = cache_lookup(cache, key, hash);
+    if (entry != CACHE_NIL)
+    {
+        ccollection_copy(cache_value(cache, entry), value, cache->value_size);
+        cache_touch(cache, entry);
+        return ERROR_NONE;
+    }
+
+    if (cache->size == cache->capacity)
+    {
+        entry = cache_victim(cache);
+        if (cache->evict != NULL)
+        {
+            cache->evict(cache_key(cache, entry), cache_value(cache, entry), cache->context);
+        }
+        cache_index_remove(cache, entry);
+        cache->counters.evictions++;
+    }
+    else
+    {
+        entry = cache->free_head;
+        cache->free_head = cache->next[entry];
+        cache->size++;
+    }
+
+    ccollection_copy(cache_key(cache, entry), key, cache->key_size);
+    ccollection_copy(cache_value(cache, entry), value, cache->value_size);
+    cache->hashes[entry] = hash;
+    cache_index_insert(cache, entry);
+    cache_admit(cache, entry);
+    cache->counters.insertions++;
+
+    return ERROR_NONE;
+}
+
+cerror_t cache_erase(cache_t* cache, const item_t* key)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(key != NULL, EBADPOINTER, ERROR_FAILED);
+
+    const uint32_t entry = cache_lookup(cache, key, cache_hash(key, cache->key_size));
+    ASSERT_E(entry != CACHE_NIL, ENOENT, ERROR_FAILED);
+
+    cache_release(cache, entry);
+
+    return ERROR_NONE;
+}
+
+cerror_t cache_clear(cache_t* cache)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, ERROR_FAILED);
+
+    cache_reset(cache);
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
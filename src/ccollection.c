@@ -35,6 +35,16 @@ const char* ccollection_strerror(int err)
             return "Bad pointer";
         case EOUTOFRANGE:
             return "Index out of range";
+        case EBADFORMAT:
+            return "Invalid data format";
+        case EREADONLY:
+            return "Container is read only";
+        case EEMPTY:
+            return "Container is empty";
+        case EBADHANDLE:
+            return "Invalid or stale handle";
+        case EFULL:
+            return "Container is full";
         default:
             return strerror(err);
     }
@@ -0,0 +1,309 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/concurrent_vector.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+EXTERN_C_BEGIN
+
+#define SEGMENT_BASE_BITS   5
+#define SEGMENT_BASE        ((size_t)1 << SEGMENT_BASE_BITS)        /** elements in the first segment */
+#define SEGMENT_COUNT       (64 - SEGMENT_BASE_BITS)                /** enough segments for any 64 bit index */
+
+/**
+ * concurrent vector data structure defenition. Segment k holds SEGMENT_BASE << k elements, so the first
+ * k segments hold SEGMENT_BASE * (2^k - 1) elements together.
+ *
+ * Every element has a ready flag which its appender sets with a release store once the element is written.
+ * Readers acquire the flag before they hand out the element, so they never see a slot that is not written
+ * yet, and no appender waits for another one.
+ */
+struct concurrent_vector_t
+{
+    size_t element_size;                        /** size of one element */
+    atomic_size_t size;                         /** number of reserved indices */
+    _Atomic(uint8_t*) segments[SEGMENT_COUNT];  /** segments allocated so far, NULL if not yet */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+/**
+ * number of elements in segment k
+ */
+static inline size_t segment_length(const size_t k)
+{
+    return SEGMENT_BASE << k;
+}
+
+/**
+ * index of the first element in segment k
+ */
+static inline size_t segment_first(const size_t k)
+{
+    return SEGMENT_BASE * (((size_t)1 << k) - 1);
+}
+
+/**
+ * segment holding index, offset receives the position of index inside it
+ */
+static inline size_t segment_of(const size_t index, size_t* offset)
+{
+    const size_t shifted = index + SEGMENT_BASE;
+    const size_t k = (63 - __builtin_clzll((unsigned long long)shifted)) - SEGMENT_BASE_BITS;
+
+    *offset = shifted - (SEGMENT_BASE << k);
+
+    return k;
+}
+
+/**
+ * get segment k, allocating it if no thread did yet. Threads racing to allocate the same segment agree on
+ * the first one published and free their own.
+ */
+static uint8_t* concurrent_vector_segment(concurrent_vector_t* vector, const size_t k)
+{
+    uint8_t *segment = atomic_load_explicit(&vector->segments[k], memory_order_acquire);
+    ASSERT(segment == NULL, segment);
+
+    // elements followed by their ready flags, all cleared
+    uint8_t *fresh = ccollection_calloc(segment_length(k) * (vector->element_size + sizeof(_Atomic uint8_t)));
+    ASSERT(fresh != NULL, NULL);
+
+    if (!atomic_compare_exchange_strong_explicit(&vector->segments[k], &segment, fresh,
+                memory_order_acq_rel, memory_order_acquire))
+    {
+        ccollection_free(fresh);
+        return segment;
+    }
+
+    return fresh;
+}
+
+/**
+ * ready flags of segment k, one byte per element stored right after its elements
+ */
+static inline _Atomic uint8_t* segment_ready(const concurrent_vector_t* vector, uint8_t* segment, const size_t k)
+{
+    return (_Atomic uint8_t*)(segment + segment_length(k) * vector->element_size);
+}
+
+/**
+ * move the iterator to the next segment, up to its first element that is not ready yet. Elements after
+ * such an element are not visited, so the iterator always walks a gap free prefix of the vector.
+ */
+static bool concurrent_vector_refill(iterator_t* iterator)
+{
+    const concurrent_vector_t *vector = iterator->container;
+    const size_t k = iterator->position + 1;
+
+    // the previous run stopped early at an element not ready yet
+    if (iterator->position != SIZE_MAX)
+    {
+        uint8_t *previous = atomic_load_explicit(&vector->segments[iterator->position], memory_order_relaxed);
+        ASSERT(iterator->end == previous + segment_length(iterator->position) * vector->element_size, false);
+    }
+
+    const size_t size = atomic_load_explicit(&vector->size, memory_order_relaxed);
+    ASSERT(k < SEGMENT_COUNT && segment_first(k) < size, false);
+
+    uint8_t *segment = atomic_load_explicit(&vector->segments[k], memory_order_acquire);
+    ASSERT(segment != NULL, false);
+
+    _Atomic uint8_t *ready = segment_ready(vector, segment, k);
+    const size_t limit = MIN(segment_length(k), size - segment_first(k));
+    size_t count = 0;
+    while (count < limit && atomic_load_explicit(&ready[count], memory_order_acquire) != 0)
+    {
+        count++;
+    }
+    ASSERT(count > 0, false);
+
+    iterator->current = segment;
+    iterator->end = segment + count * vector->element_size;
+    iterator->position = k;
+
+    return true;
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+concurrent_vector_t* concurrent_vector_new(const size_t elem_size)
+{
+    errno = 0;
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+
+    concurrent_vector_t *vector = ccollection_calloc(sizeof(concurrent_vector_t));
+    ASSERT(vector != NULL, NULL);
+
+    vector->element_size = elem_size;
+    atomic_init(&vector->size, 0);
+    for (size_t k = 0; k < SEGMENT_COUNT; k++)
+    {
+        atomic_init(&vector->segments[k], NULL);
+    }
+
+    return vector;
+}
+
+cerror_t concurrent_vector_destroy(concurrent_vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    for (size_t k = 0; k < SEGMENT_COUNT; k++)
+    {
+        uint8_t *segment = atomic_load_explicit(&vector->segments[k], memory_order_relaxed);
+        ccollection_free(segment);
+    }
+    ccollection_free(vector);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Capacity
+//==============================================================================
+size_t concurrent_vector_get_size(const concurrent_vector_t* vector)
+{
+    return atomic_load_explicit(&((concurrent_vector_t*)vector)->size, memory_order_acquire);
+}
+
+cerror_t concurrent_vector_reserve(concurrent_vector_t* vector, const size_t count)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    for (size_t k = 0; k < SEGMENT_COUNT && segment_first(k) < count; k++)
+    {
+        ASSERT(concurrent_vector_segment(vector, k) != NULL, ERROR_FAILED);
+    }
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+cerror_t concurrent_vector_push_back(concurrent_vector_t* vector, const item_t* item, size_t* index)
+{
+    return concurrent_vector_push_back_n(vector, item, 1, index);
+}
+
+cerror_t concurrent_vector_push_back_n(concurrent_vector_t* vector, const item_t* items, const size_t n,
+        size_t* index)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(items != NULL, EBADPOINTER, ERROR_FAILED);
+
+    size_t position = atomic_fetch_add_explicit(&vector->size, n, memory_order_relaxed);
+    if (index != NULL)
+    {
+        *index = position;
+    }
+
+    const uint8_t *source = items;
+    size_t remaining = n;
+    while (remaining > 0)
+    {
+        size_t offset;
+        const size_t k = segment_of(position, &offset);
+
+        // if this fails the indices left stay not ready, readers treat them as out of range
+        uint8_t *segment = concurrent_vector_segment(vector, k);
+        ASSERT(segment != NULL, ERROR_FAILED);
+
+        const size_t count = MIN(remaining, segment_length(k) - offset);
+        ccollection_copy(segment + offset * vector->element_size, source, count * vector->element_size);
+
+        _Atomic uint8_t *ready = segment_ready(vector, segment, k);
+        for (size_t i = 0; i < count; i++)
+        {
+            atomic_store_explicit(&ready[offset + i], 1, memory_order_release);
+        }
+
+        source += count * vector->element_size;
+        position += count;
+        remaining -= count;
+    }
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Elements access
+//==============================================================================
+cerror_t concurrent_vector_at(const concurrent_vector_t* vector, const size_t index, item_t* item)
+{
+    ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
+
+    const item_t *element = concurrent_vector_get(vector, index);
+    ASSERT(element != NULL, ERROR_FAILED);
+
+    ccollection_copy(item, element, vector->element_size);
+
+    return ERROR_NONE;
+}
+
+item_t* concurrent_vector_get(const concurrent_vector_t* vector, const size_t index)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+    ASSERT_E(index < concurrent_vector_get_size(vector), EOUTOFRANGE, NULL);
+
+    size_t offset;
+    const size_t k = segment_of(index, &offset);
+
+    uint8_t *segment = atomic_load_explicit(&((concurrent_vector_t*)vector)->segments[k], memory_order_acquire);
+    ASSERT_E(segment != NULL, EOUTOFRANGE, NULL);
+    ASSERT_E(atomic_load_explicit(&segment_ready(vector, segment, k)[offset], memory_order_acquire) != 0,
+            EOUTOFRANGE, NULL);
+
+    return segment + offset * vector->element_size;
+}
+
+cerror_t concurrent_vector_cbegin(const concurrent_vector_t* vector, iterator_t* iterator)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(iterator != NULL, EBADPOINTER, ERROR_FAILED);
+
+    iterator->current = NULL;
+    iterator->end = NULL;
+    iterator->stride = vector->element_size;
+    iterator->prefetch = 0;
+    iterator->refill = concurrent_vector_refill;
+    iterator->container = vector;
+    // refill moves to position + 1, which wraps around to the first segment
+    iterator->position = SIZE_MAX;
+
+    concurrent_vector_refill(iterator);
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
@@ -0,0 +1,69 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CPU_INTERNAL_H
+
+#define CPU_INTERNAL_H
+
+#include "include/ccollection-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// Runtime instruction set dispatch
+//==============================================================================
+
+/**
+ * CCOLLECTION_SIMD is defined when kernels for wider instruction sets can be compiled next to the baseline
+ * ones. They are marked with CCOLLECTION_TARGET so the rest of the library keeps the baseline instruction set,
+ * and picked at runtime with the ccollection_cpu_* checks. Building with CCOLLECTION_NO_SIMD leaves only the
+ * baseline kernels.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && \
+        !defined(CCOLLECTION_NO_SIMD)
+    #define CCOLLECTION_SIMD
+    #define CCOLLECTION_TARGET(isa)     __attribute__((target(isa)))
+
+    static inline bool ccollection_cpu_avx2(void)
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+
+    static inline bool ccollection_cpu_bmi2(void)
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("bmi2");
+    }
+
+    static inline bool ccollection_cpu_popcnt(void)
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("popcnt");
+    }
+#endif
+
+EXTERN_C_END
+
+#endif /* end of include guard: CPU_INTERNAL_H */
@@ -0,0 +1,295 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/ebr.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+EXTERN_C_BEGIN
+
+#define EBR_EPOCHS          3           /** memory retired in epoch e is freed once the global epoch is e + 2 */
+#define EBR_BATCH           64          /** retirements between two reclamation attempts */
+#define EBR_ACTIVE          1           /** low bit of a thread state, set inside critical regions */
+
+/**
+ * pointer waiting for reclamation
+ */
+typedef struct ebr_retired_t
+{
+    struct ebr_retired_t *next;         /** next pointer retired in the same epoch */
+    void *ptr;                          /** retired memory */
+    ebr_free_fn free_fn;                /** frees ptr */
+} ebr_retired_t;
+
+/**
+ * per thread record, linked into the domain and never freed before the domain is destroyed
+ */
+struct ebr_thread_t
+{
+    _Atomic uint64_t state;             /** epoch << 1 | EBR_ACTIVE inside a critical region, 0 outside */
+    atomic_bool in_use;                 /** record belongs to a registered thread */
+    ebr_t *ebr;                         /** domain the record belongs to */
+    ebr_thread_t *next;                 /** next record, immutable once the record is published */
+    unsigned nesting;                   /** depth of nested critical regions */
+    size_t pending;                     /** retirements since the last reclamation attempt */
+    ebr_retired_t *limbo[EBR_EPOCHS];   /** pointers retired per epoch modulo EBR_EPOCHS */
+    uint64_t limbo_epoch[EBR_EPOCHS];   /** epoch the pointers in limbo were retired in */
+};
+
+/**
+ * reclamation domain data structure defenition
+ */
+struct ebr_t
+{
+    _Atomic uint64_t epoch;             /** global epoch */
+    _Atomic(ebr_thread_t*) threads;     /** list of every record ever registered */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static void ebr_free_default(void* ptr)
+{
+    ccollection_free(ptr);
+}
+
+/**
+ * free every pointer on a limbo list, returns how many
+ */
+static size_t ebr_free_list(ebr_retired_t* retired)
+{
+    size_t freed = 0;
+
+    while (retired != NULL)
+    {
+        ebr_retired_t *next = retired->next;
+        retired->free_fn(retired->ptr);
+        ccollection_free(retired);
+        retired = next;
+        freed++;
+    }
+
+    return freed;
+}
+
+/**
+ * move the global epoch forward if every thread inside a critical region has seen the current one
+ */
+static void ebr_try_advance(ebr_t* ebr)
+{
+    uint64_t epoch = atomic_load_explicit(&ebr->epoch, memory_order_acquire);
+
+    atomic_thread_fence(memory_order_seq_cst);
+    for (ebr_thread_t *thread = atomic_load_explicit(&ebr->threads, memory_order_acquire); thread != NULL;
+            thread = thread->next)
+    {
+        const uint64_t state = atomic_load_explicit(&thread->state, memory_order_acquire);
+        if ((state & EBR_ACTIVE) && (state >> 1) != epoch)
+        {
+            return;
+        }
+    }
+
+    atomic_compare_exchange_strong_explicit(&ebr->epoch, &epoch, epoch + 1,
+            memory_order_acq_rel, memory_order_relaxed);
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+ebr_t* ebr_new(void)
+{
+    errno = 0;
+
+    ebr_t *ebr = ccollection_calloc(sizeof(ebr_t));
+    ASSERT(ebr != NULL, NULL);
+
+    atomic_init(&ebr->epoch, 0);
+    atomic_init(&ebr->threads, NULL);
+
+    return ebr;
+}
+
+cerror_t ebr_destroy(ebr_t* ebr)
+{
+    ASSERT_E(ebr != NULL, EBADPOINTER, ERROR_FAILED);
+
+    ebr_thread_t *thread = atomic_load_explicit(&ebr->threads, memory_order_acquire);
+    while (thread != NULL)
+    {
+        ebr_thread_t *next = thread->next;
+        for (int i = 0; i < EBR_EPOCHS; i++)
+        {
+            ebr_free_list(thread->limbo[i]);
+        }
+        ccollection_free(thread);
+        thread = next;
+    }
+    ccollection_free(ebr);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Threads
+//==============================================================================
+ebr_thread_t* ebr_register(ebr_t* ebr)
+{
+    errno = 0;
+    ASSERT_E(ebr != NULL, EBADPOINTER, NULL);
+
+    ebr_thread_t *thread;
+    for (thread = atomic_load_explicit(&ebr->threads, memory_order_acquire); thread != NULL;
+            thread = thread->next)
+    {
+        bool in_use = false;
+        if (atomic_compare_exchange_strong_explicit(&thread->in_use, &in_use, true,
+                    memory_order_acquire, memory_order_relaxed))
+        {
+            return thread;
+        }
+    }
+
+    thread = ccollection_calloc(sizeof(ebr_thread_t));
+    ASSERT(thread != NULL, NULL);
+
+    atomic_init(&thread->state, 0);
+    atomic_init(&thread->in_use, true);
+    thread->ebr = ebr;
+
+    ebr_thread_t *head = atomic_load_explicit(&ebr->threads, memory_order_relaxed);
+    do
+    {
+        thread->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&ebr->threads, &head, thread,
+                memory_order_release, memory_order_relaxed));
+
+    return thread;
+}
+
+cerror_t ebr_unregister(ebr_thread_t* thread)
+{
+    ASSERT_E(thread != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(thread->nesting == 0, EINVAL, ERROR_FAILED);
+
+    ebr_collect(thread);
+    atomic_store_explicit(&thread->in_use, false, memory_order_release);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Critical regions
+//==============================================================================
+cerror_t ebr_enter(ebr_thread_t* thread)
+{
+    ASSERT_E(thread != NULL, EBADPOINTER, ERROR_FAILED);
+
+    if (thread->nesting++ == 0)
+    {
+        const uint64_t epoch = atomic_load_explicit(&thread->ebr->epoch, memory_order_relaxed);
+        atomic_store_explicit(&thread->state, (epoch << 1) | EBR_ACTIVE, memory_order_relaxed);
+        // the announcement must be visible before any protected pointer is read
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+
+    return ERROR_NONE;
+}
+
+cerror_t ebr_exit(ebr_thread_t* thread)
+{
+    ASSERT_E(thread != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(thread->nesting > 0, EINVAL, ERROR_FAILED);
+
+    if (--thread->nesting == 0)
+    {
+        atomic_store_explicit(&thread->state, 0, memory_order_release);
+    }
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Reclamation
+//==============================================================================
+cerror_t ebr_retire(ebr_thread_t* thread, void* ptr, ebr_free_fn free_fn)
+{
+    ASSERT_E(thread != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(ptr != NULL, EBADPOINTER, ERROR_FAILED);
+
+    ebr_retired_t *retired = ccollection_calloc(sizeof(ebr_retired_t));
+    ASSERT(retired != NULL, ERROR_FAILED);
+
+    retired->ptr = ptr;
+    retired->free_fn = free_fn != NULL ? free_fn : ebr_free_default;
+
+    const uint64_t epoch = atomic_load_explicit(&thread->ebr->epoch, memory_order_acquire);
+    const int slot = epoch % EBR_EPOCHS;
+
+    // the slot still holds pointers from EBR_EPOCHS epochs ago or earlier, those are safe by now
+    if (thread->limbo[slot] != NULL && thread->limbo_epoch[slot] != epoch)
+    {
+        ebr_free_list(thread->limbo[slot]);
+        thread->limbo[slot] = NULL;
+    }
+    retired->next = thread->limbo[slot];
+    thread->limbo[slot] = retired;
+    thread->limbo_epoch[slot] = epoch;
+
+    if (++thread->pending >= EBR_BATCH)
+    {
+        ebr_collect(thread);
+    }
+
+    return ERROR_NONE;
+}
+
+size_t ebr_collect(ebr_thread_t* thread)
+{
+    ASSERT_E(thread != NULL, EBADPOINTER, 0);
+
+    ebr_try_advance(thread->ebr);
+    thread->pending = 0;
+
+    const uint64_t epoch = atomic_load_explicit(&thread->ebr->epoch, memory_order_acquire);
+    size_t freed = 0;
+
+    for (int i = 0; i < EBR_EPOCHS; i++)
+    {
+        if (thread->limbo[i] != NULL && thread->limbo_epoch[i] + 2 <= epoch)
+        {
+            freed += ebr_free_list(thread->limbo[i]);
+            thread->limbo[i] = NULL;
+        }
+    }
+
+    return freed;
+}
+
+EXTERN_C_END
@@ -0,0 +1,506 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/intvector.h"
+#include "src/vector-internal.h"
+#include "src/cpu-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#ifdef CCOLLECTION_SIMD
+    #include <immintrin.h>
+#endif
+
+EXTERN_C_BEGIN
+
+/** bytes readable past the packed data of the last block, extraction reads up to 9 bytes at a time */
+#define INTVECTOR_PADDING       16
+/** widest values the gather kernel extracts with one 64 bit load, shifts are at most 7 bits */
+#define INTVECTOR_GATHER_BITS   57
+
+/**
+ * how a block encodes its values
+ */
+typedef enum intvector_encoding_t
+{
+    INTVECTOR_FOR = 0,          /** value - base */
+    INTVECTOR_DELTA,            /** value - previous value, the first one is base */
+} intvector_encoding_t;
+
+/**
+ * header of one compressed block
+ */
+typedef struct intvector_block_t
+{
+    uint64_t base;              /** minimum for frame of reference, first value for delta */
+    uint64_t offset;            /** first byte of the packed values in data */
+    uint8_t bits;               /** width of one packed value */
+    uint8_t encoding;           /** intvector_encoding_t */
+} intvector_block_t;
+
+/**
+ * intvector data structure defenition. Block b holds values b * INTVECTOR_BLOCK_SIZE onwards, its packed values
+ * take INTVECTOR_BLOCK_SIZE * bits / 8 bytes. The data buffer keeps INTVECTOR_PADDING zero bytes after them.
+ */
+struct intvector_t
+{
+    vector_t *blocks;           /** intvector_block_t of every full block */
+    vector_t *data;             /** packed values, a vector of bytes */
+    uint64_t tail[INTVECTOR_BLOCK_SIZE];    /** values of the block being filled */
+    size_t tail_size;           /** number of values in tail */
+};
+
+/**
+ * unpacks the INTVECTOR_BLOCK_SIZE values of width bits at data and adds base to them
+ */
+typedef void (*intvector_unpack_fn)(const uint8_t* data, const unsigned bits, const uint64_t base, uint64_t* out);
+
+//==============================================================================
+// Bit packing
+//==============================================================================
+
+static inline unsigned intvector_width(const uint64_t value)
+{
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+static inline uint64_t intvector_mask(const unsigned bits)
+{
+    return bits == 64 ? ~UINT64_C(0) : (UINT64_C(1) << bits) - 1;
+}
+
+/**
+ * pack INTVECTOR_BLOCK_SIZE values of width bits into out as one little endian bit stream
+ */
+static void intvector_pack(const uint64_t* values, const unsigned bits, uint8_t* out)
+{
+    uint64_t word = 0;
+    unsigned filled = 0;
+
+    for (size_t i = 0; i < INTVECTOR_BLOCK_SIZE && bits > 0; i++)
+    {
+        const uint64_t value = values[i];
+
+        word |= value << filled;
+        if (filled + bits >= 64)
+        {
+            memcpy(out, &word, sizeof(word));
+            out += sizeof(word);
+            word = filled > 0 ? value >> (64 - filled) : 0;
+            filled = filled + bits - 64;
+        }
+        else
+        {
+            filled += bits;
+        }
+    }
+}
+
+/**
+ * extract value index of width bits from a packed stream
+ */
+static inline uint64_t intvector_extract(const uint8_t* data, const size_t index, const unsigned bits)
+{
+    const size_t bit = index * bits;
+    const uint8_t *p = data + bit / 8;
+    const unsigned shift = bit % 8;
+
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    value >>= shift;
+    if (shift + bits > 64)
+    {
+        value |= (uint64_t)p[8] << (64 - shift);
+    }
+
+    return value & intvector_mask(bits);
+}
+
+static void intvector_unpack_generic(const uint8_t* data, const unsigned bits, const uint64_t base, uint64_t* out)
+{
+    for (size_t i = 0; i < INTVECTOR_BLOCK_SIZE; i++)
+    {
+        out[i] = base + (bits > 0 ? intvector_extract(data, i, bits) : 0);
+    }
+}
+
+#ifdef CCOLLECTION_SIMD
+
+/**
+ * gather the 64 bit words holding four values at a time and shift them into place
+ */
+CCOLLECTION_TARGET("avx2")
+static void intvector_unpack_avx2(const uint8_t* data, const unsigned bits, const uint64_t base, uint64_t* out)
+{
+    if (bits == 0 || bits > INTVECTOR_GATHER_BITS)
+    {
+        intvector_unpack_generic(data, bits, base, out);
+        return;
+    }
+
+    const __m256i mask = _mm256_set1_epi64x(intvector_mask(bits));
+    const __m256i bases = _mm256_set1_epi64x(base);
+    const __m256i step = _mm256_set1_epi64x(4 * bits);
+    const __m256i seven = _mm256_set1_epi64x(7);
+    __m256i position = _mm256_setr_epi64x(0, bits, 2 * bits, 3 * bits);
+
+    for (size_t i = 0; i < INTVECTOR_BLOCK_SIZE; i += 4)
+    {
+        const __m256i words = _mm256_i64gather_epi64((const long long*)data, _mm256_srli_epi64(position, 3), 1);
+        const __m256i values = _mm256_and_si256(_mm256_srlv_epi64(words, _mm256_and_si256(position, seven)), mask);
+
+        _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi64(values, bases));
+        position = _mm256_add_epi64(position, step);
+    }
+}
+
+#endif
+
+static intvector_unpack_fn intvector_unpack = intvector_unpack_generic;
+static pthread_once_t intvector_unpack_once = PTHREAD_ONCE_INIT;
+
+static void intvector_select_unpack(void)
+{
+#ifdef CCOLLECTION_SIMD
+    if (ccollection_cpu_avx2())
+    {
+        intvector_unpack = intvector_unpack_avx2;
+    }
+#endif
+}
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static inline const intvector_block_t* intvector_block(const intvector_t* vector, const size_t block)
+{
+    return (const intvector_block_t*)VECTOR_ITEM(vector->blocks, block);
+}
+
+static inline size_t intvector_block_bytes(const unsigned bits)
+{
+    return INTVECTOR_BLOCK_SIZE * bits / 8;
+}
+
+/**
+ * encode the full tail as a new block
+ */
+static cerror_t intvector_flush(intvector_t* vector)
+{
+    uint64_t *values = vector->tail;
+    uint64_t deltas[INTVECTOR_BLOCK_SIZE];
+    uint64_t min = values[0], max = values[0];
+    uint64_t max_delta = 0;
+    bool sorted = true;
+
+    deltas[0] = 0;
+    for (size_t i = 1; i < INTVECTOR_BLOCK_SIZE; i++)
+    {
+        min = MIN(min, values[i]);
+        max = MAX(max, values[i]);
+        sorted = sorted && values[i] >= values[i - 1];
+        deltas[i] = values[i] - values[i - 1];
+        max_delta = MAX(max_delta, deltas[i]);
+    }
+
+    // delta only pays off if it is narrower, frame of reference has O(1) random access
+    intvector_block_t block;
+    block.offset = vector->data->size;
+    block.bits = intvector_width(max - min);
+    block.encoding = INTVECTOR_FOR;
+    block.base = min;
+    if (sorted && intvector_width(max_delta) < block.bits)
+    {
+        block.bits = intvector_width(max_delta);
+        block.encoding = INTVECTOR_DELTA;
+        block.base = values[0];
+    }
+    else
+    {
+        for (size_t i = 0; i < INTVECTOR_BLOCK_SIZE; i++)
+        {
+            deltas[i] = values[i] - min;
+        }
+    }
+
+    const size_t bytes = intvector_block_bytes(block.bits);
+    vector_t *data = vector->data;
+    if (data->size + bytes + INTVECTOR_PADDING > data->capacity)
+    {
+        ASSERT(vector_reserve(data, MAX(data->size + bytes + INTVECTOR_PADDING, data->capacity * 2)) == ERROR_NONE,
+                ERROR_FAILED);
+    }
+    ASSERT(vector_push_back(vector->blocks, &block) == ERROR_NONE, ERROR_FAILED);
+
+    intvector_pack(deltas, block.bits, VECTOR_ITEM(data, data->size));
+    data->size += bytes;
+    memset(VECTOR_ITEM(data, data->size), 0, INTVECTOR_PADDING);
+    vector->tail_size = 0;
+
+    return ERROR_NONE;
+}
+
+/**
+ * decode block into out
+ */
+static void intvector_decode_block(const intvector_t* vector, const size_t index, uint64_t* out)
+{
+    const intvector_block_t *block = intvector_block(vector, index);
+    const uint8_t *data = VECTOR_ITEM(vector->data, block->offset);
+
+    if (block->encoding == INTVECTOR_FOR)
+    {
+        intvector_unpack(data, block->bits, block->base, out);
+        return;
+    }
+
+    intvector_unpack(data, block->bits, 0, out);
+    out[0] = block->base;
+    for (size_t i = 1; i < INTVECTOR_BLOCK_SIZE; i++)
+    {
+        out[i] += out[i - 1];
+    }
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+intvector_t* intvector_new(void)
+{
+    errno = 0;
+    pthread_once(&intvector_unpack_once, intvector_select_unpack);
+
+    intvector_t *vector = ccollection_calloc(sizeof(intvector_t));
+    ASSERT(vector != NULL, NULL);
+
+    vector->blocks = vector_new(sizeof(intvector_block_t));
+    vector->data = vector_new(1);
+
+    if (vector->blocks == NULL || vector->data == NULL ||
+            vector_reserve(vector->data, INTVECTOR_PADDING) != ERROR_NONE)
+    {
+        intvector_destroy(vector);
+        return NULL;
+    }
+    memset(vector->data->items, 0, INTVECTOR_PADDING);
+
+    return vector;
+}
+
+intvector_t* intvector_from_vector(const vector_t* vector)
+{
+    errno = 0;
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+
+    const size_t element_size = vector->element_size;
+    ASSERT_E(element_size == 1 || element_size == 2 || element_size == 4 || element_size == 8,
+            EBADELEMSIZE, NULL);
+
+    intvector_t *result = intvector_new();
+    ASSERT(result != NULL, NULL);
+
+    for (size_t i = 0; i < vector->size; i++)
+    {
+        const uint8_t *item = VECTOR_ITEM(vector, i);
+        uint64_t value;
+
+        switch (element_size)
+        {
+            case 1:
+                value = *item;
+                break;
+            case 2:
+                value = *(const uint16_t*)item;
+                break;
+            case 4:
+                value = *(const uint32_t*)item;
+                break;
+            default:
+                value = *(const uint64_t*)item;
+                break;
+        }
+        if (intvector_push_back(result, value) != ERROR_NONE)
+        {
+            intvector_destroy(result);
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+cerror_t intvector_destroy(intvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    if (vector->blocks != NULL)
+        vector_destroy(vector->blocks);
+    if (vector->data != NULL)
+        vector_destroy(vector->data);
+    ccollection_free(vector);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Capacity
+//==============================================================================
+size_t intvector_get_size(const intvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, 0);
+
+    return vector->blocks->size * INTVECTOR_BLOCK_SIZE + vector->tail_size;
+}
+
+size_t intvector_get_memory(const intvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, 0);
+
+    return sizeof(intvector_t) + vector->blocks->size * sizeof(intvector_block_t) + vector->data->size;
+}
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+cerror_t intvector_push_back(intvector_t* vector, const uint64_t value)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector->tail[vector->tail_size++] = value;
+    if (vector->tail_size == INTVECTOR_BLOCK_SIZE && intvector_flush(vector) != ERROR_NONE)
+    {
+        vector->tail_size--;
+        return ERROR_FAILED;
+    }
+
+    return ERROR_NONE;
+}
+
+cerror_t intvector_push_back_n(intvector_t* vector, const uint64_t* values, const size_t n)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(values != NULL || n == 0, EBADPOINTER, ERROR_FAILED);
+
+    for (size_t i = 0; i < n; )
+    {
+        const size_t count = MIN(n - i, INTVECTOR_BLOCK_SIZE - vector->tail_size);
+
+        ccollection_copy(vector->tail + vector->tail_size, values + i, count * sizeof(uint64_t));
+        vector->tail_size += count;
+        if (vector->tail_size == INTVECTOR_BLOCK_SIZE && intvector_flush(vector) != ERROR_NONE)
+        {
+            vector->tail_size -= count;
+            return ERROR_FAILED;
+        }
+        i += count;
+    }
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Element access
+//==============================================================================
+cerror_t intvector_at(const intvector_t* vector, const size_t index, uint64_t* value)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(value != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(index < intvector_get_size(vector), EOUTOFRANGE, ERROR_FAILED);
+
+    const size_t block_index = index / INTVECTOR_BLOCK_SIZE;
+    const size_t position = index % INTVECTOR_BLOCK_SIZE;
+
+    if (block_index == vector->blocks->size)
+    {
+        *value = vector->tail[position];
+        return ERROR_NONE;
+    }
+
+    const intvector_block_t *block = intvector_block(vector, block_index);
+    const uint8_t *data = VECTOR_ITEM(vector->data, block->offset);
+
+    if (block->bits == 0)
+    {
+        *value = block->base;
+    }
+    else if (block->encoding == INTVECTOR_FOR)
+    {
+        *value = block->base + intvector_extract(data, position, block->bits);
+    }
+    else
+    {
+        uint64_t sum = block->base;
+        for (size_t i = 1; i <= position; i++)
+        {
+            sum += intvector_extract(data, i, block->bits);
+        }
+        *value = sum;
+    }
+
+    return ERROR_NONE;
+}
+
+cerror_t intvector_decode(const intvector_t* vector, const size_t start, const size_t count, uint64_t* values)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(values != NULL || count == 0, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(start + count >= start && start + count <= intvector_get_size(vector), EOUTOFRANGE, ERROR_FAILED);
+
+    uint64_t buffer[INTVECTOR_BLOCK_SIZE];
+    size_t index = start;
+    const size_t end = start + count;
+
+    while (index < end)
+    {
+        const size_t block = index / INTVECTOR_BLOCK_SIZE;
+        const size_t position = index % INTVECTOR_BLOCK_SIZE;
+        const size_t n = MIN(end - index, INTVECTOR_BLOCK_SIZE - position);
+
+        if (block == vector->blocks->size)
+        {
+            ccollection_copy(values, vector->tail + position, n * sizeof(uint64_t));
+        }
+        else if (n == INTVECTOR_BLOCK_SIZE)
+        {
+            // whole blocks are decoded straight into the output
+            intvector_decode_block(vector, block, values);
+        }
+        else
+        {
+            intvector_decode_block(vector, block, buffer);
+            ccollection_copy(values, buffer + position, n * sizeof(uint64_t));
+        }
+        values += n;
+        index += n;
+    }
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
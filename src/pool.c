@@ -0,0 +1,374 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+
+EXTERN_C_BEGIN
+
+#define POOL_SLAB_MIN_SLOTS     64
+#define POOL_SLAB_MAX_SIZE      (1 << 20)
+#define POOL_CACHE_BATCH        32
+
+/**
+ * free slot, the link overlays the element
+ */
+typedef struct pool_slot_t
+{
+    struct pool_slot_t *next;
+} pool_slot_t;
+
+/**
+ * block of slots allocated at once
+ */
+typedef struct pool_slab_t
+{
+    struct pool_slab_t *next;   /** previously allocated slab */
+    max_align_t items[];        /** slots */
+} pool_slab_t;
+
+/**
+ * pool data structure defenition. Slots of the newest slab are carved lazily from bump, released slots go to
+ * free_list.
+ */
+struct pool_t
+{
+    pthread_mutex_t lock;       /** protects every field below */
+    pool_slot_t *free_list;     /** released slots */
+    uint8_t *bump;              /** next never used slot of the newest slab */
+    uint8_t *bump_end;          /** end of the newest slab */
+    pool_slab_t *slabs;         /** all slabs, newest first */
+    size_t slot_size;           /** element size rounded up to hold a link and keep slots aligned */
+    size_t slab_slots;          /** slots in the next slab */
+    size_t size;                /** slots taken */
+    size_t capacity;            /** slots in all slabs */
+};
+
+/**
+ * per thread cache data structure defenition
+ */
+struct pool_cache_t
+{
+    pool_t *pool;               /** pool the slots belong to */
+    pool_slot_t *free_list;     /** free slots owned by the cache */
+    size_t count;               /** slots on free_list */
+    size_t batch;               /** slots moved from or to the pool at once */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+/**
+ * round elem_size up to a power of 2 up to the alignment of malloc, and to a multiple of it beyond
+ */
+static size_t pool_slot_size(const size_t elem_size)
+{
+    const size_t align = _Alignof(max_align_t);
+    size_t size = MAX(elem_size, sizeof(pool_slot_t));
+
+    if (size >= align)
+    {
+        return (size + align - 1) & ~(align - 1);
+    }
+
+    size_t slot = sizeof(pool_slot_t);
+    while (slot < size)
+    {
+        slot <<= 1;
+    }
+    return slot;
+}
+
+static cerror_t pool_grow(pool_t* pool)
+{
+    const size_t size = pool->slab_slots * pool->slot_size;
+
+    pool_slab_t *slab = ccollection_calloc(sizeof(pool_slab_t) + size);
+    ASSERT_E(slab != NULL, ENOMEM, ERROR_FAILED);
+
+    // callers carve the rest of the newest slab first, bump moves on to the new one
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->bump = (uint8_t*)slab->items;
+    pool->bump_end = pool->bump + size;
+    pool->capacity += pool->slab_slots;
+
+    if (size * 2 <= POOL_SLAB_MAX_SIZE)
+    {
+        pool->slab_slots *= 2;
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * take a slot with the lock held
+ */
+static inline pool_slot_t* pool_take(pool_t* pool)
+{
+    pool_slot_t *slot = pool->free_list;
+
+    if (ccollection_likely(slot != NULL))
+    {
+        pool->free_list = slot->next;
+    }
+    else
+    {
+        if (pool->bump == pool->bump_end)
+        {
+            ASSERT(pool_grow(pool) == ERROR_NONE, NULL);
+        }
+        slot = (pool_slot_t*)pool->bump;
+        pool->bump += pool->slot_size;
+    }
+    pool->size++;
+
+    return slot;
+}
+
+/**
+ * give a slot back with the lock held
+ */
+static inline void pool_give(pool_t* pool, pool_slot_t* slot)
+{
+    slot->next = pool->free_list;
+    pool->free_list = slot;
+    pool->size--;
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+pool_t* pool_new(const size_t elem_size)
+{
+    errno = 0;
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+
+    pool_t *pool = ccollection_calloc(sizeof(pool_t));
+    ASSERT(pool != NULL, NULL);
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pool->slot_size = pool_slot_size(elem_size);
+    pool->slab_slots = MAX(POOL_SLAB_MIN_SLOTS, 4096 / pool->slot_size);
+
+    return pool;
+}
+
+cerror_t pool_destroy(pool_t* pool)
+{
+    ASSERT_E(pool != NULL, EBADPOINTER, ERROR_FAILED);
+
+    pool_slab_t *slab = pool->slabs;
+    while (slab != NULL)
+    {
+        pool_slab_t *next = slab->next;
+        ccollection_free(slab);
+        slab = next;
+    }
+    pthread_mutex_destroy(&pool->lock);
+    ccollection_free(pool);
+
+    return ERROR_NONE;
+}
+
+pool_cache_t* pool_cache_new(pool_t* pool, const size_t batch)
+{
+    errno = 0;
+    ASSERT_E(pool != NULL, EBADPOINTER, NULL);
+
+    pool_cache_t *cache = ccollection_calloc(sizeof(pool_cache_t));
+    ASSERT(cache != NULL, NULL);
+
+    cache->pool = pool;
+    cache->batch = batch > 0 ? batch : POOL_CACHE_BATCH;
+
+    return cache;
+}
+
+cerror_t pool_cache_destroy(pool_cache_t* cache)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, ERROR_FAILED);
+
+    pool_t *pool = cache->pool;
+
+    pthread_mutex_lock(&pool->lock);
+    while (cache->free_list != NULL)
+    {
+        pool_slot_t *slot = cache->free_list;
+        cache->free_list = slot->next;
+        pool_give(pool, slot);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    ccollection_free(cache);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Capacity
+//==============================================================================
+size_t pool_get_size(pool_t* pool)
+{
+    ASSERT_E(pool != NULL, EBADPOINTER, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    size_t size = pool->size;
+    pthread_mutex_unlock(&pool->lock);
+
+    return size;
+}
+
+size_t pool_get_capacity(pool_t* pool)
+{
+    ASSERT_E(pool != NULL, EBADPOINTER, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    size_t capacity = pool->capacity;
+    pthread_mutex_unlock(&pool->lock);
+
+    return capacity;
+}
+
+cerror_t pool_reserve(pool_t* pool, const size_t count)
+{
+    ASSERT_E(pool != NULL, EBADPOINTER, ERROR_FAILED);
+
+    cerror_t err = ERROR_NONE;
+
+    pthread_mutex_lock(&pool->lock);
+    // the reserving slab is a one off, later slabs keep growing from the size they were at
+    const size_t slab_slots = pool->slab_slots;
+    while (pool->capacity < count && err == ERROR_NONE)
+    {
+        // carve the rest of the current slab first, pool_grow drops it
+        while (pool->bump != pool->bump_end)
+        {
+            pool_slot_t *slot = (pool_slot_t*)pool->bump;
+            pool->bump += pool->slot_size;
+            slot->next = pool->free_list;
+            pool->free_list = slot;
+        }
+        pool->slab_slots = MAX(slab_slots, count - pool->capacity);
+        err = pool_grow(pool);
+    }
+    pool->slab_slots = slab_slots;
+    pthread_mutex_unlock(&pool->lock);
+
+    return err;
+}
+
+//==============================================================================
+// Allocation
+//==============================================================================
+item_t* pool_acquire(pool_t* pool)
+{
+    ASSERT_E(pool != NULL, EBADPOINTER, NULL);
+
+    pthread_mutex_lock(&pool->lock);
+    pool_slot_t *slot = pool_take(pool);
+    pthread_mutex_unlock(&pool->lock);
+
+    return slot;
+}
+
+cerror_t pool_release(pool_t* pool, item_t* item)
+{
+    ASSERT_E(pool != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
+
+    pthread_mutex_lock(&pool->lock);
+    pool_give(pool, item);
+    pthread_mutex_unlock(&pool->lock);
+
+    return ERROR_NONE;
+}
+
+item_t* pool_cache_acquire(pool_cache_t* cache)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, NULL);
+
+    if (ccollection_unlikely(cache->free_list == NULL))
+    {
+        pool_t *pool = cache->pool;
+
+        pthread_mutex_lock(&pool->lock);
+        for (size_t i = 0; i < cache->batch; i++)
+        {
+            pool_slot_t *slot = pool_take(pool);
+            if (slot == NULL)
+            {
+                break;
+            }
+            slot->next = cache->free_list;
+            cache->free_list = slot;
+            cache->count++;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        ASSERT(cache->free_list != NULL, NULL);
+    }
+
+    pool_slot_t *slot = cache->free_list;
+    cache->free_list = slot->next;
+    cache->count--;
+
+    return slot;
+}
+
+cerror_t pool_cache_release(pool_cache_t* cache, item_t* item)
+{
+    ASSERT_E(cache != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
+
+    pool_slot_t *slot = item;
+    slot->next = cache->free_list;
+    cache->free_list = slot;
+    cache->count++;
+
+    // keep one batch so a thread alternating around the limit does not bounce slots through the lock
+    if (ccollection_unlikely(cache->count >= 2 * cache->batch))
+    {
+        pool_t *pool = cache->pool;
+
+        pthread_mutex_lock(&pool->lock);
+        for (size_t i = 0; i < cache->batch; i++)
+        {
+            slot = cache->free_list;
+            cache->free_list = slot->next;
+            pool_give(pool, slot);
+        }
+        pthread_mutex_unlock(&pool->lock);
+        cache->count -= cache->batch;
+    }
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
@@ -0,0 +1,338 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/slot_map.h"
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+#define SLOT_MAP_MAX_SLOTS  UINT32_MAX
+#define SLOT_MAP_FREE_END   UINT32_MAX
+
+#define SLOT_HANDLE_INDEX(handle)       ((uint32_t)(handle))
+#define SLOT_HANDLE_GENERATION(handle)  ((uint32_t)((handle) >> 32))
+#define SLOT_HANDLE(index, generation)  (((slot_handle_t)(generation) << 32) | (index))
+
+/**
+ * entry of the indirection table. The generation is odd while the slot holds an element and even while it
+ * is free, so the null handle (slot 0, generation 0) never matches.
+ */
+typedef struct slot_map_slot_t
+{
+    uint32_t index;             /** position in the dense array, or next free slot */
+    uint32_t generation;        /** incremented on every insert and erase */
+} slot_map_slot_t;
+
+/**
+ * slot map data structure defenition. owners[i] is the slot of dense element i, it lets erase fix the slot
+ * of the element it moves.
+ */
+struct slot_map_t
+{
+    vector_t *dense;            /** elements */
+    vector_t *owners;           /** uint32_t slot of each element */
+    vector_t *slots;            /** slot_map_slot_t indirection table */
+    uint32_t free_head;         /** first free slot, SLOT_MAP_FREE_END if none */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static inline slot_map_slot_t* slot_map_slot(const slot_map_t* map, const uint32_t index)
+{
+    return (slot_map_slot_t*)VECTOR_ITEM(map->slots, index);
+}
+
+static inline uint32_t* slot_map_owner(const slot_map_t* map, const size_t position)
+{
+    return (uint32_t*)VECTOR_ITEM(map->owners, position);
+}
+
+/**
+ * chain a slot insert appended to the table into the free list after a failed insert, a slot taken from the
+ * free list is still its head
+ */
+static inline void slot_map_keep_free(slot_map_t* map, const uint32_t index)
+{
+    if (index != map->free_head)
+    {
+        slot_map_slot(map, index)->index = map->free_head;
+        map->free_head = index;
+    }
+}
+
+/**
+ * returns the slot of handle or NULL if the handle is stale
+ */
+static inline slot_map_slot_t* slot_map_lookup(const slot_map_t* map, const slot_handle_t handle)
+{
+    const uint32_t index = SLOT_HANDLE_INDEX(handle);
+    ASSERT(index < map->slots->size, NULL);
+
+    slot_map_slot_t *slot = slot_map_slot(map, index);
+    ASSERT(slot->generation == SLOT_HANDLE_GENERATION(handle) && (slot->generation & 1), NULL);
+
+    return slot;
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+slot_map_t* slot_map_new(const size_t elem_size)
+{
+    errno = 0;
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+
+    slot_map_t *map = ccollection_calloc(sizeof(slot_map_t));
+    ASSERT(map != NULL, NULL);
+
+    map->dense = vector_new(elem_size);
+    map->owners = vector_new(sizeof(uint32_t));
+    map->slots = vector_new(sizeof(slot_map_slot_t));
+    map->free_head = SLOT_MAP_FREE_END;
+
+    if (map->dense == NULL || map->owners == NULL || map->slots == NULL)
+    {
+        slot_map_destroy(map);
+        return NULL;
+    }
+
+    return map;
+}
+
+cerror_t slot_map_destroy(slot_map_t* map)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, ERROR_FAILED);
+
+    if (map->dense != NULL)
+        vector_destroy(map->dense);
+    if (map->owners != NULL)
+        vector_destroy(map->owners);
+    if (map->slots != NULL)
+        vector_destroy(map->slots);
+    ccollection_free(map);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Capacity
+//==============================================================================
+cerror_t slot_map_reserve(slot_map_t* map, const size_t count)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(count <= SLOT_MAP_MAX_SLOTS, EINVAL, ERROR_FAILED);
+
+    ASSERT(vector_reserve(map->dense, count) == ERROR_NONE, ERROR_FAILED);
+    ASSERT(vector_reserve(map->owners, count) == ERROR_NONE, ERROR_FAILED);
+    return vector_reserve(map->slots, count);
+}
+
+size_t slot_map_get_size(const slot_map_t* map)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, 0);
+
+    return map->dense->size;
+}
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+cerror_t slot_map_insert(slot_map_t* map, const item_t* item, slot_handle_t* handle)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(handle != NULL, EBADPOINTER, ERROR_FAILED);
+
+    uint32_t index = map->free_head;
+    if (index == SLOT_MAP_FREE_END)
+    {
+        ASSERT_E(map->slots->size < SLOT_MAP_MAX_SLOTS, ERANGE, ERROR_FAILED);
+
+        slot_map_slot_t slot = { SLOT_MAP_FREE_END, 0 };
+        ASSERT(vector_push_back(map->slots, &slot) == ERROR_NONE, ERROR_FAILED);
+        index = map->slots->size - 1;
+    }
+
+    // a new slot stays at the end of the table as a free slot if pushing the element fails
+    if (vector_push_back(map->owners, &index) != ERROR_NONE)
+    {
+        slot_map_keep_free(map, index);
+        return ERROR_FAILED;
+    }
+    if (vector_push_back(map->dense, item) != ERROR_NONE)
+    {
+        vector_pop_back(map->owners);
+        slot_map_keep_free(map, index);
+        return ERROR_FAILED;
+    }
+
+    slot_map_slot_t *slot = slot_map_slot(map, index);
+    if (index == map->free_head)
+    {
+        map->free_head = slot->index;
+    }
+    slot->index = map->dense->size - 1;
+    slot->generation++;
+
+    *handle = SLOT_HANDLE(index, slot->generation);
+
+    return ERROR_NONE;
+}
+
+cerror_t slot_map_erase(slot_map_t* map, const slot_handle_t handle)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, ERROR_FAILED);
+
+    slot_map_slot_t *slot = slot_map_lookup(map, handle);
+    ASSERT_E(slot != NULL, EBADHANDLE, ERROR_FAILED);
+
+    // move the last element into the hole and point its slot at the new position
+    const size_t position = slot->index;
+    const size_t last = map->dense->size - 1;
+    if (position != last)
+    {
+        ccollection_copy(VECTOR_ITEM(map->dense, position), VECTOR_ITEM(map->dense, last),
+                map->dense->element_size);
+
+        const uint32_t owner = *slot_map_owner(map, last);
+        *slot_map_owner(map, position) = owner;
+        slot_map_slot(map, owner)->index = position;
+    }
+
+    slot->generation++;
+    slot->index = map->free_head;
+    map->free_head = SLOT_HANDLE_INDEX(handle);
+
+    ASSERT(vector_pop_back(map->dense) == ERROR_NONE, ERROR_FAILED);
+    return vector_pop_back(map->owners);
+}
+
+cerror_t slot_map_clear(slot_map_t* map)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, ERROR_FAILED);
+
+    // keep the table so generations keep increasing, and chain every occupied slot into the free list
+    for (size_t i = 0; i < map->dense->size; i++)
+    {
+        const uint32_t owner = *slot_map_owner(map, i);
+        slot_map_slot_t *slot = slot_map_slot(map, owner);
+
+        slot->generation++;
+        slot->index = map->free_head;
+        map->free_head = owner;
+    }
+
+    ASSERT(vector_clear(map->dense) == ERROR_NONE, ERROR_FAILED);
+    return vector_clear(map->owners);
+}
+
+//==============================================================================
+// Element access
+//==============================================================================
+bool slot_map_contains(const slot_map_t* map, const slot_handle_t handle)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, false);
+
+    return slot_map_lookup(map, handle) != NULL;
+}
+
+cerror_t slot_map_at(const slot_map_t* map, const slot_handle_t handle, item_t* item)
+{
+    ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
+
+    const item_t *element = slot_map_get(map, handle);
+    ASSERT(element != NULL, ERROR_FAILED);
+
+    ccollection_copy(item, element, map->dense->element_size);
+
+    return ERROR_NONE;
+}
+
+item_t* slot_map_get(const slot_map_t* map, const slot_handle_t handle)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, NULL);
+
+    const slot_map_slot_t *slot = slot_map_lookup(map, handle);
+    ASSERT_E(slot != NULL, EBADHANDLE, NULL);
+
+    return VECTOR_ITEM(map->dense, slot->index);
+}
+
+slot_handle_t slot_map_handle_at(const slot_map_t* map, const size_t position)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, SLOT_HANDLE_NULL);
+    ASSERT_E(position < map->dense->size, EOUTOFRANGE, SLOT_HANDLE_NULL);
+
+    const uint32_t owner = *slot_map_owner(map, position);
+
+    return SLOT_HANDLE(owner, slot_map_slot(map, owner)->generation);
+}
+
+slot_handle_t slot_map_handle_of(const slot_map_t* map, const item_t* element)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, SLOT_HANDLE_NULL);
+    ASSERT_E((const uint8_t*)element >= map->dense->items, EOUTOFRANGE, SLOT_HANDLE_NULL);
+
+    return slot_map_handle_at(map, ((const uint8_t*)element - map->dense->items) / map->dense->stride);
+}
+
+item_t* slot_map_data(slot_map_t* map)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, NULL);
+
+    return vector_data(map->dense);
+}
+
+const item_t* slot_map_cdata(const slot_map_t* map)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, NULL);
+
+    return vector_cdata(map->dense);
+}
+
+//==============================================================================
+// Iterators
+//==============================================================================
+cerror_t slot_map_begin(slot_map_t* map, iterator_t* iterator)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, ERROR_FAILED);
+
+    return vector_begin(map->dense, iterator);
+}
+
+cerror_t slot_map_cbegin(const slot_map_t* map, iterator_t* iterator)
+{
+    ASSERT_E(map != NULL, EBADPOINTER, ERROR_FAILED);
+
+    return vector_cbegin(map->dense, iterator);
+}
+
+EXTERN_C_END
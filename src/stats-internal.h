@@ -0,0 +1,82 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef STATS_INTERNAL_H
+
+#define STATS_INTERNAL_H
+
+#include "include/stats.h"
+
+EXTERN_C_BEGIN
+
+#ifdef CCOLLECTION_STATS
+
+/**
+ * statistics embedded in every container, linked into the registry of live containers
+ */
+typedef struct stats_entry_t
+{
+    struct stats_entry_t *prev; /** previous live container */
+    struct stats_entry_t *next; /** next live container */
+    const char *type;           /** container type name */
+    const void *container;      /** container owning this entry */
+    ccollection_stats_t counters;
+} stats_entry_t;
+
+/** counters summed over all containers */
+extern ccollection_stats_t stats_global;
+
+/**
+ * link a zeroed entry into the registry, counters collected before registration are kept
+ */
+void stats_register(stats_entry_t* entry, const char* type, const void* container);
+void stats_unregister(stats_entry_t* entry);
+void stats_peak(size_t* global, const size_t value);
+
+    #define STATS_ENTRY                             stats_entry_t stats;
+    #define STATS_REGISTER(owner, type)             stats_register(&(owner)->stats, type, owner)
+    #define STATS_UNREGISTER(owner)                 stats_unregister(&(owner)->stats)
+    #define STATS_COUNT(owner, field, n)                                                    \
+        do {                                                                                \
+            (owner)->stats.counters.field += (n);                                           \
+            __atomic_fetch_add(&stats_global.field, (n), __ATOMIC_RELAXED);                 \
+        } while (0)
+    #define STATS_PEAK(owner, field, value)                                                 \
+        do {                                                                                \
+            if ((value) > (owner)->stats.counters.field) {                                  \
+                (owner)->stats.counters.field = (value);                                    \
+                stats_peak(&stats_global.field, (value));                                   \
+            }                                                                               \
+        } while (0)
+#else
+    #define STATS_ENTRY
+    #define STATS_REGISTER(owner, type)
+    #define STATS_UNREGISTER(owner)
+    #define STATS_COUNT(owner, field, n)
+    #define STATS_PEAK(owner, field, value)
+#endif
+
+EXTERN_C_END
+
+#endif /* end of include guard: STATS_INTERNAL_H */
@@ -0,0 +1,164 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "src/stats-internal.h"
+
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#ifdef CCOLLECTION_STATS
+#include <pthread.h>
+#endif
+
+EXTERN_C_BEGIN
+
+#ifdef CCOLLECTION_STATS
+
+ccollection_stats_t stats_global;
+
+/** registry of live containers, a circular list around this sentinel */
+static stats_entry_t stats_registry = { &stats_registry, &stats_registry, NULL, NULL, { 0 } };
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+void stats_register(stats_entry_t* entry, const char* type, const void* container)
+{
+    entry->type = type;
+    entry->container = container;
+
+    pthread_mutex_lock(&stats_lock);
+    entry->prev = stats_registry.prev;
+    entry->next = &stats_registry;
+    stats_registry.prev->next = entry;
+    stats_registry.prev = entry;
+    pthread_mutex_unlock(&stats_lock);
+}
+
+void stats_unregister(stats_entry_t* entry)
+{
+    pthread_mutex_lock(&stats_lock);
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+    pthread_mutex_unlock(&stats_lock);
+
+    entry->prev = entry->next = NULL;
+}
+
+void stats_peak(size_t* global, const size_t value)
+{
+    size_t current = __atomic_load_n(global, __ATOMIC_RELAXED);
+
+    while (value > current &&
+            !__atomic_compare_exchange_n(global, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+static void stats_print(FILE* file, const char* type, const void* container, const ccollection_stats_t* stats)
+{
+    fprintf(file, "%s %p allocations=%" PRIu64 " reallocations=%" PRIu64 " shrinks=%" PRIu64
+            " bytes_moved=%" PRIu64 " peak_size=%zu peak_capacity=%zu\n",
+            type, container, stats->allocations, stats->reallocations, stats->shrinks,
+            stats->bytes_moved, stats->peak_size, stats->peak_capacity);
+}
+
+static void stats_print_entry(const char* type, const void* container, const ccollection_stats_t* stats,
+        void* context)
+{
+    stats_print(context, type, container, stats);
+}
+
+//==============================================================================
+// Container statistics
+//==============================================================================
+cerror_t ccollection_stats_global(ccollection_stats_t* stats)
+{
+    ASSERT_E(stats != NULL, EBADPOINTER, ERROR_FAILED);
+
+    stats->allocations = __atomic_load_n(&stats_global.allocations, __ATOMIC_RELAXED);
+    stats->reallocations = __atomic_load_n(&stats_global.reallocations, __ATOMIC_RELAXED);
+    stats->shrinks = __atomic_load_n(&stats_global.shrinks, __ATOMIC_RELAXED);
+    stats->bytes_moved = __atomic_load_n(&stats_global.bytes_moved, __ATOMIC_RELAXED);
+    stats->peak_size = __atomic_load_n(&stats_global.peak_size, __ATOMIC_RELAXED);
+    stats->peak_capacity = __atomic_load_n(&stats_global.peak_capacity, __ATOMIC_RELAXED);
+
+    return ERROR_NONE;
+}
+
+cerror_t ccollection_stats_foreach(ccollection_stats_fn fn, void* context)
+{
+    ASSERT_E(fn != NULL, EBADPOINTER, ERROR_FAILED);
+
+    pthread_mutex_lock(&stats_lock);
+    for (stats_entry_t *entry = stats_registry.next; entry != &stats_registry; entry = entry->next)
+    {
+        ccollection_stats_t counters = entry->counters;
+        fn(entry->type, entry->container, &counters, context);
+    }
+    pthread_mutex_unlock(&stats_lock);
+
+    return ERROR_NONE;
+}
+
+cerror_t ccollection_stats_dump(FILE* file)
+{
+    ASSERT_E(file != NULL, EBADPOINTER, ERROR_FAILED);
+
+    ccollection_stats_t global;
+    ccollection_stats_global(&global);
+    stats_print(file, "global", NULL, &global);
+
+    return ccollection_stats_foreach(stats_print_entry, file);
+}
+
+#else
+
+cerror_t ccollection_stats_global(ccollection_stats_t* stats)
+{
+    (void)stats;
+    errno = ENOTSUP;
+    return ERROR_FAILED;
+}
+
+cerror_t ccollection_stats_foreach(ccollection_stats_fn fn, void* context)
+{
+    (void)fn;
+    (void)context;
+    errno = ENOTSUP;
+    return ERROR_FAILED;
+}
+
+cerror_t ccollection_stats_dump(FILE* file)
+{
+    (void)file;
+    errno = ENOTSUP;
+    return ERROR_FAILED;
+}
+
+#endif
+
+EXTERN_C_END
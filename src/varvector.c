@@ -0,0 +1,361 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/varvector.h"
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+#define VARVECTOR_COMPACT_MIN   4096
+
+/**
+ * varvector data structure defenition. Both arrays are vector_t, the arena is a vector of bytes whose size
+ * is the number of arena bytes in use.
+ */
+struct varvector_t
+{
+    vector_t *spans;            /** varvector_span_t of every element */
+    vector_t *arena;            /** payload bytes */
+    size_t bytes;               /** payload bytes of all elements, the rest of the arena is garbage */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static inline varvector_span_t* varvector_span(const varvector_t* vector, const size_t index)
+{
+    return (varvector_span_t*)VECTOR_ITEM(vector->spans, index);
+}
+
+/**
+ * make room for length more bytes at the end of the arena, doubling it like vector_push_back does. *data may
+ * point into the arena, e.g. to copy an element, it is moved along if the arena is reallocated.
+ */
+static cerror_t varvector_arena_reserve(varvector_t* vector, const void** data, const size_t length)
+{
+    vector_t *arena = vector->arena;
+    const size_t needed = arena->size + length;
+
+    if (needed > arena->capacity)
+    {
+        const uint8_t *source = *data;
+        const bool inside = source >= arena->items && source < arena->items + arena->size;
+        const size_t position = inside ? (size_t)(source - arena->items) : 0;
+
+        ASSERT(vector_reserve(arena, MAX(needed, arena->capacity * 2)) == ERROR_NONE, ERROR_FAILED);
+        if (inside)
+        {
+            *data = VECTOR_ITEM(arena, position);
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * copy length bytes to the end of the arena and return their offset, the arena must have room
+ */
+static inline uint64_t varvector_arena_append(varvector_t* vector, const void* data, const size_t length)
+{
+    vector_t *arena = vector->arena;
+    const uint64_t offset = arena->size;
+
+    if (length > 0)
+    {
+        ccollection_copy(VECTOR_ITEM(arena, offset), data, length);
+    }
+    arena->size += length;
+
+    return offset;
+}
+
+/**
+ * compact once garbage outweighs payload, so the arena stays within twice the payload
+ */
+static cerror_t varvector_collect(varvector_t* vector)
+{
+    const size_t arena_size = vector->arena->size;
+
+    if (arena_size >= VARVECTOR_COMPACT_MIN && vector->bytes < arena_size / 2)
+    {
+        return varvector_compact(vector);
+    }
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+varvector_t* varvector_new(void)
+{
+    errno = 0;
+
+    varvector_t *vector = ccollection_calloc(sizeof(varvector_t));
+    ASSERT(vector != NULL, NULL);
+
+    vector->spans = vector_new(sizeof(varvector_span_t));
+    vector->arena = vector_new(1);
+
+    if (vector->spans == NULL || vector->arena == NULL)
+    {
+        varvector_destroy(vector);
+        return NULL;
+    }
+
+    return vector;
+}
+
+cerror_t varvector_destroy(varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    if (vector->spans != NULL)
+        vector_destroy(vector->spans);
+    if (vector->arena != NULL)
+        vector_destroy(vector->arena);
+    ccollection_free(vector);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Capacity
+//==============================================================================
+cerror_t varvector_reserve(varvector_t* vector, const size_t count, const size_t bytes)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    ASSERT(vector_reserve(vector->spans, count) == ERROR_NONE, ERROR_FAILED);
+    return vector_reserve(vector->arena, bytes);
+}
+
+size_t varvector_get_size(const varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, 0);
+
+    return vector->spans->size;
+}
+
+size_t varvector_get_bytes(const varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, 0);
+
+    return vector->bytes;
+}
+
+size_t varvector_get_arena_size(const varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, 0);
+
+    return vector->arena->size;
+}
+
+//==============================================================================
+// Modifiers
+//==============================================================================
+cerror_t varvector_push_back(varvector_t* vector, const void* data, const size_t length)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(data != NULL || length == 0, EBADPOINTER, ERROR_FAILED);
+
+    ASSERT(varvector_arena_reserve(vector, &data, length) == ERROR_NONE, ERROR_FAILED);
+
+    varvector_span_t span = { vector->arena->size, length };
+    ASSERT(vector_push_back(vector->spans, &span) == ERROR_NONE, ERROR_FAILED);
+
+    varvector_arena_append(vector, data, length);
+    vector->bytes += length;
+
+    return ERROR_NONE;
+}
+
+cerror_t varvector_push_back_n(varvector_t* vector, const void* data, const size_t* lengths, const size_t n)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(lengths != NULL, EBADPOINTER, ERROR_FAILED);
+
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        total += lengths[i];
+    }
+    ASSERT_E(data != NULL || total == 0, EBADPOINTER, ERROR_FAILED);
+
+    // grow both arrays once, then fill them without further checks
+    ASSERT(varvector_arena_reserve(vector, &data, total) == ERROR_NONE, ERROR_FAILED);
+    if (vector->spans->size + n > vector->spans->capacity)
+    {
+        ASSERT(vector_reserve(vector->spans, MAX(vector->spans->size + n, vector->spans->capacity * 2))
+                == ERROR_NONE, ERROR_FAILED);
+    }
+
+    varvector_span_t *span = varvector_span(vector, vector->spans->size);
+    uint64_t offset = vector->arena->size;
+    for (size_t i = 0; i < n; i++, span++)
+    {
+        span->offset = offset;
+        span->length = lengths[i];
+        offset += lengths[i];
+    }
+    vector->spans->size += n;
+    STATS_PEAK(vector->spans, peak_size, vector->spans->size);
+
+    varvector_arena_append(vector, data, total);
+    vector->bytes += total;
+
+    return ERROR_NONE;
+}
+
+cerror_t varvector_set(varvector_t* vector, const size_t index, const void* data, const size_t length)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(data != NULL || length == 0, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(index < vector->spans->size, EOUTOFRANGE, ERROR_FAILED);
+
+    varvector_span_t *span = varvector_span(vector, index);
+
+    if (length <= span->length)
+    {
+        if (length > 0)
+        {
+            ccollection_move(VECTOR_ITEM(vector->arena, span->offset), data, length);
+        }
+    }
+    else
+    {
+        ASSERT(varvector_arena_reserve(vector, &data, length) == ERROR_NONE, ERROR_FAILED);
+
+        span->offset = varvector_arena_append(vector, data, length);
+    }
+    vector->bytes = vector->bytes - span->length + length;
+    span->length = length;
+
+    return varvector_collect(vector);
+}
+
+cerror_t varvector_erase(varvector_t* vector, const size_t index)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(index < vector->spans->size, EOUTOFRANGE, ERROR_FAILED);
+
+    vector->bytes -= varvector_span(vector, index)->length;
+
+    // the bytes of the last element can be reused right away
+    if (index == vector->spans->size - 1)
+    {
+        const varvector_span_t *span = varvector_span(vector, index);
+        if (span->offset + span->length == vector->arena->size)
+        {
+            vector->arena->size = span->offset;
+        }
+    }
+    ASSERT(vector_erase(vector->spans, index) == ERROR_NONE, ERROR_FAILED);
+
+    return varvector_collect(vector);
+}
+
+cerror_t varvector_pop_back(varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(vector->spans->size > 0, EEMPTY, ERROR_FAILED);
+
+    return varvector_erase(vector, vector->spans->size - 1);
+}
+
+cerror_t varvector_clear(varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector->bytes = 0;
+    ASSERT(vector_clear(vector->arena) == ERROR_NONE, ERROR_FAILED);
+    return vector_clear(vector->spans);
+}
+
+cerror_t varvector_compact(varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector_t *arena = vector_new(1);
+    ASSERT(arena != NULL, ERROR_FAILED);
+
+    if (vector_reserve(arena, MAX(vector->bytes, 1)) != ERROR_NONE)
+    {
+        vector_destroy(arena);
+        return ERROR_FAILED;
+    }
+
+    uint8_t *out = arena->items;
+    for (size_t i = 0; i < vector->spans->size; i++)
+    {
+        varvector_span_t *span = varvector_span(vector, i);
+
+        ccollection_copy(out, VECTOR_ITEM(vector->arena, span->offset), span->length);
+        span->offset = out - arena->items;
+        out += span->length;
+    }
+    arena->size = vector->bytes;
+
+    vector_destroy(vector->arena);
+    vector->arena = arena;
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Element access
+//==============================================================================
+const void* varvector_get(const varvector_t* vector, const size_t index, size_t* length)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+    ASSERT_E(length != NULL, EBADPOINTER, NULL);
+    ASSERT_E(index < vector->spans->size, EOUTOFRANGE, NULL);
+
+    const varvector_span_t *span = varvector_span(vector, index);
+    *length = span->length;
+
+    return VECTOR_ITEM(vector->arena, span->offset);
+}
+
+const varvector_span_t* varvector_spans(const varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+
+    return vector_cdata(vector->spans);
+}
+
+const uint8_t* varvector_arena(const varvector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+
+    return vector_cdata(vector->arena);
+}
+
+EXTERN_C_END
@@ -0,0 +1,122 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef VECTOR_INTERNAL_H
+
+#define VECTOR_INTERNAL_H
+
+#include "include/vector.h"
+#include "src/stats-internal.h"
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// Storage backends
+//==============================================================================
+
+/**
+ * vector data structure defenition
+ */
+struct vector_t
+{
+    uint8_t *items;             /** stores all elements of the container */
+    size_t element_size;        /** size of one element */
+    size_t stride;              /** distance between two elements, element_size unless padded */
+    size_t alignment;           /** alignment of items, 0 for the default malloc alignment */
+    size_t size;                /** total number of elements in container */
+    size_t capacity;            /** capacity of the container */
+    vector_storage_t storage;   /** backend owning the items buffer */
+    bool embedded;              /** the vector lives in caller owned storage, see vector_init */
+    void *backing;              /** backend specific state, NULL for heap storage */
+    STATS_ENTRY                 /** statistics, only present when built with CCOLLECTION_STATS */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+/**
+ * returns true if size == capacity
+ */
+bool vector_is_full(const vector_t* vector);
+/**
+ * resize vector to number of elements supplied by count
+ */
+cerror_t vector_resize(vector_t* vector, const size_t count);
+/**
+ * If the size of the vector is <= 1/4 of it's capacity then the container is resized to it's half capacity
+ */
+cerror_t vector_shrink(vector_t * vector);
+/**
+ * called by every modifier before it touches items, fails with EREADONLY if the storage can not be written
+ */
+cerror_t vector_make_writable(vector_t* vector);
+
+/**
+ * address of the element at index
+ */
+#define VECTOR_ITEM(vector, index)      ((vector)->items + (size_t)(index) * (vector)->stride)
+
+/**
+ * grow or shrink a file backed vector to hold count elements
+ */
+cerror_t vector_mapped_resize(vector_t* vector, const size_t count);
+/**
+ * unmap and close the file behind a file backed vector, items are not freed
+ */
+cerror_t vector_mapped_release(vector_t* vector);
+/**
+ * grow or shrink a page backed vector to hold count elements
+ */
+cerror_t vector_paged_resize(vector_t* vector, const size_t count);
+/**
+ * unmap the items of a page backed vector
+ */
+cerror_t vector_paged_release(vector_t* vector);
+/**
+ * reallocate the items of an aligned vector to hold count elements, keeping its alignment
+ */
+cerror_t vector_aligned_resize(vector_t* vector, const size_t count);
+/**
+ * give a shared vector its own items buffer with room for count elements, copying live elements out of the
+ * shared one. The vector goes back to the storage the shared items were allocated with.
+ */
+cerror_t vector_shared_detach(vector_t* vector, const size_t count);
+/**
+ * drop the reference of a shared vector, items are freed with the last reference
+ */
+cerror_t vector_shared_release(vector_t* vector);
+/**
+ * comparison of unsigned integer keys of size bytes, the order used when a vector_compare_t is NULL.
+ * Returns NULL for other sizes.
+ */
+vector_compare_t vector_compare_keys(const size_t size);
+/**
+ * true if the elements are 32 or 64 bit keys packed without padding, the case integer key kernels handle
+ */
+bool vector_packed_keys(const vector_t* vector);
+
+EXTERN_C_END
+
+#endif /* end of include guard: VECTOR_INTERNAL_H */
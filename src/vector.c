@@ -22,7 +22,7 @@
  * SOFTWARE.
  */
 
-#include "include/vector.h"
+#include "src/vector-internal.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -31,33 +31,56 @@
 
 EXTERN_C_BEGIN
 
+_Static_assert(sizeof(vector_t) <= sizeof(vector_header_t), "VECTOR_HEADER_SIZE is too small for vector_t");
+_Static_assert(_Alignof(vector_t) <= _Alignof(vector_header_t), "vector_header_t is not aligned for vector_t");
+_Static_assert(offsetof(vector_t, items) == offsetof(vector_layout_t, items) &&
+        offsetof(vector_t, element_size) == offsetof(vector_layout_t, element_size) &&
+        offsetof(vector_t, stride) == offsetof(vector_layout_t, stride) &&
+        offsetof(vector_t, alignment) == offsetof(vector_layout_t, alignment) &&
+        offsetof(vector_t, size) == offsetof(vector_layout_t, size) &&
+        offsetof(vector_t, capacity) == offsetof(vector_layout_t, capacity) &&
+        offsetof(vector_t, storage) == offsetof(vector_layout_t, storage), "vector_layout_t does not match vector_t");
+
 /**
- * vector data structure defenition
+ * set up a zeroed vector header, shared by heap allocated and caller owned vectors
  */
-typedef struct vector_t
+static vector_t* vector_setup(vector_t* vector, const size_t elem_size, const bool embedded)
 {
-    uint8_t *items;             /** stores all elements of the container */
-    size_t element_size;        /** size of one element */
-    size_t size;                /** total number of elements in container */
-    size_t capacity;            /** capacity of the container */
-} vector_t;
+    vector->element_size = elem_size;
+    vector->stride = elem_size;
+    vector->embedded = embedded;
+    STATS_REGISTER(vector, "vector");
 
-//==============================================================================
-// Internal functions
-//==============================================================================
+    return vector;
+}
 
 /**
- * returns true if size == capacity
- */
-bool vector_is_full(const vector_t* vector);
-/**
- * resize vector to number of elements supplied by count
+ * release the items of a vector according to its storage backend
  */
-cerror_t vector_resize(vector_t* vector, const size_t count);
-/**
- * If the size of the vector is <= 1/4 of it's capacity then the container is resized to it's half capacity
- */
-cerror_t vector_shrink(vector_t * vector);
+static void vector_release(vector_t* vector)
+{
+    STATS_UNREGISTER(vector);
+
+    switch (vector->storage)
+    {
+        case VECTOR_STORAGE_MAPPED:
+            vector_mapped_release(vector);
+            break;
+        case VECTOR_STORAGE_PAGED:
+            vector_paged_release(vector);
+            break;
+        case VECTOR_STORAGE_VIEW:
+        case VECTOR_STORAGE_FIXED:
+            // items belong to the caller
+            break;
+        case VECTOR_STORAGE_SHARED:
+            vector_shared_release(vector);
+            break;
+        default:
+            ccollection_free(vector->items);
+            break;
+    }
+}
 
 //==============================================================================
 // ctors and dtors
@@ -70,7 +93,7 @@ vector_t* vector_new(const size_t elem_size)
     vector_t* vector = ccollection_calloc(sizeof(vector_t));
     ASSERT(vector != NULL, NULL);
 
-    vector->element_size = elem_size;
+    vector_setup(vector, elem_size, false);
     vector_resize(vector, 1);
 
     return vector;
@@ -80,8 +103,80 @@ cerror_t vector_destroy(vector_t* vector)
 {
     ASSERT_E(vector != NULL, EBADELEMSIZE, ERROR_FAILED);
 
-    ccollection_free(vector->items);
-    ccollection_free(vector);
+    vector_release(vector);
+    if (!vector->embedded)
+    {
+        ccollection_free(vector);
+    }
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Caller owned storage
+//==============================================================================
+vector_t* vector_init(vector_header_t* header, const size_t elem_size)
+{
+    errno = 0;
+    ASSERT_E(header != NULL, EBADPOINTER, NULL);
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+
+    vector_t* vector = (vector_t*)header;
+    memset(vector, 0, sizeof(vector_t));
+
+    vector_setup(vector, elem_size, true);
+    if (vector_resize(vector, 1) != ERROR_NONE)
+    {
+        STATS_UNREGISTER(vector);
+        return NULL;
+    }
+
+    return vector;
+}
+
+vector_t* vector_init_wrap(vector_header_t* header, void* buffer, const size_t capacity, const size_t elem_size)
+{
+    errno = 0;
+    ASSERT_E(header != NULL, EBADPOINTER, NULL);
+    ASSERT_E(buffer != NULL, EBADPOINTER, NULL);
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+    ASSERT_E(capacity > 0, EINVAL, NULL);
+
+    vector_t* vector = (vector_t*)header;
+    memset(vector, 0, sizeof(vector_t));
+
+    vector_setup(vector, elem_size, true);
+    vector->items = buffer;
+    vector->capacity = capacity;
+    vector->storage = VECTOR_STORAGE_FIXED;
+    STATS_PEAK(vector, peak_capacity, capacity);
+
+    return vector;
+}
+
+vector_t* vector_wrap(void* buffer, const size_t capacity, const size_t elem_size)
+{
+    errno = 0;
+    ASSERT_E(buffer != NULL, EBADPOINTER, NULL);
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+    ASSERT_E(capacity > 0, EINVAL, NULL);
+
+    vector_t* vector = ccollection_calloc(sizeof(vector_t));
+    ASSERT(vector != NULL, NULL);
+
+    vector_init_wrap((vector_header_t*)vector, buffer, capacity, elem_size);
+    vector->embedded = false;
+
+    return vector;
+}
+
+cerror_t vector_deinit(vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(vector->embedded, EINVAL, ERROR_FAILED);
+
+    vector_release(vector);
+    memset(vector, 0, sizeof(vector_t));
 
     return ERROR_NONE;
 }
@@ -104,6 +199,23 @@ bool vector_is_empty(const vector_t* vector)
     return (vector->size == 0);
 }
 
+cerror_t vector_get_stats(const vector_t* vector, ccollection_stats_t* stats)
+{
+#ifdef CCOLLECTION_STATS
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(stats != NULL, EBADPOINTER, ERROR_FAILED);
+
+    *stats = vector->stats.counters;
+
+    return ERROR_NONE;
+#else
+    (void)vector;
+    (void)stats;
+    errno = ENOTSUP;
+    return ERROR_FAILED;
+#endif
+}
+
 //==============================================================================
 // vector modifiers
 //==============================================================================
@@ -126,27 +238,28 @@ cerror_t vector_assign_n(vector_t* vector, const size_t n, const item_t* val)
     ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
     ASSERT_E(n > 0, EINVAL, ERROR_FAILED);
     ASSERT_E(val != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
 
     // if n < capacity then copy the val to the target element, otherwise first
     // resize the vector then copy the val
 
     cerror_t err = ERROR_NONE;
 
-    // calculate next power of 2
-    int capacity = next_pow2(n);
-    while (capacity > vector->capacity)
+    // grow to the next power of 2, a fixed capacity vector can still take up to its capacity
+    if (n > vector->capacity)
     {
-        err = vector_resize(vector, capacity);
+        err = vector_resize(vector, vector->storage == VECTOR_STORAGE_FIXED ? n : next_pow2(n));
     }
 
     ASSERT(err == ERROR_NONE, err);
 
     for(int i = 0; i < n; i++)
     {
-        ccollection_copy(vector->items + i * vector->element_size, val, vector->element_size);
+        ccollection_copy(VECTOR_ITEM(vector, i), val, vector->element_size);
     }
 
     vector->size = MAX(vector->size, n);
+    STATS_PEAK(vector, peak_size, vector->size);
 
     return err;
 }
@@ -156,6 +269,7 @@ cerror_t vector_insert(vector_t* vector, const pos_t pos, const item_t* item)
     ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
     ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
     ASSERT_E(pos <= vector->size && pos >= 0, EOUTOFRANGE, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
 
     // if size == capacity then reallocate
     if (vector->size == vector->capacity)
@@ -165,21 +279,22 @@ cerror_t vector_insert(vector_t* vector, const pos_t pos, const item_t* item)
     }
     if (pos == vector->size) // insert at the end
     {
-        ccollection_copy(vector->items + vector->size * vector->element_size, item, vector->element_size);
+        ccollection_copy(VECTOR_ITEM(vector, vector->size), item, vector->element_size);
         vector->size++;
+        STATS_PEAK(vector, peak_size, vector->size);
 
         return ERROR_NONE;
     }
     // shift all elements by 1 to right after starting from position pos
+    STATS_COUNT(vector, bytes_moved, vector->stride * (vector->size - pos));
     for (int i = vector->size - 1; i >= pos; i--)
     {
-        ccollection_copy(vector->items + vector->element_size * (i + 1),
-                vector->items + vector->element_size * i,
-                vector->element_size);
+        ccollection_copy(VECTOR_ITEM(vector, i + 1), VECTOR_ITEM(vector, i), vector->stride);
     }
     // now insert the new element
-    ccollection_copy(vector->items + pos * vector->element_size, item, vector->element_size);
+    ccollection_copy(VECTOR_ITEM(vector, pos), item, vector->element_size);
     vector->size++;
+    STATS_PEAK(vector, peak_size, vector->size);
 
     return ERROR_NONE;
 }
@@ -188,13 +303,14 @@ cerror_t vector_erase(vector_t* vector, const pos_t pos)
 {
     ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
     ASSERT_E(pos < vector->size && pos >= 0, EOUTOFRANGE, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
 
     cerror_t err = ERROR_NONE;
     if (pos < vector->size - 1) // any element but last
     {
-        ccollection_copy(vector->items + pos * vector->element_size,
-                vector->items + (pos + 1) * vector->element_size,
-                vector->element_size * (vector->size - pos - 1));
+        ccollection_move(VECTOR_ITEM(vector, pos), VECTOR_ITEM(vector, pos + 1),
+                vector->stride * (vector->size - pos - 1));
+        STATS_COUNT(vector, bytes_moved, vector->stride * (vector->size - pos - 1));
     }
 
     vector->size--;
@@ -209,14 +325,25 @@ cerror_t vector_swap(vector_t* first, vector_t* second)
     swap_size(&first->size, &second->size);
     swap_size(&first->capacity, &second->capacity);
     swap_size(&first->element_size, &second->element_size);
+    swap_size(&first->stride, &second->stride);
+    swap_size(&first->alignment, &second->alignment);
     swap_ptr(&first->items, &second->items);
 
+    vector_storage_t storage = first->storage;
+    first->storage = second->storage;
+    second->storage = storage;
+
+    void *backing = first->backing;
+    first->backing = second->backing;
+    second->backing = backing;
+
     return ERROR_NONE;
 }
 
 cerror_t vector_clear(vector_t* vector)
 {
     ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
     vector->size = 0;
     return vector_resize(vector, 1);
 }
@@ -231,7 +358,54 @@ cerror_t vector_at(const vector_t* vector, const pos_t index, item_t* item)
     ASSERT_E(index < vector->size, EOUTOFRANGE, ERROR_FAILED);
     ASSERT_E(index >= 0, EOUTOFRANGE, ERROR_FAILED);
 
-    ccollection_copy(item, vector->items + (index * vector->element_size), vector->element_size);
+    ccollection_copy(item, VECTOR_ITEM(vector, index), vector->element_size);
+
+    return ERROR_NONE;
+}
+
+item_t* vector_data(vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, NULL);
+
+    return vector->items;
+}
+
+const item_t* vector_cdata(const vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+
+    return vector->items;
+}
+
+size_t vector_get_stride(const vector_t* vector)
+{
+    return vector->stride;
+}
+
+//==============================================================================
+// Iterators
+//==============================================================================
+cerror_t vector_begin(vector_t* vector, iterator_t* iterator)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
+
+    return vector_cbegin(vector, iterator);
+}
+
+cerror_t vector_cbegin(const vector_t* vector, iterator_t* iterator)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(iterator != NULL, EBADPOINTER, ERROR_FAILED);
+
+    iterator->current = vector->items;
+    iterator->end = VECTOR_ITEM(vector, vector->size);
+    iterator->stride = vector->stride;
+    iterator->prefetch = 0;
+    iterator->refill = NULL;
+    iterator->container = vector;
+    iterator->position = 0;
 
     return ERROR_NONE;
 }
@@ -256,11 +430,29 @@ cerror_t vector_reserve(vector_t* vector, const size_t count)
     return ERROR_NONE;
 }
 
-cerror_t vector_resize(vector_t* vector, const size_t count)
+/**
+ * let the storage backend resize the items buffer
+ */
+static cerror_t vector_storage_resize(vector_t* vector, const size_t count)
 {
-    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    switch (vector->storage)
+    {
+        case VECTOR_STORAGE_MAPPED:
+            return vector_mapped_resize(vector, count);
+        case VECTOR_STORAGE_PAGED:
+            return vector_paged_resize(vector, count);
+        case VECTOR_STORAGE_ALIGNED:
+            return vector_aligned_resize(vector, count);
+        case VECTOR_STORAGE_VIEW:
+            errno = EREADONLY;
+            return ERROR_FAILED;
+        case VECTOR_STORAGE_SHARED:
+            return vector_shared_detach(vector, count);
+        default:
+            break;
+    }
 
-    uint8_t *items = ccollection_realloc(vector->items, count * vector->element_size);
+    uint8_t *items = ccollection_realloc(vector->items, count * vector->stride);
     ASSERT(items != NULL, ERROR_FAILED);
 
     vector->items = items;
@@ -269,12 +461,63 @@ cerror_t vector_resize(vector_t* vector, const size_t count)
     return ERROR_NONE;
 }
 
+cerror_t vector_resize(vector_t* vector, const size_t count)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    // a caller supplied buffer never moves, growing past it is an error and shrinking keeps it whole
+    if (vector->storage == VECTOR_STORAGE_FIXED)
+    {
+        ASSERT_E(count <= vector->capacity, EFULL, ERROR_FAILED);
+        return ERROR_NONE;
+    }
+
+#ifdef CCOLLECTION_STATS
+    const bool allocated = (vector->items != NULL);
+    const size_t capacity = vector->capacity;
+#endif
+
+    cerror_t err = vector_storage_resize(vector, count);
+    ASSERT(err == ERROR_NONE, err);
+
+#ifdef CCOLLECTION_STATS
+    if (!allocated)
+    {
+        STATS_COUNT(vector, allocations, 1);
+    }
+    else
+    {
+        STATS_COUNT(vector, reallocations, 1);
+    }
+    if (allocated && count < capacity)
+    {
+        STATS_COUNT(vector, shrinks, 1);
+    }
+    STATS_PEAK(vector, peak_capacity, count);
+#endif
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_make_writable(vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(vector->storage != VECTOR_STORAGE_VIEW, EREADONLY, ERROR_FAILED);
+
+    if (vector->storage == VECTOR_STORAGE_SHARED)
+    {
+        return vector_shared_detach(vector, vector->capacity);
+    }
+
+    return ERROR_NONE;
+}
+
 cerror_t vector_shrink(vector_t * vector)
 {
     ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED); 
     if (vector->size < vector->capacity / 4)
     {
-        return vector_resize(vector, vector->capacity);
+        return vector_resize(vector, vector->capacity / 2);
     }
 
     return ERROR_NONE;
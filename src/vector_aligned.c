@@ -0,0 +1,103 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static vector_t* vector_aligned_new(const size_t elem_size, const size_t alignment, const bool padded)
+{
+    errno = 0;
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+    ASSERT_E(alignment > 0 && (alignment & (alignment - 1)) == 0, EINVAL, NULL);
+
+    vector_t *vector = ccollection_calloc(sizeof(vector_t));
+    ASSERT(vector != NULL, NULL);
+
+    vector->storage = VECTOR_STORAGE_ALIGNED;
+    vector->element_size = elem_size;
+    // posix_memalign does not accept anything below the alignment of a pointer
+    vector->alignment = MAX(alignment, sizeof(void*));
+    vector->stride = padded ? (elem_size + alignment - 1) & ~(alignment - 1) : elem_size;
+
+    STATS_REGISTER(vector, "vector");
+
+    if (vector_resize(vector, 1) != ERROR_NONE)
+    {
+        STATS_UNREGISTER(vector);
+        ccollection_free(vector);
+        return NULL;
+    }
+
+    return vector;
+}
+
+//==============================================================================
+// ctors
+//==============================================================================
+vector_t* vector_new_aligned(const size_t elem_size, const size_t alignment)
+{
+    return vector_aligned_new(elem_size, alignment, false);
+}
+
+vector_t* vector_new_aligned_padded(const size_t elem_size, const size_t alignment)
+{
+    return vector_aligned_new(elem_size, alignment, true);
+}
+
+//==============================================================================
+// Storage backend
+//==============================================================================
+cerror_t vector_aligned_resize(vector_t* vector, const size_t count)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(count <= SIZE_MAX / vector->stride, ENOMEM, ERROR_FAILED);
+
+    // there is no aligned realloc, allocate the new buffer and move live elements over
+    void *items = NULL;
+    int err = posix_memalign(&items, vector->alignment, MAX(count, 1) * vector->stride);
+    ASSERT_E(err == 0, err, ERROR_FAILED);
+
+    if (vector->items != NULL)
+    {
+        ccollection_copy(items, vector->items, MIN(vector->size, count) * vector->stride);
+    }
+    ccollection_free(vector->items);
+
+    vector->items = items;
+    vector->capacity = count;
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
@@ -0,0 +1,281 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * items buffer shared by a vector and its clones
+ */
+typedef struct vector_shared_t
+{
+    atomic_size_t refs;         /** number of vectors using items */
+    uint8_t *items;             /** shared elements, never modified while shared */
+    vector_storage_t storage;   /** storage items were allocated with, heap or aligned */
+} vector_shared_t;
+
+/**
+ * published snapshot data structure defenition
+ */
+struct vector_snapshot_t
+{
+    _Atomic(vector_t*) current; /** vector readers see, never modified once published */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+/**
+ * move the items of a heap or aligned vector into a shared buffer with a single reference
+ */
+static cerror_t vector_share(vector_t* vector)
+{
+    vector_shared_t *shared = ccollection_calloc(sizeof(vector_shared_t));
+    ASSERT(shared != NULL, ERROR_FAILED);
+
+    atomic_init(&shared->refs, 1);
+    shared->items = vector->items;
+    shared->storage = vector->storage;
+
+    vector->storage = VECTOR_STORAGE_SHARED;
+    vector->backing = shared;
+
+    return ERROR_NONE;
+}
+
+static void vector_snapshot_free(void* ptr)
+{
+    vector_destroy(ptr);
+}
+
+//==============================================================================
+// Storage backend
+//==============================================================================
+cerror_t vector_shared_detach(vector_t* vector, const size_t count)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector_shared_t *shared = vector->backing;
+
+    // last reference, the items are ours again
+    if (atomic_load_explicit(&shared->refs, memory_order_acquire) == 1)
+    {
+        vector->storage = shared->storage;
+        vector->backing = NULL;
+        ccollection_free(shared);
+
+        return count == vector->capacity ? ERROR_NONE : vector_resize(vector, count);
+    }
+
+    // allocate a private buffer through the original backend, it must not see the shared items
+    const size_t size = vector->size;
+    const size_t capacity = vector->capacity;
+
+    vector->storage = shared->storage;
+    vector->backing = NULL;
+    vector->items = NULL;
+    vector->size = 0;
+
+    if (vector_resize(vector, MAX(count, 1)) != ERROR_NONE)
+    {
+        vector->storage = VECTOR_STORAGE_SHARED;
+        vector->backing = shared;
+        vector->items = shared->items;
+        vector->size = size;
+        vector->capacity = capacity;
+        return ERROR_FAILED;
+    }
+    vector->size = MIN(size, count);
+    vector->capacity = count;
+    ccollection_copy(vector->items, shared->items, vector->size * vector->stride);
+
+    if (atomic_fetch_sub_explicit(&shared->refs, 1, memory_order_acq_rel) == 1)
+    {
+        ccollection_free(shared->items);
+        ccollection_free(shared);
+    }
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_shared_release(vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector_shared_t *shared = vector->backing;
+
+    if (atomic_fetch_sub_explicit(&shared->refs, 1, memory_order_acq_rel) == 1)
+    {
+        ccollection_free(shared->items);
+        ccollection_free(shared);
+    }
+    vector->items = NULL;
+    vector->backing = NULL;
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Copy on write
+//==============================================================================
+vector_t* vector_clone(vector_t* vector)
+{
+    errno = 0;
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+
+    // mapped, paged and caller owned items can not be shared across vectors, copy them
+    if (vector->storage == VECTOR_STORAGE_MAPPED || vector->storage == VECTOR_STORAGE_PAGED ||
+            vector->storage == VECTOR_STORAGE_FIXED)
+    {
+        vector_t *clone = vector_new(vector->element_size);
+        ASSERT(clone != NULL, NULL);
+
+        if (vector_reserve(clone, MAX(vector->size, 1)) != ERROR_NONE)
+        {
+            vector_destroy(clone);
+            return NULL;
+        }
+        ccollection_copy(clone->items, vector->items, vector->size * vector->stride);
+        clone->size = vector->size;
+        STATS_PEAK(clone, peak_size, clone->size);
+
+        return clone;
+    }
+
+    if (vector->storage == VECTOR_STORAGE_HEAP || vector->storage == VECTOR_STORAGE_ALIGNED)
+    {
+        ASSERT(vector_share(vector) == ERROR_NONE, NULL);
+    }
+
+    vector_t *clone = ccollection_calloc(sizeof(vector_t));
+    ASSERT(clone != NULL, NULL);
+
+    clone->items = vector->items;
+    clone->element_size = vector->element_size;
+    clone->stride = vector->stride;
+    clone->alignment = vector->alignment;
+    clone->size = vector->size;
+    clone->capacity = vector->capacity;
+    clone->storage = vector->storage;
+    clone->backing = vector->backing;
+    STATS_REGISTER(clone, "vector");
+
+    // views only borrow the caller's buffer, there is nothing to count
+    if (vector->storage == VECTOR_STORAGE_SHARED)
+    {
+        vector_shared_t *shared = vector->backing;
+        atomic_fetch_add_explicit(&shared->refs, 1, memory_order_relaxed);
+    }
+
+    return clone;
+}
+
+//==============================================================================
+// Snapshots
+//==============================================================================
+vector_snapshot_t* vector_snapshot_new(vector_t* vector)
+{
+    errno = 0;
+    ASSERT_E(vector != NULL, EBADPOINTER, NULL);
+
+    vector_snapshot_t *snapshot = ccollection_calloc(sizeof(vector_snapshot_t));
+    ASSERT(snapshot != NULL, NULL);
+
+    // readers clone concurrently, so the items must already be shared
+    if ((vector->storage == VECTOR_STORAGE_HEAP || vector->storage == VECTOR_STORAGE_ALIGNED) &&
+            vector_share(vector) != ERROR_NONE)
+    {
+        ccollection_free(snapshot);
+        return NULL;
+    }
+    atomic_init(&snapshot->current, vector);
+
+    return snapshot;
+}
+
+cerror_t vector_snapshot_destroy(vector_snapshot_t* snapshot)
+{
+    ASSERT_E(snapshot != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector_destroy(atomic_load_explicit(&snapshot->current, memory_order_relaxed));
+    ccollection_free(snapshot);
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_snapshot_publish(vector_snapshot_t* snapshot, vector_t* vector, ebr_thread_t* thread)
+{
+    ASSERT_E(snapshot != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(thread != NULL, EBADPOINTER, ERROR_FAILED);
+
+    if (vector->storage == VECTOR_STORAGE_HEAP || vector->storage == VECTOR_STORAGE_ALIGNED)
+    {
+        ASSERT(vector_share(vector) == ERROR_NONE, ERROR_FAILED);
+    }
+
+    vector_t *old = atomic_exchange_explicit(&snapshot->current, vector, memory_order_acq_rel);
+
+    return ebr_retire(thread, old, vector_snapshot_free);
+}
+
+const vector_t* vector_snapshot_read_begin(vector_snapshot_t* snapshot, ebr_thread_t* thread)
+{
+    ASSERT_E(snapshot != NULL, EBADPOINTER, NULL);
+    ASSERT(ebr_enter(thread) == ERROR_NONE, NULL);
+
+    return atomic_load_explicit(&snapshot->current, memory_order_acquire);
+}
+
+cerror_t vector_snapshot_read_end(vector_snapshot_t* snapshot, ebr_thread_t* thread)
+{
+    ASSERT_E(snapshot != NULL, EBADPOINTER, ERROR_FAILED);
+
+    return ebr_exit(thread);
+}
+
+vector_t* vector_snapshot_acquire(vector_snapshot_t* snapshot, ebr_thread_t* thread)
+{
+    const vector_t *current = vector_snapshot_read_begin(snapshot, thread);
+    ASSERT(current != NULL, NULL);
+
+    // published vectors are already shared, cloning them only takes a reference
+    vector_t *clone = vector_clone((vector_t*)current);
+    int err = errno;
+
+    vector_snapshot_read_end(snapshot, thread);
+    errno = err;
+
+    return clone;
+}
+
+EXTERN_C_END
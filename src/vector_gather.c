@@ -0,0 +1,266 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "src/vector-internal.h"
+#include "src/cpu-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#ifdef CCOLLECTION_SIMD
+    #include <immintrin.h>
+#endif
+
+EXTERN_C_BEGIN
+
+/**
+ * gather kernels for packed 4 and 8 byte elements, one set per instruction set. out receives n elements,
+ * items[indices[i + distance]] is prefetched while items[indices[i]] is copied.
+ */
+typedef struct vector_gather_kernels_t
+{
+    void (*gather32)(const uint8_t* items, const pos_t* indices, const size_t n, uint8_t* out,
+            const size_t distance);
+    void (*gather64)(const uint8_t* items, const pos_t* indices, const size_t n, uint8_t* out,
+            const size_t distance);
+} vector_gather_kernels_t;
+
+//==============================================================================
+// Baseline kernels
+//==============================================================================
+
+/**
+ * copy elements one by one, size and stride are constants once inlined into the fixed size kernels
+ */
+static inline void vector_gather_elements(const uint8_t* items, const size_t stride, const size_t size,
+        const pos_t* indices, const size_t n, uint8_t* out, const size_t distance)
+{
+    size_t i = 0;
+    if (distance != 0)
+    {
+        for (; i + distance < n; i++)
+        {
+            ccollection_prefetch(items + (size_t)indices[i + distance] * stride);
+            ccollection_copy(out + i * size, items + (size_t)indices[i] * stride, size);
+        }
+    }
+    for (; i < n; i++)
+    {
+        ccollection_copy(out + i * size, items + (size_t)indices[i] * stride, size);
+    }
+}
+
+static inline void vector_scatter_elements(uint8_t* items, const size_t stride, const size_t size,
+        const pos_t* indices, const size_t n, const uint8_t* in, const size_t distance)
+{
+    size_t i = 0;
+    if (distance != 0)
+    {
+        for (; i + distance < n; i++)
+        {
+            ccollection_prefetch_write(items + (size_t)indices[i + distance] * stride);
+            ccollection_copy(items + (size_t)indices[i] * stride, in + i * size, size);
+        }
+    }
+    for (; i < n; i++)
+    {
+        ccollection_copy(items + (size_t)indices[i] * stride, in + i * size, size);
+    }
+}
+
+static void vector_gather32_generic(const uint8_t* items, const pos_t* indices, const size_t n, uint8_t* out,
+        const size_t distance)
+{
+    vector_gather_elements(items, 4, 4, indices, n, out, distance);
+}
+
+static void vector_gather64_generic(const uint8_t* items, const pos_t* indices, const size_t n, uint8_t* out,
+        const size_t distance)
+{
+    vector_gather_elements(items, 8, 8, indices, n, out, distance);
+}
+
+static const vector_gather_kernels_t vector_gather_kernels_generic = {
+    vector_gather32_generic,
+    vector_gather64_generic,
+};
+
+//==============================================================================
+// SIMD kernels
+//==============================================================================
+#ifdef CCOLLECTION_SIMD
+
+/**
+ * prefetch the elements of the index block distance indices ahead, if the whole block is in range
+ */
+#define VECTOR_GATHER_PREFETCH(items, indices, i, n, distance, lanes, size)                 \
+    if (distance != 0 && i + distance + lanes <= n)                                         \
+    {                                                                                       \
+        for (size_t k = 0; k < lanes; k++)                                                  \
+        {                                                                                   \
+            ccollection_prefetch(items + (size_t)indices[i + distance + k] * size);         \
+        }                                                                                   \
+    }
+
+CCOLLECTION_TARGET("avx2")
+static void vector_gather32_avx2(const uint8_t* items, const pos_t* indices, const size_t n, uint8_t* out,
+        const size_t distance)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        VECTOR_GATHER_PREFETCH(items, indices, i, n, distance, 8, 4)
+        const __m256i index = _mm256_loadu_si256((const __m256i*)(indices + i));
+        const __m256i values = _mm256_i32gather_epi32((const int*)items, index, 4);
+        _mm256_storeu_si256((__m256i*)(out + i * 4), values);
+    }
+    vector_gather_elements(items, 4, 4, indices + i, n - i, out + i * 4, 0);
+}
+
+CCOLLECTION_TARGET("avx2")
+static void vector_gather64_avx2(const uint8_t* items, const pos_t* indices, const size_t n, uint8_t* out,
+        const size_t distance)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        VECTOR_GATHER_PREFETCH(items, indices, i, n, distance, 4, 8)
+        const __m128i index = _mm_loadu_si128((const __m128i*)(indices + i));
+        const __m256i values = _mm256_i32gather_epi64((const long long*)items, index, 8);
+        _mm256_storeu_si256((__m256i*)(out + i * 8), values);
+    }
+    vector_gather_elements(items, 8, 8, indices + i, n - i, out + i * 8, 0);
+}
+
+static const vector_gather_kernels_t vector_gather_kernels_avx2 = {
+    vector_gather32_avx2,
+    vector_gather64_avx2,
+};
+
+#endif
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static const vector_gather_kernels_t *vector_gather_active_kernels = &vector_gather_kernels_generic;
+static pthread_once_t vector_gather_kernels_once = PTHREAD_ONCE_INIT;
+
+static void vector_gather_select_kernels(void)
+{
+#ifdef CCOLLECTION_SIMD
+    if (ccollection_cpu_avx2())
+    {
+        vector_gather_active_kernels = &vector_gather_kernels_avx2;
+    }
+#endif
+}
+
+static inline const vector_gather_kernels_t* vector_gather_kernels(void)
+{
+    pthread_once(&vector_gather_kernels_once, vector_gather_select_kernels);
+    return vector_gather_active_kernels;
+}
+
+/**
+ * check every index of a batch once, so the copy loops run without branches on the indices
+ */
+static inline bool vector_indices_in_range(const vector_t* vector, const pos_t* indices, const size_t n)
+{
+    bool out_of_range = false;
+    for (size_t i = 0; i < n; i++)
+    {
+        // negative indices wrap to huge values
+        out_of_range |= ((size_t)indices[i] >= vector->size);
+    }
+    return !out_of_range;
+}
+
+//==============================================================================
+// Batched random access
+//==============================================================================
+cerror_t vector_gather(const vector_t* vector, const pos_t* indices, const size_t n, item_t* out)
+{
+    return vector_gather_prefetch(vector, indices, n, out, VECTOR_PREFETCH_DISTANCE);
+}
+
+cerror_t vector_scatter(vector_t* vector, const pos_t* indices, const size_t n, const item_t* in)
+{
+    return vector_scatter_prefetch(vector, indices, n, in, VECTOR_PREFETCH_DISTANCE);
+}
+
+cerror_t vector_gather_prefetch(const vector_t* vector, const pos_t* indices, const size_t n, item_t* out,
+        const size_t distance)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(n == 0 || indices != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(n == 0 || out != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(vector_indices_in_range(vector, indices, n), EOUTOFRANGE, ERROR_FAILED);
+
+    if (vector->element_size == 4 && vector->stride == 4)
+    {
+        vector_gather_kernels()->gather32(vector->items, indices, n, out, distance);
+    }
+    else if (vector->element_size == 8 && vector->stride == 8)
+    {
+        vector_gather_kernels()->gather64(vector->items, indices, n, out, distance);
+    }
+    else
+    {
+        vector_gather_elements(vector->items, vector->stride, vector->element_size, indices, n, out, distance);
+    }
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_scatter_prefetch(vector_t* vector, const pos_t* indices, const size_t n, const item_t* in,
+        const size_t distance)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(n == 0 || indices != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(n == 0 || in != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(vector_indices_in_range(vector, indices, n), EOUTOFRANGE, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
+
+    // there is no scatter before AVX-512, fixed sizes still let the compiler use plain loads and stores
+    if (vector->element_size == 4 && vector->stride == 4)
+    {
+        vector_scatter_elements(vector->items, 4, 4, indices, n, in, distance);
+    }
+    else if (vector->element_size == 8 && vector->stride == 8)
+    {
+        vector_scatter_elements(vector->items, 8, 8, indices, n, in, distance);
+    }
+    else
+    {
+        vector_scatter_elements(vector->items, vector->stride, vector->element_size, indices, n, in, distance);
+    }
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
@@ -0,0 +1,280 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _GNU_SOURCE
+
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+EXTERN_C_BEGIN
+
+#define VECTOR_FILE_MAGIC           "CCOLVEC"
+#define VECTOR_FILE_VERSION         1
+#define VECTOR_FILE_HEADER_SIZE     64          /** elements start here, keeps them cache line aligned */
+
+/**
+ * header stored at the start of every file backed vector
+ */
+typedef struct vector_file_header_t
+{
+    char magic[8];              /** VECTOR_FILE_MAGIC */
+    uint32_t version;           /** VECTOR_FILE_VERSION */
+    uint32_t header_size;       /** offset of first element in the file */
+    uint64_t element_size;      /** size of one element */
+    uint64_t size;              /** number of elements at last flush */
+} vector_file_header_t;
+
+/**
+ * backing state of a file backed vector
+ */
+typedef struct vector_mapping_t
+{
+    int fd;                     /** file descriptor of the mapped file */
+    uint8_t *base;              /** start of the mapping, header lives here */
+    size_t length;              /** length of the mapping, the file is at least this long */
+} vector_mapping_t;
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+/**
+ * move the mapping to cover length bytes of the file, file must already be at least length bytes long
+ */
+static cerror_t vector_mapping_remap(vector_mapping_t* mapping, const size_t length)
+{
+#ifdef MREMAP_MAYMOVE
+    void *base = mremap(mapping->base, mapping->length, length, MREMAP_MAYMOVE);
+    ASSERT(base != MAP_FAILED, ERROR_FAILED);
+#else
+    void *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, mapping->fd, 0);
+    ASSERT(base != MAP_FAILED, ERROR_FAILED);
+
+    munmap(mapping->base, mapping->length);
+#endif
+    mapping->base = base;
+    mapping->length = length;
+
+    return ERROR_NONE;
+}
+
+static void vector_mapped_write_header(const vector_t* vector)
+{
+    vector_mapping_t *mapping = vector->backing;
+    vector_file_header_t *header = (vector_file_header_t*)mapping->base;
+
+    memcpy(header->magic, VECTOR_FILE_MAGIC, sizeof(header->magic));
+    header->version = VECTOR_FILE_VERSION;
+    header->header_size = VECTOR_FILE_HEADER_SIZE;
+    header->element_size = vector->element_size;
+    header->size = vector->size;
+}
+
+/**
+ * map length bytes of fd and wrap them into a vector, fd is owned by the vector on success
+ */
+static vector_t* vector_mapped_new(const int fd, const size_t elem_size, const size_t length)
+{
+    vector_t *vector = ccollection_calloc(sizeof(vector_t));
+    ASSERT(vector != NULL, NULL);
+
+    vector_mapping_t *mapping = ccollection_calloc(sizeof(vector_mapping_t));
+    if (mapping == NULL)
+    {
+        ccollection_free(vector);
+        return NULL;
+    }
+
+    mapping->base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping->base == MAP_FAILED)
+    {
+        ccollection_free(mapping);
+        ccollection_free(vector);
+        return NULL;
+    }
+    mapping->fd = fd;
+    mapping->length = length;
+
+    vector->storage = VECTOR_STORAGE_MAPPED;
+    vector->backing = mapping;
+    vector->element_size = elem_size;
+    vector->stride = elem_size;
+    vector->items = mapping->base + VECTOR_FILE_HEADER_SIZE;
+    vector->capacity = (length - VECTOR_FILE_HEADER_SIZE) / elem_size;
+    STATS_REGISTER(vector, "vector");
+    STATS_COUNT(vector, allocations, 1);
+    STATS_PEAK(vector, peak_capacity, vector->capacity);
+
+    return vector;
+}
+
+//==============================================================================
+// ctors
+//==============================================================================
+vector_t* vector_new_mapped(const char* path, const size_t elem_size)
+{
+    errno = 0;
+    ASSERT_E(path != NULL, EBADPOINTER, NULL);
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ASSERT(fd >= 0, NULL);
+
+    const size_t length = VECTOR_FILE_HEADER_SIZE + elem_size;
+    vector_t *vector = NULL;
+    if (ftruncate(fd, length) == 0)
+    {
+        vector = vector_mapped_new(fd, elem_size, length);
+    }
+    if (vector == NULL)
+    {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+    vector_mapped_write_header(vector);
+
+    return vector;
+}
+
+vector_t* vector_open_mapped(const char* path)
+{
+    errno = 0;
+    ASSERT_E(path != NULL, EBADPOINTER, NULL);
+
+    int fd = open(path, O_RDWR);
+    ASSERT(fd >= 0, NULL);
+
+    vector_file_header_t header;
+    struct stat st;
+    int err = EBADFORMAT;
+
+    if (fstat(fd, &st) != 0)
+    {
+        err = errno;
+    }
+    else if (st.st_size >= VECTOR_FILE_HEADER_SIZE &&
+            pread(fd, &header, sizeof(header), 0) == sizeof(header) &&
+            memcmp(header.magic, VECTOR_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+            header.version == VECTOR_FILE_VERSION &&
+            header.header_size == VECTOR_FILE_HEADER_SIZE &&
+            header.element_size > 0 &&
+            header.size <= (st.st_size - VECTOR_FILE_HEADER_SIZE) / header.element_size)
+    {
+        vector_t *vector = vector_mapped_new(fd, header.element_size, st.st_size);
+        if (vector != NULL)
+        {
+            vector->size = header.size;
+            STATS_PEAK(vector, peak_size, vector->size);
+            // an empty file has no room, make sure doubling on insert works
+            if (vector->capacity == 0 && vector_resize(vector, 1) != ERROR_NONE)
+            {
+                err = errno;
+                vector_destroy(vector);
+                errno = err;
+                return NULL;
+            }
+            return vector;
+        }
+        err = errno;
+    }
+
+    close(fd);
+    errno = err;
+
+    return NULL;
+}
+
+cerror_t vector_flush(vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector->storage == VECTOR_STORAGE_MAPPED, ERROR_NONE);
+
+    vector_mapping_t *mapping = vector->backing;
+
+    vector_mapped_write_header(vector);
+    ASSERT(msync(mapping->base, mapping->length, MS_SYNC) == 0, ERROR_FAILED);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Storage backend
+//==============================================================================
+cerror_t vector_mapped_resize(vector_t* vector, const size_t count)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(count <= (SIZE_MAX - VECTOR_FILE_HEADER_SIZE) / vector->element_size, ENOMEM, ERROR_FAILED);
+
+    vector_mapping_t *mapping = vector->backing;
+    const size_t length = VECTOR_FILE_HEADER_SIZE + count * vector->element_size;
+
+    if (length > mapping->length)
+    {
+        // file must be extended before the pages are mapped, or touching them raises SIGBUS
+        ASSERT(ftruncate(mapping->fd, length) == 0, ERROR_FAILED);
+        ASSERT(vector_mapping_remap(mapping, length) == ERROR_NONE, ERROR_FAILED);
+    }
+    else if (length < mapping->length)
+    {
+        ASSERT(vector_mapping_remap(mapping, length) == ERROR_NONE, ERROR_FAILED);
+        if (ftruncate(mapping->fd, length) != 0)
+        {
+            // a file longer than the mapping only wastes disk space, the vector stays usable with it
+        }
+    }
+
+    vector->items = mapping->base + VECTOR_FILE_HEADER_SIZE;
+    vector->capacity = count;
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_mapped_release(vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector_mapping_t *mapping = vector->backing;
+
+    vector_mapped_write_header(vector);
+    munmap(mapping->base, mapping->length);
+    close(mapping->fd);
+    ccollection_free(mapping);
+
+    vector->items = NULL;
+    vector->backing = NULL;
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
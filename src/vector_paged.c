@@ -0,0 +1,244 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define _GNU_SOURCE
+
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+EXTERN_C_BEGIN
+
+#define HUGE_PAGE_SIZE      (2UL << 20)
+
+// from <numaif.h>, which is only installed with libnuma
+#ifndef MPOL_BIND
+    #define MPOL_BIND       2
+#endif
+#ifndef MPOL_INTERLEAVE
+    #define MPOL_INTERLEAVE 3
+#endif
+
+/**
+ * backing state of a page backed vector
+ */
+typedef struct vector_paged_state_t
+{
+    vector_page_options_t options;  /** options the vector was created with */
+    bool hugetlb;                   /** mapping is made of hugetlb pages, cleared when the pool runs dry */
+    size_t length;                  /** length of the mapping starting at items */
+} vector_paged_state_t;
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+/**
+ * length of a mapping holding bytes, whole huge pages once the vector is large enough to use them
+ */
+static size_t vector_paged_length(const vector_paged_state_t* state, const size_t bytes)
+{
+    size_t granularity = (size_t)sysconf(_SC_PAGESIZE);
+
+    if (state->hugetlb || (state->options.pages != VECTOR_PAGES_DEFAULT && bytes >= HUGE_PAGE_SIZE))
+    {
+        granularity = HUGE_PAGE_SIZE;
+    }
+
+    return (MAX(bytes, 1) + granularity - 1) / granularity * granularity;
+}
+
+/**
+ * apply huge page advice and NUMA policy to a mapping, failures leave the default behaviour in place
+ */
+static void vector_paged_advise(const vector_paged_state_t* state, uint8_t* base, const size_t length)
+{
+#ifdef MADV_HUGEPAGE
+    if (!state->hugetlb && state->options.pages != VECTOR_PAGES_DEFAULT)
+    {
+        madvise(base, length, MADV_HUGEPAGE);
+    }
+#endif
+#ifdef SYS_mbind
+    if (state->options.numa != VECTOR_NUMA_DEFAULT && state->options.numa_nodes != 0)
+    {
+        const int mode = state->options.numa == VECTOR_NUMA_BIND ? MPOL_BIND : MPOL_INTERLEAVE;
+        unsigned long nodes = state->options.numa_nodes;
+
+        syscall(SYS_mbind, base, length, mode, &nodes, sizeof(nodes) * CHAR_BIT + 1, 0);
+    }
+#endif
+}
+
+/**
+ * create a new anonymous mapping of length bytes
+ */
+static uint8_t* vector_paged_map(vector_paged_state_t* state, const size_t length)
+{
+    void *base = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    if (state->hugetlb)
+    {
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            // no hugetlb pages left, vector_get_pages reports the fallback
+            state->hugetlb = false;
+        }
+    }
+#endif
+    if (base == MAP_FAILED)
+    {
+        base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        ASSERT(base != MAP_FAILED, NULL);
+    }
+    vector_paged_advise(state, base, length);
+
+    return base;
+}
+
+//==============================================================================
+// ctors
+//==============================================================================
+vector_t* vector_new_paged(const size_t elem_size, const vector_page_options_t* options)
+{
+    errno = 0;
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+
+    vector_t *vector = ccollection_calloc(sizeof(vector_t));
+    ASSERT(vector != NULL, NULL);
+
+    vector_paged_state_t *state = ccollection_calloc(sizeof(vector_paged_state_t));
+    if (state == NULL)
+    {
+        ccollection_free(vector);
+        return NULL;
+    }
+    if (options != NULL)
+    {
+        state->options = *options;
+    }
+    state->hugetlb = (state->options.pages == VECTOR_PAGES_HUGETLB);
+
+    vector->storage = VECTOR_STORAGE_PAGED;
+    vector->backing = state;
+    vector->element_size = elem_size;
+    vector->stride = elem_size;
+    STATS_REGISTER(vector, "vector");
+
+    if (vector_resize(vector, 1) != ERROR_NONE)
+    {
+        STATS_UNREGISTER(vector);
+        ccollection_free(state);
+        ccollection_free(vector);
+        return NULL;
+    }
+
+    return vector;
+}
+
+//==============================================================================
+// Storage backend
+//==============================================================================
+cerror_t vector_paged_resize(vector_t* vector, const size_t count)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(count <= (SIZE_MAX - HUGE_PAGE_SIZE) / vector->element_size, ENOMEM, ERROR_FAILED);
+
+    vector_paged_state_t *state = vector->backing;
+    const size_t length = vector_paged_length(state, count * vector->element_size);
+
+    if (vector->items == NULL)
+    {
+        vector->items = vector_paged_map(state, length);
+        ASSERT(vector->items != NULL, ERROR_FAILED);
+        state->length = length;
+    }
+    else if (length != state->length)
+    {
+        uint8_t *items = MAP_FAILED;
+#ifdef MREMAP_MAYMOVE
+        // hugetlb mappings can not be resized by mremap on every kernel, move them by hand
+        if (!state->hugetlb)
+        {
+            items = mremap(vector->items, state->length, length, MREMAP_MAYMOVE);
+            ASSERT(items != MAP_FAILED, ERROR_FAILED);
+            vector_paged_advise(state, items, length);
+        }
+#endif
+        if (items == MAP_FAILED)
+        {
+            items = vector_paged_map(state, length);
+            ASSERT(items != NULL, ERROR_FAILED);
+
+            ccollection_copy(items, vector->items, MIN(vector->size, count) * vector->element_size);
+            munmap(vector->items, state->length);
+        }
+        vector->items = items;
+        state->length = length;
+    }
+
+    vector->capacity = count;
+
+    return ERROR_NONE;
+}
+
+vector_pages_t vector_get_pages(const vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, VECTOR_PAGES_DEFAULT);
+    ASSERT(vector->storage == VECTOR_STORAGE_PAGED, VECTOR_PAGES_DEFAULT);
+
+    const vector_paged_state_t *state = vector->backing;
+    if (state->hugetlb)
+    {
+        return VECTOR_PAGES_HUGETLB;
+    }
+
+    return state->options.pages == VECTOR_PAGES_DEFAULT ? VECTOR_PAGES_DEFAULT : VECTOR_PAGES_TRANSPARENT;
+}
+
+cerror_t vector_paged_release(vector_t* vector)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    vector_paged_state_t *state = vector->backing;
+
+    munmap(vector->items, state->length);
+    ccollection_free(state);
+
+    vector->items = NULL;
+    vector->backing = NULL;
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
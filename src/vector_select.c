@@ -0,0 +1,578 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * ranges of at most this many elements are finished with an insertion sort
+ */
+#define VECTOR_SELECT_SMALL     16
+
+/**
+ * top-K accumulator defenition. buffer holds up to 2k candidates, after every compaction its first k
+ * elements are the largest seen and threshold is a copy of the smallest of them.
+ */
+struct vector_topk_t
+{
+    vector_t *buffer;           /** candidates */
+    uint8_t *threshold;         /** elements not larger than this one are dropped once bounded is set */
+    size_t k;                   /** number of elements kept */
+    bool bounded;               /** the buffer was compacted at least once */
+    vector_compare_t compare;   /** element order, NULL for integer keys */
+};
+
+static inline size_t vector_select_depth(const size_t n)
+{
+    // introsort gives up on quick partitioning after 2 log2(n) rounds
+    return 2 * (63 - __builtin_clzll(n | 1));
+}
+
+//==============================================================================
+// Integer key kernels
+//==============================================================================
+
+/**
+ * the kernels for one key type. vector_partition moves the median of the first, middle and last keys to the
+ * front and Hoare partitions around it, returning s with 0 < s < n, items[0..s) <= pivot <= items[s..n).
+ */
+#define VECTOR_SELECT_KERNELS(type, bits)                                                                   \
+    static inline void vector_swap##bits(type* items, const size_t i, const size_t j)                       \
+    {                                                                                                       \
+        const type key = items[i];                                                                          \
+        items[i] = items[j];                                                                                \
+        items[j] = key;                                                                                     \
+    }                                                                                                       \
+                                                                                                            \
+    static void vector_insertion_sort##bits(type* items, const size_t n)                                    \
+    {                                                                                                       \
+        for (size_t i = 1; i < n; i++)                                                                      \
+        {                                                                                                   \
+            const type key = items[i];                                                                      \
+            size_t j = i;                                                                                   \
+            for (; j > 0 && key < items[j - 1]; j--)                                                        \
+            {                                                                                               \
+                items[j] = items[j - 1];                                                                    \
+            }                                                                                               \
+            items[j] = key;                                                                                 \
+        }                                                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    static void vector_sift_down##bits(type* items, size_t root, const size_t n)                            \
+    {                                                                                                       \
+        const type key = items[root];                                                                       \
+        for (size_t child = 2 * root + 1; child < n; child = 2 * root + 1)                                  \
+        {                                                                                                   \
+            if (child + 1 < n && items[child] < items[child + 1])                                           \
+            {                                                                                               \
+                child++;                                                                                    \
+            }                                                                                               \
+            if (!(key < items[child]))                                                                      \
+            {                                                                                               \
+                break;                                                                                      \
+            }                                                                                               \
+            items[root] = items[child];                                                                     \
+            root = child;                                                                                   \
+        }                                                                                                   \
+        items[root] = key;                                                                                  \
+    }                                                                                                       \
+                                                                                                            \
+    static void vector_heap_sort##bits(type* items, const size_t n)                                         \
+    {                                                                                                       \
+        for (size_t i = n / 2; i-- > 0;)                                                                    \
+        {                                                                                                   \
+            vector_sift_down##bits(items, i, n);                                                            \
+        }                                                                                                   \
+        for (size_t i = n; i-- > 1;)                                                                        \
+        {                                                                                                   \
+            vector_swap##bits(items, 0, i);                                                                 \
+            vector_sift_down##bits(items, 0, i);                                                            \
+        }                                                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_partition##bits(type* items, const size_t n)                                       \
+    {                                                                                                       \
+        const size_t mid = n / 2;                                                                           \
+        if (items[mid] < items[0])                                                                          \
+        {                                                                                                   \
+            vector_swap##bits(items, 0, mid);                                                               \
+        }                                                                                                   \
+        if (items[n - 1] < items[0])                                                                        \
+        {                                                                                                   \
+            vector_swap##bits(items, 0, n - 1);                                                             \
+        }                                                                                                   \
+        if (items[n - 1] < items[mid])                                                                      \
+        {                                                                                                   \
+            vector_swap##bits(items, mid, n - 1);                                                           \
+        }                                                                                                   \
+        vector_swap##bits(items, 0, mid);                                                                   \
+                                                                                                            \
+        const type pivot = items[0];                                                                        \
+        size_t i = 0, j = n - 1;                                                                            \
+        for (;;)                                                                                            \
+        {                                                                                                   \
+            while (items[i] < pivot)                                                                        \
+            {                                                                                               \
+                i++;                                                                                        \
+            }                                                                                               \
+            while (pivot < items[j])                                                                        \
+            {                                                                                               \
+                j--;                                                                                        \
+            }                                                                                               \
+            if (i >= j)                                                                                     \
+            {                                                                                               \
+                return j + 1;                                                                               \
+            }                                                                                               \
+            vector_swap##bits(items, i++, j--);                                                             \
+        }                                                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    static void vector_select##bits(type* items, size_t n, size_t nth)                                      \
+    {                                                                                                       \
+        size_t depth = vector_select_depth(n);                                                              \
+        while (n > VECTOR_SELECT_SMALL)                                                                     \
+        {                                                                                                   \
+            if (depth-- == 0)                                                                               \
+            {                                                                                               \
+                vector_heap_sort##bits(items, n);                                                           \
+                return;                                                                                     \
+            }                                                                                               \
+            const size_t split = vector_partition##bits(items, n);                                          \
+            if (nth < split)                                                                                \
+            {                                                                                               \
+                n = split;                                                                                  \
+            }                                                                                               \
+            else                                                                                            \
+            {                                                                                               \
+                items += split;                                                                             \
+                n -= split;                                                                                 \
+                nth -= split;                                                                               \
+            }                                                                                               \
+        }                                                                                                   \
+        vector_insertion_sort##bits(items, n);                                                              \
+    }                                                                                                       \
+                                                                                                            \
+    static void vector_sort##bits(type* items, size_t n, size_t depth)                                      \
+    {                                                                                                       \
+        while (n > VECTOR_SELECT_SMALL)                                                                     \
+        {                                                                                                   \
+            if (depth-- == 0)                                                                               \
+            {                                                                                               \
+                vector_heap_sort##bits(items, n);                                                           \
+                return;                                                                                     \
+            }                                                                                               \
+            /* recurse into the smaller side and loop on the larger one */                                  \
+            const size_t split = vector_partition##bits(items, n);                                          \
+            if (split < n - split)                                                                          \
+            {                                                                                               \
+                vector_sort##bits(items, split, depth);                                                     \
+                items += split;                                                                             \
+                n -= split;                                                                                 \
+            }                                                                                               \
+            else                                                                                            \
+            {                                                                                               \
+                vector_sort##bits(items + split, n - split, depth);                                         \
+                n = split;                                                                                  \
+            }                                                                                               \
+        }                                                                                                   \
+        vector_insertion_sort##bits(items, n);                                                              \
+    }
+
+VECTOR_SELECT_KERNELS(uint32_t, 32)
+VECTOR_SELECT_KERNELS(uint64_t, 64)
+
+//==============================================================================
+// Comparator kernels
+//==============================================================================
+
+/**
+ * the same partition over elements of stride bytes ordered by compare, scratch holds two elements
+ */
+static size_t vector_partition_generic(uint8_t* items, const size_t n, const size_t stride,
+        vector_compare_t compare, uint8_t* scratch)
+{
+#define ITEM(i)         (items + (i) * stride)
+#define SWAP(i, j)                                                                          \
+    do                                                                                      \
+    {                                                                                       \
+        ccollection_copy(scratch, ITEM(i), stride);                                         \
+        ccollection_copy(ITEM(i), ITEM(j), stride);                                         \
+        ccollection_copy(ITEM(j), scratch, stride);                                         \
+    } while (0)
+
+    const size_t mid = n / 2;
+    if (compare(ITEM(mid), ITEM(0)) < 0)
+    {
+        SWAP(0, mid);
+    }
+    if (compare(ITEM(n - 1), ITEM(0)) < 0)
+    {
+        SWAP(0, n - 1);
+    }
+    if (compare(ITEM(n - 1), ITEM(mid)) < 0)
+    {
+        SWAP(mid, n - 1);
+    }
+    SWAP(0, mid);
+
+    uint8_t *pivot = scratch + stride;
+    ccollection_copy(pivot, ITEM(0), stride);
+    size_t i = 0, j = n - 1;
+    for (;;)
+    {
+        while (compare(ITEM(i), pivot) < 0)
+        {
+            i++;
+        }
+        while (compare(pivot, ITEM(j)) < 0)
+        {
+            j--;
+        }
+        if (i >= j)
+        {
+            return j + 1;
+        }
+        SWAP(i, j);
+        i++;
+        j--;
+    }
+
+#undef SWAP
+#undef ITEM
+}
+
+/**
+ * introselect over elements ordered by compare, small ranges and the worst case are left to qsort
+ */
+static void vector_select_generic(uint8_t* items, size_t n, size_t nth, const size_t stride,
+        vector_compare_t compare, uint8_t* scratch)
+{
+    size_t depth = vector_select_depth(n);
+    while (n > VECTOR_SELECT_SMALL && depth-- > 0)
+    {
+        const size_t split = vector_partition_generic(items, n, stride, compare, scratch);
+        if (nth < split)
+        {
+            n = split;
+        }
+        else
+        {
+            items += split * stride;
+            n -= split;
+            nth -= split;
+        }
+    }
+    qsort(items, n, stride, compare);
+}
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+/**
+ * nth_element over the n elements at items laid out like those of vector
+ */
+static cerror_t vector_select_items(const vector_t* vector, uint8_t* items, const size_t n, const size_t nth,
+        vector_compare_t compare)
+{
+    if (compare == NULL && vector_packed_keys(vector))
+    {
+        if (vector->element_size == 4)
+        {
+            vector_select32((uint32_t*)items, n, nth);
+        }
+        else
+        {
+            vector_select64((uint64_t*)items, n, nth);
+        }
+        return ERROR_NONE;
+    }
+
+    if (compare == NULL)
+    {
+        compare = vector_compare_keys(vector->element_size);
+        ASSERT_E(compare != NULL, EBADELEMSIZE, ERROR_FAILED);
+    }
+    uint8_t *scratch = ccollection_calloc(2 * vector->stride);
+    ASSERT(scratch != NULL, ERROR_FAILED);
+
+    vector_select_generic(items, n, nth, vector->stride, compare, scratch);
+    ccollection_free(scratch);
+
+    return ERROR_NONE;
+}
+
+/**
+ * sort the n elements at items laid out like those of vector
+ */
+static cerror_t vector_sort_items(const vector_t* vector, uint8_t* items, const size_t n, vector_compare_t compare)
+{
+    if (compare == NULL && vector_packed_keys(vector))
+    {
+        if (vector->element_size == 4)
+        {
+            vector_sort32((uint32_t*)items, n, vector_select_depth(n));
+        }
+        else
+        {
+            vector_sort64((uint64_t*)items, n, vector_select_depth(n));
+        }
+        return ERROR_NONE;
+    }
+
+    if (compare == NULL)
+    {
+        compare = vector_compare_keys(vector->element_size);
+        ASSERT_E(compare != NULL, EBADELEMSIZE, ERROR_FAILED);
+    }
+    qsort(items, n, vector->stride, compare);
+
+    return ERROR_NONE;
+}
+
+/**
+ * keep the k largest candidates at the front of the buffer and remember the smallest of them
+ */
+static cerror_t vector_topk_compact(vector_topk_t* topk)
+{
+    vector_t *buffer = topk->buffer;
+    if (buffer->size <= topk->k)
+    {
+        return ERROR_NONE;
+    }
+
+    const size_t drop = buffer->size - topk->k;
+    ASSERT(vector_select_items(buffer, buffer->items, buffer->size, drop, topk->compare) == ERROR_NONE,
+            ERROR_FAILED);
+    ccollection_move(buffer->items, VECTOR_ITEM(buffer, drop), topk->k * buffer->stride);
+    buffer->size = topk->k;
+
+    ccollection_copy(topk->threshold, buffer->items, buffer->element_size);
+    topk->bounded = true;
+
+    return ERROR_NONE;
+}
+
+/**
+ * offer n keys, the threshold test is a plain comparison of integers
+ */
+#define VECTOR_TOPK_PUSH_KEYS(type, bits)                                                                   \
+    static cerror_t vector_topk_push_keys##bits(vector_topk_t* topk, const uint8_t* items, const size_t n,  \
+            const size_t stride)                                                                            \
+    {                                                                                                       \
+        vector_t *buffer = topk->buffer;                                                                    \
+        for (size_t i = 0; i < n; i++)                                                                      \
+        {                                                                                                   \
+            type key;                                                                                       \
+            ccollection_copy(&key, items + i * stride, sizeof(type));                                       \
+            if (topk->bounded && key <= *(const type*)topk->threshold)                                      \
+            {                                                                                               \
+                continue;                                                                                   \
+            }                                                                                               \
+            ((type*)buffer->items)[buffer->size++] = key;                                                   \
+            if (buffer->size == 2 * topk->k)                                                                \
+            {                                                                                               \
+                ASSERT(vector_topk_compact(topk) == ERROR_NONE, ERROR_FAILED);                              \
+            }                                                                                               \
+        }                                                                                                   \
+        return ERROR_NONE;                                                                                  \
+    }
+
+VECTOR_TOPK_PUSH_KEYS(uint32_t, 32)
+VECTOR_TOPK_PUSH_KEYS(uint64_t, 64)
+
+/**
+ * offer the n elements at items, stride bytes apart
+ */
+static cerror_t vector_topk_push_items(vector_topk_t* topk, const uint8_t* items, const size_t n,
+        const size_t stride)
+{
+    vector_t *buffer = topk->buffer;
+    if (topk->compare == NULL && vector_packed_keys(buffer))
+    {
+        return (buffer->element_size == 4) ? vector_topk_push_keys32(topk, items, n, stride) :
+            vector_topk_push_keys64(topk, items, n, stride);
+    }
+
+    const vector_compare_t compare = (topk->compare != NULL) ? topk->compare :
+        vector_compare_keys(buffer->element_size);
+    for (size_t i = 0; i < n; i++)
+    {
+        const uint8_t *item = items + i * stride;
+        if (topk->bounded && compare(item, topk->threshold) <= 0)
+        {
+            continue;
+        }
+        ccollection_copy(VECTOR_ITEM(buffer, buffer->size), item, buffer->element_size);
+        buffer->size++;
+        if (buffer->size == 2 * topk->k)
+        {
+            ASSERT(vector_topk_compact(topk) == ERROR_NONE, ERROR_FAILED);
+        }
+    }
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Selection
+//==============================================================================
+cerror_t vector_nth_element(vector_t* vector, const pos_t nth, vector_compare_t compare)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(nth >= 0 && (size_t)nth < vector->size, EOUTOFRANGE, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
+
+    return vector_select_items(vector, vector->items, vector->size, nth, compare);
+}
+
+cerror_t vector_partial_sort(vector_t* vector, const size_t count, vector_compare_t compare)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
+
+    const size_t n = MIN(count, vector->size);
+    if (n == 0)
+    {
+        return ERROR_NONE;
+    }
+    // select the boundary in linear time, then only the front needs sorting
+    if (n < vector->size)
+    {
+        ASSERT(vector_select_items(vector, vector->items, vector->size, n - 1, compare) == ERROR_NONE,
+                ERROR_FAILED);
+    }
+
+    return vector_sort_items(vector, vector->items, n, compare);
+}
+
+vector_topk_t* vector_topk_new(const size_t elem_size, const size_t k, vector_compare_t compare)
+{
+    errno = 0;
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, NULL);
+    ASSERT_E(k > 0, EINVAL, NULL);
+    ASSERT_E(compare != NULL || vector_compare_keys(elem_size) != NULL, EBADELEMSIZE, NULL);
+
+    vector_topk_t *topk = ccollection_calloc(sizeof(vector_topk_t));
+    ASSERT(topk != NULL, NULL);
+
+    topk->k = k;
+    topk->compare = compare;
+    topk->buffer = vector_new(elem_size);
+    topk->threshold = ccollection_calloc(elem_size);
+    if (topk->buffer == NULL || topk->threshold == NULL || vector_reserve(topk->buffer, 2 * k) != ERROR_NONE)
+    {
+        vector_topk_destroy(topk);
+        return NULL;
+    }
+
+    return topk;
+}
+
+cerror_t vector_topk_destroy(vector_topk_t* topk)
+{
+    ASSERT_E(topk != NULL, EBADPOINTER, ERROR_FAILED);
+
+    if (topk->buffer != NULL)
+    {
+        vector_destroy(topk->buffer);
+    }
+    ccollection_free(topk->threshold);
+    ccollection_free(topk);
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_topk_push_n(vector_topk_t* topk, const item_t* items, const size_t n)
+{
+    ASSERT_E(topk != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(n == 0 || items != NULL, EBADPOINTER, ERROR_FAILED);
+
+    return vector_topk_push_items(topk, items, n, topk->buffer->element_size);
+}
+
+cerror_t vector_topk_push_vector(vector_topk_t* topk, const vector_t* vector)
+{
+    ASSERT_E(topk != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(vector->element_size == topk->buffer->element_size, EBADELEMSIZE, ERROR_FAILED);
+
+    return vector_topk_push_items(topk, vector->items, vector->size, vector->stride);
+}
+
+cerror_t vector_topk_get(vector_topk_t* topk, vector_t* out)
+{
+    ASSERT_E(topk != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(out != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(out->element_size == topk->buffer->element_size, EBADELEMSIZE, ERROR_FAILED);
+    ASSERT(vector_topk_compact(topk) == ERROR_NONE, ERROR_FAILED);
+    ASSERT(vector_make_writable(out) == ERROR_NONE, ERROR_FAILED);
+
+    const vector_t *buffer = topk->buffer;
+    out->size = 0;
+    ASSERT(vector_reserve(out, MAX(buffer->size, 1)) == ERROR_NONE, ERROR_FAILED);
+    for (size_t i = 0; i < buffer->size; i++)
+    {
+        ccollection_copy(VECTOR_ITEM(out, i), VECTOR_ITEM(buffer, i), out->element_size);
+    }
+    out->size = buffer->size;
+    ASSERT(vector_sort_items(out, out->items, out->size, topk->compare) == ERROR_NONE, ERROR_FAILED);
+
+    // sorted ascending, reverse to put the largest first
+    uint8_t *scratch = ccollection_calloc(out->stride);
+    ASSERT(scratch != NULL, ERROR_FAILED);
+    for (size_t i = 0, j = out->size; i + 1 < j; i++, j--)
+    {
+        ccollection_copy(scratch, VECTOR_ITEM(out, i), out->stride);
+        ccollection_copy(VECTOR_ITEM(out, i), VECTOR_ITEM(out, j - 1), out->stride);
+        ccollection_copy(VECTOR_ITEM(out, j - 1), scratch, out->stride);
+    }
+    ccollection_free(scratch);
+    STATS_PEAK(out, peak_size, out->size);
+
+    return ERROR_NONE;
+}
+
+size_t vector_topk_get_size(const vector_topk_t* topk)
+{
+    return MIN(topk->buffer->size, topk->k);
+}
+
+cerror_t vector_topk_clear(vector_topk_t* topk)
+{
+    ASSERT_E(topk != NULL, EBADPOINTER, ERROR_FAILED);
+
+    topk->buffer->size = 0;
+    topk->bounded = false;
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
@@ -0,0 +1,400 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+
+EXTERN_C_BEGIN
+
+#define VECTOR_BLOB_MAGIC           "CCOLVSR"
+#define VECTOR_BLOB_VERSION         1
+#define VECTOR_BLOB_HEADER_SIZE     64          /** payload starts here, keeps views cache line aligned */
+
+/**
+ * header in front of every serialized vector
+ */
+typedef struct vector_blob_header_t
+{
+    char magic[8];              /** VECTOR_BLOB_MAGIC */
+    uint32_t version;           /** VECTOR_BLOB_VERSION */
+    uint32_t header_size;       /** offset of the payload */
+    uint64_t element_size;      /** size of one element */
+    uint64_t size;              /** number of elements in the payload */
+    uint64_t checksum;          /** vector_checksum of the payload */
+} vector_blob_header_t;
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+#define CHECKSUM_PRIME      0x9e3779b97f4a7c15ULL
+
+/**
+ * 64 bit checksum over a stream of bytes, four independent lanes so large payloads are not bound by multiply
+ * latency. Padded vectors feed it one element at a time so the result only depends on the packed payload.
+ */
+typedef struct vector_checksum_t
+{
+    uint64_t lanes[4];          /** running hash of every full 32 byte block */
+    uint8_t pending[32];        /** bytes not yet forming a full block */
+    size_t pending_length;      /** number of valid bytes in pending */
+    uint64_t length;            /** total number of bytes fed */
+} vector_checksum_t;
+
+static void vector_checksum_init(vector_checksum_t* checksum)
+{
+    memset(checksum, 0, sizeof(*checksum));
+    for (int i = 0; i < 4; i++)
+    {
+        checksum->lanes[i] = i + 1;
+    }
+}
+
+static void vector_checksum_block(vector_checksum_t* checksum, const uint8_t* data)
+{
+    uint64_t word;
+
+    for (int i = 0; i < 4; i++)
+    {
+        memcpy(&word, data + i * sizeof(word), sizeof(word));
+        checksum->lanes[i] = (checksum->lanes[i] ^ word) * CHECKSUM_PRIME;
+        checksum->lanes[i] ^= checksum->lanes[i] >> 29;
+    }
+}
+
+static void vector_checksum_update(vector_checksum_t* checksum, const uint8_t* data, size_t length)
+{
+    const size_t block = sizeof(checksum->pending);
+
+    checksum->length += length;
+    if (checksum->pending_length > 0)
+    {
+        size_t n = MIN(length, block - checksum->pending_length);
+        memcpy(checksum->pending + checksum->pending_length, data, n);
+        checksum->pending_length += n;
+        data += n;
+        length -= n;
+
+        if (checksum->pending_length < block)
+        {
+            return;
+        }
+        vector_checksum_block(checksum, checksum->pending);
+        checksum->pending_length = 0;
+    }
+    for (; length >= block; length -= block, data += block)
+    {
+        vector_checksum_block(checksum, data);
+    }
+    memcpy(checksum->pending, data, length);
+    checksum->pending_length = length;
+}
+
+static uint64_t vector_checksum_final(const vector_checksum_t* checksum)
+{
+    uint64_t hash = checksum->length;
+
+    for (int i = 0; i < 4; i++)
+    {
+        hash = (hash ^ checksum->lanes[i]) * CHECKSUM_PRIME;
+    }
+    for (size_t i = 0; i < checksum->pending_length; i++)
+    {
+        hash = (hash ^ checksum->pending[i]) * CHECKSUM_PRIME;
+    }
+
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * checksum of a packed payload
+ */
+static uint64_t vector_checksum(const uint8_t* data, const size_t length)
+{
+    vector_checksum_t checksum;
+
+    vector_checksum_init(&checksum);
+    vector_checksum_update(&checksum, data, length);
+
+    return vector_checksum_final(&checksum);
+}
+
+/**
+ * checksum of the elements of a vector as they appear in the packed payload
+ */
+static uint64_t vector_checksum_items(const vector_t* vector)
+{
+    if (vector->stride == vector->element_size)
+    {
+        return vector_checksum(vector->items, vector->size * vector->element_size);
+    }
+
+    vector_checksum_t checksum;
+
+    vector_checksum_init(&checksum);
+    for (size_t i = 0; i < vector->size; i++)
+    {
+        vector_checksum_update(&checksum, VECTOR_ITEM(vector, i), vector->element_size);
+    }
+
+    return vector_checksum_final(&checksum);
+}
+
+static void vector_blob_header_init(const vector_t* vector, vector_blob_header_t* header)
+{
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, VECTOR_BLOB_MAGIC, sizeof(header->magic));
+    header->version = VECTOR_BLOB_VERSION;
+    header->header_size = VECTOR_BLOB_HEADER_SIZE;
+    header->element_size = vector->element_size;
+    header->size = vector->size;
+    header->checksum = vector_checksum_items(vector);
+}
+
+/**
+ * validate a header read from a blob of buffer_size bytes, sets errno to EBADFORMAT if invalid
+ */
+static cerror_t vector_blob_header_check(const vector_blob_header_t* header, const size_t buffer_size)
+{
+    ASSERT_E(buffer_size >= VECTOR_BLOB_HEADER_SIZE, EBADFORMAT, ERROR_FAILED);
+    ASSERT_E(memcmp(header->magic, VECTOR_BLOB_MAGIC, sizeof(header->magic)) == 0, EBADFORMAT, ERROR_FAILED);
+    ASSERT_E(header->version == VECTOR_BLOB_VERSION, EBADFORMAT, ERROR_FAILED);
+    ASSERT_E(header->header_size == VECTOR_BLOB_HEADER_SIZE, EBADFORMAT, ERROR_FAILED);
+    ASSERT_E(header->element_size > 0, EBADFORMAT, ERROR_FAILED);
+    ASSERT_E(header->size <= (buffer_size - VECTOR_BLOB_HEADER_SIZE) / header->element_size, EBADFORMAT,
+            ERROR_FAILED);
+
+    return ERROR_NONE;
+}
+
+/**
+ * write or read exactly length bytes, restarting on short transfers
+ */
+static cerror_t vector_write_all(const int fd, const uint8_t* data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t n = write(fd, data, length);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        ASSERT(n > 0, ERROR_FAILED);
+        data += n;
+        length -= n;
+    }
+
+    return ERROR_NONE;
+}
+
+static cerror_t vector_read_all(const int fd, uint8_t* data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t n = read(fd, data, length);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        ASSERT(n >= 0, ERROR_FAILED);
+        ASSERT_E(n > 0, EBADFORMAT, ERROR_FAILED);
+        data += n;
+        length -= n;
+    }
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Serialization
+//==============================================================================
+size_t vector_serialized_size(const vector_t* vector)
+{
+    return VECTOR_BLOB_HEADER_SIZE + vector->size * vector->element_size;
+}
+
+cerror_t vector_serialize(const vector_t* vector, void* buffer, const size_t buffer_size)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(buffer != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(buffer_size >= vector_serialized_size(vector), ENOBUFS, ERROR_FAILED);
+
+    vector_blob_header_t header;
+    vector_blob_header_init(vector, &header);
+
+    uint8_t *out = buffer;
+    memset(out, 0, VECTOR_BLOB_HEADER_SIZE);
+    memcpy(out, &header, sizeof(header));
+    out += VECTOR_BLOB_HEADER_SIZE;
+
+    if (vector->stride == vector->element_size)
+    {
+        ccollection_copy(out, vector->items, vector->size * vector->element_size);
+        return ERROR_NONE;
+    }
+    for (size_t i = 0; i < vector->size; i++, out += vector->element_size)
+    {
+        ccollection_copy(out, VECTOR_ITEM(vector, i), vector->element_size);
+    }
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_serialize_fd(const vector_t* vector, const int fd)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+
+    uint8_t out[VECTOR_BLOB_HEADER_SIZE] = { 0 };
+    vector_blob_header_t header;
+    vector_blob_header_init(vector, &header);
+    memcpy(out, &header, sizeof(header));
+
+    ASSERT(vector_write_all(fd, out, sizeof(out)) == ERROR_NONE, ERROR_FAILED);
+
+    if (vector->stride == vector->element_size)
+    {
+        return vector_write_all(fd, vector->items, vector->size * vector->element_size);
+    }
+
+    // pack padded elements through a bounce buffer so every write stays large
+    uint8_t chunk[1 << 16];
+    size_t length = 0;
+    for (size_t i = 0; i < vector->size; i++)
+    {
+        if (length + vector->element_size > sizeof(chunk))
+        {
+            ASSERT(vector_write_all(fd, chunk, length) == ERROR_NONE, ERROR_FAILED);
+            length = 0;
+        }
+        if (vector->element_size > sizeof(chunk))
+        {
+            ASSERT(vector_write_all(fd, VECTOR_ITEM(vector, i), vector->element_size) == ERROR_NONE, ERROR_FAILED);
+            continue;
+        }
+        ccollection_copy(chunk + length, VECTOR_ITEM(vector, i), vector->element_size);
+        length += vector->element_size;
+    }
+
+    return vector_write_all(fd, chunk, length);
+}
+
+vector_t* vector_deserialize(const void* buffer, const size_t buffer_size)
+{
+    errno = 0;
+    ASSERT_E(buffer != NULL, EBADPOINTER, NULL);
+    ASSERT_E(buffer_size >= VECTOR_BLOB_HEADER_SIZE, EBADFORMAT, NULL);
+
+    const uint8_t *in = buffer;
+    vector_blob_header_t header;
+    memcpy(&header, in, sizeof(header));
+
+    ASSERT(vector_blob_header_check(&header, buffer_size) == ERROR_NONE, NULL);
+
+    const size_t length = header.size * header.element_size;
+    ASSERT_E(vector_checksum(in + VECTOR_BLOB_HEADER_SIZE, length) == header.checksum, EBADFORMAT, NULL);
+
+    vector_t *vector = vector_new(header.element_size);
+    ASSERT(vector != NULL, NULL);
+
+    if (vector_reserve(vector, MAX(header.size, 1)) != ERROR_NONE)
+    {
+        vector_destroy(vector);
+        return NULL;
+    }
+    ccollection_copy(vector->items, in + VECTOR_BLOB_HEADER_SIZE, length);
+    vector->size = header.size;
+    STATS_PEAK(vector, peak_size, vector->size);
+
+    return vector;
+}
+
+vector_t* vector_deserialize_fd(const int fd)
+{
+    errno = 0;
+
+    uint8_t in[VECTOR_BLOB_HEADER_SIZE];
+    ASSERT(vector_read_all(fd, in, sizeof(in)) == ERROR_NONE, NULL);
+
+    vector_blob_header_t header;
+    memcpy(&header, in, sizeof(header));
+
+    // payload size is not known up front, only check that it fits in memory
+    ASSERT(vector_blob_header_check(&header, SIZE_MAX) == ERROR_NONE, NULL);
+
+    vector_t *vector = vector_new(header.element_size);
+    ASSERT(vector != NULL, NULL);
+
+    const size_t length = header.size * header.element_size;
+    if (vector_reserve(vector, MAX(header.size, 1)) != ERROR_NONE ||
+            vector_read_all(fd, vector->items, length) != ERROR_NONE)
+    {
+        int err = errno;
+        vector_destroy(vector);
+        errno = err;
+        return NULL;
+    }
+    if (vector_checksum(vector->items, length) != header.checksum)
+    {
+        vector_destroy(vector);
+        errno = EBADFORMAT;
+        return NULL;
+    }
+    vector->size = header.size;
+    STATS_PEAK(vector, peak_size, vector->size);
+
+    return vector;
+}
+
+vector_t* vector_view(const void* buffer, const size_t buffer_size)
+{
+    errno = 0;
+    ASSERT_E(buffer != NULL, EBADPOINTER, NULL);
+    ASSERT_E(buffer_size >= VECTOR_BLOB_HEADER_SIZE, EBADFORMAT, NULL);
+
+    const uint8_t *in = buffer;
+    vector_blob_header_t header;
+    memcpy(&header, in, sizeof(header));
+
+    ASSERT(vector_blob_header_check(&header, buffer_size) == ERROR_NONE, NULL);
+
+    vector_t *vector = ccollection_calloc(sizeof(vector_t));
+    ASSERT(vector != NULL, NULL);
+
+    vector->storage = VECTOR_STORAGE_VIEW;
+    vector->items = (uint8_t*)(in + VECTOR_BLOB_HEADER_SIZE);
+    vector->element_size = header.element_size;
+    vector->stride = header.element_size;
+    vector->size = header.size;
+    vector->capacity = header.size;
+    STATS_REGISTER(vector, "vector");
+
+    return vector;
+}
+
+EXTERN_C_END
@@ -0,0 +1,826 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "src/vector-internal.h"
+#include "src/cpu-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#ifdef CCOLLECTION_SIMD
+    #include <immintrin.h>
+#endif
+
+EXTERN_C_BEGIN
+
+/**
+ * an intersection or difference gallops through the larger input when it is this many times the smaller one
+ */
+#define VECTOR_GALLOP_RATIO     32
+
+/**
+ * kernels over packed 32 and 64 bit integer keys, one set per instruction set. They return the number of
+ * elements written to out, or kept in items for unique.
+ */
+typedef struct vector_set_kernels_t
+{
+    size_t (*unique32)(uint32_t* items, const size_t n);
+    size_t (*unique64)(uint64_t* items, const size_t n);
+    size_t (*intersection32)(const uint32_t* first, const size_t n1, const uint32_t* second, const size_t n2,
+            uint32_t* out);
+    size_t (*intersection64)(const uint64_t* first, const size_t n1, const uint64_t* second, const size_t n2,
+            uint64_t* out);
+    size_t (*difference32)(const uint32_t* first, const size_t n1, const uint32_t* second, const size_t n2,
+            uint32_t* out);
+    size_t (*difference64)(const uint64_t* first, const size_t n1, const uint64_t* second, const size_t n2,
+            uint64_t* out);
+} vector_set_kernels_t;
+
+//==============================================================================
+// Integer key kernels
+//==============================================================================
+
+/**
+ * append key to out unless it repeats the last key written, out stays strictly increasing
+ */
+#define VECTOR_SET_EMIT(out, w, key)                                                        \
+    if ((w) == 0 || (out)[(w) - 1] != (key))                                                \
+    {                                                                                       \
+        (out)[(w)++] = (key);                                                               \
+    }
+
+/**
+ * the scalar kernels for one key type. The _scalar functions resume where a SIMD kernel stopped: at i and j
+ * with w keys already in out. A difference also takes the lanes of first[i..] a SIMD kernel already found
+ * in second, and the last key found, whose repeats must be skipped too.
+ */
+#define VECTOR_SET_SCALAR(type, bits)                                                                       \
+    static size_t vector_gallop##bits(const type* items, const size_t start, const size_t n, const type key)\
+    {                                                                                                       \
+        if (start >= n || items[start] >= key)                                                              \
+        {                                                                                                   \
+            return start;                                                                                   \
+        }                                                                                                   \
+        size_t bound = 1;                                                                                   \
+        while (start + bound < n && items[start + bound] < key)                                             \
+        {                                                                                                   \
+            bound <<= 1;                                                                                    \
+        }                                                                                                   \
+        size_t low = start + bound / 2 + 1;                                                                 \
+        size_t high = MIN(start + bound, n);                                                                \
+        while (low < high)                                                                                  \
+        {                                                                                                   \
+            const size_t mid = low + (high - low) / 2;                                                      \
+            if (items[mid] < key)                                                                           \
+            {                                                                                               \
+                low = mid + 1;                                                                              \
+            }                                                                                               \
+            else                                                                                            \
+            {                                                                                               \
+                high = mid;                                                                                 \
+            }                                                                                               \
+        }                                                                                                   \
+        return low;                                                                                         \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_unique##bits##_scalar(type* items, size_t i, const size_t n, size_t w)             \
+    {                                                                                                       \
+        for (; i < n; i++)                                                                                  \
+        {                                                                                                   \
+            if (items[i] != items[w - 1])                                                                   \
+            {                                                                                               \
+                items[w++] = items[i];                                                                      \
+            }                                                                                               \
+        }                                                                                                   \
+        return w;                                                                                           \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_unique##bits##_generic(type* items, const size_t n)                                \
+    {                                                                                                       \
+        return (n == 0) ? 0 : vector_unique##bits##_scalar(items, 1, n, 1);                                 \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_merge##bits(const type* first, const size_t n1, const type* second,                \
+            const size_t n2, type* out)                                                                     \
+    {                                                                                                       \
+        size_t i = 0, j = 0, w = 0;                                                                         \
+        while (i < n1 && j < n2)                                                                            \
+        {                                                                                                   \
+            const bool take_first = (first[i] <= second[j]);                                                \
+            out[w++] = take_first ? first[i] : second[j];                                                   \
+            i += take_first;                                                                                \
+            j += !take_first;                                                                               \
+        }                                                                                                   \
+        ccollection_copy(out + w, first + i, (n1 - i) * sizeof(type));                                     \
+        w += n1 - i;                                                                                        \
+        ccollection_copy(out + w, second + j, (n2 - j) * sizeof(type));                                     \
+        return w + n2 - j;                                                                                  \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_union##bits(const type* first, const size_t n1, const type* second,                \
+            const size_t n2, type* out)                                                                     \
+    {                                                                                                       \
+        size_t i = 0, j = 0, w = 0;                                                                         \
+        while (i < n1 && j < n2)                                                                            \
+        {                                                                                                   \
+            const type a = first[i];                                                                        \
+            const type b = second[j];                                                                       \
+            const type key = (a < b) ? a : b;                                                               \
+            i += (a <= b);                                                                                  \
+            j += (b <= a);                                                                                  \
+            VECTOR_SET_EMIT(out, w, key)                                                                    \
+        }                                                                                                   \
+        for (; i < n1; i++)                                                                                 \
+        {                                                                                                   \
+            VECTOR_SET_EMIT(out, w, first[i])                                                               \
+        }                                                                                                   \
+        for (; j < n2; j++)                                                                                 \
+        {                                                                                                   \
+            VECTOR_SET_EMIT(out, w, second[j])                                                              \
+        }                                                                                                   \
+        return w;                                                                                           \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_intersection##bits##_scalar(const type* first, size_t i, const size_t n1,          \
+            const type* second, size_t j, const size_t n2, type* out, size_t w)                             \
+    {                                                                                                       \
+        if ((n1 - i) * VECTOR_GALLOP_RATIO < n2 - j)                                                        \
+        {                                                                                                   \
+            for (; i < n1 && j < n2; i++)                                                                   \
+            {                                                                                               \
+                j = vector_gallop##bits(second, j, n2, first[i]);                                           \
+                if (j < n2 && second[j] == first[i])                                                        \
+                {                                                                                           \
+                    VECTOR_SET_EMIT(out, w, first[i])                                                       \
+                }                                                                                           \
+            }                                                                                               \
+            return w;                                                                                       \
+        }                                                                                                   \
+        if ((n2 - j) * VECTOR_GALLOP_RATIO < n1 - i)                                                        \
+        {                                                                                                   \
+            for (; j < n2 && i < n1; j++)                                                                   \
+            {                                                                                               \
+                i = vector_gallop##bits(first, i, n1, second[j]);                                           \
+                if (i < n1 && first[i] == second[j])                                                        \
+                {                                                                                           \
+                    VECTOR_SET_EMIT(out, w, second[j])                                                      \
+                }                                                                                           \
+            }                                                                                               \
+            return w;                                                                                       \
+        }                                                                                                   \
+        while (i < n1 && j < n2)                                                                            \
+        {                                                                                                   \
+            const type a = first[i];                                                                        \
+            const type b = second[j];                                                                       \
+            if (a == b)                                                                                     \
+            {                                                                                               \
+                VECTOR_SET_EMIT(out, w, a)                                                                  \
+            }                                                                                               \
+            i += (a <= b);                                                                                  \
+            j += (b <= a);                                                                                  \
+        }                                                                                                   \
+        return w;                                                                                           \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_intersection##bits##_generic(const type* first, const size_t n1,                   \
+            const type* second, const size_t n2, type* out)                                                 \
+    {                                                                                                       \
+        return vector_intersection##bits##_scalar(first, 0, n1, second, 0, n2, out, 0);                     \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_difference##bits##_scalar(const type* first, size_t i, const size_t n1,            \
+            const type* second, size_t j, const size_t n2, type* out, size_t w, uint32_t found,             \
+            bool seen, type last_found)                                                                     \
+    {                                                                                                       \
+        if (found == 0 && (n1 - i) * VECTOR_GALLOP_RATIO < n2 - j)                                          \
+        {                                                                                                   \
+            for (; i < n1; i++)                                                                             \
+            {                                                                                               \
+                const type a = first[i];                                                                    \
+                j = vector_gallop##bits(second, j, n2, a);                                                  \
+                if ((j >= n2 || second[j] != a) && !(seen && last_found == a))                              \
+                {                                                                                           \
+                    VECTOR_SET_EMIT(out, w, a)                                                              \
+                }                                                                                           \
+            }                                                                                               \
+            return w;                                                                                       \
+        }                                                                                                   \
+        for (; i < n1; i++, found >>= 1)                                                                    \
+        {                                                                                                   \
+            const type a = first[i];                                                                        \
+            while (!(found & 1) && j < n2 && second[j] < a)                                                 \
+            {                                                                                               \
+                j++;                                                                                        \
+            }                                                                                               \
+            if ((found & 1) || (j < n2 && second[j] == a))                                                  \
+            {                                                                                               \
+                seen = true;                                                                                \
+                last_found = a;                                                                             \
+            }                                                                                               \
+            else if (!(seen && last_found == a))                                                            \
+            {                                                                                               \
+                VECTOR_SET_EMIT(out, w, a)                                                                  \
+            }                                                                                               \
+        }                                                                                                   \
+        return w;                                                                                           \
+    }                                                                                                       \
+                                                                                                            \
+    static size_t vector_difference##bits##_generic(const type* first, const size_t n1,                     \
+            const type* second, const size_t n2, type* out)                                                 \
+    {                                                                                                       \
+        return vector_difference##bits##_scalar(first, 0, n1, second, 0, n2, out, 0, 0, false, 0);         \
+    }
+
+VECTOR_SET_SCALAR(uint32_t, 32)
+VECTOR_SET_SCALAR(uint64_t, 64)
+
+static const vector_set_kernels_t vector_set_kernels_generic = {
+    vector_unique32_generic,
+    vector_unique64_generic,
+    vector_intersection32_generic,
+    vector_intersection64_generic,
+    vector_difference32_generic,
+    vector_difference64_generic,
+};
+
+//==============================================================================
+// SIMD kernels
+//==============================================================================
+#ifdef CCOLLECTION_SIMD
+
+/**
+ * permutation moving the 32 bit lanes set in mask to the front, in order
+ */
+CCOLLECTION_TARGET("avx2,bmi2")
+static inline __m256i vector_set_compress(const uint32_t mask)
+{
+    // one nibble per lane holding its index, pext drops the nibbles of the lanes not kept
+    const uint32_t expanded = _pdep_u32(mask, 0x11111111) * 0xf;
+    const uint32_t packed = _pext_u32(0x76543210, expanded);
+    return _mm256_srlv_epi32(_mm256_set1_epi32(packed), _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28));
+}
+
+/**
+ * compare every key of the block at first with every key of the block at second by rotating the second one,
+ * bit k of the result is set when first[k] is found
+ */
+CCOLLECTION_TARGET("avx2")
+static inline uint32_t vector_set_match32(const uint32_t* first, const uint32_t* second)
+{
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    const __m256i a = _mm256_loadu_si256((const __m256i*)first);
+    __m256i b = _mm256_loadu_si256((const __m256i*)second);
+    __m256i match = _mm256_cmpeq_epi32(a, b);
+    for (int k = 1; k < 8; k++)
+    {
+        b = _mm256_permutevar8x32_epi32(b, rotate);
+        match = _mm256_or_si256(match, _mm256_cmpeq_epi32(a, b));
+    }
+    return _mm256_movemask_ps(_mm256_castsi256_ps(match));
+}
+
+CCOLLECTION_TARGET("avx2")
+static inline uint32_t vector_set_match64(const uint64_t* first, const uint64_t* second)
+{
+    const __m256i a = _mm256_loadu_si256((const __m256i*)first);
+    __m256i b = _mm256_loadu_si256((const __m256i*)second);
+    __m256i match = _mm256_cmpeq_epi64(a, b);
+    for (int k = 1; k < 4; k++)
+    {
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        match = _mm256_or_si256(match, _mm256_cmpeq_epi64(a, b));
+    }
+    return _mm256_movemask_pd(_mm256_castsi256_pd(match));
+}
+
+/**
+ * drop the keys equal to their predecessor block by block, compressing the kept ones in place. The last key
+ * of a block is read before the store, which may overwrite it.
+ */
+CCOLLECTION_TARGET("avx2,bmi2,popcnt")
+static size_t vector_unique32_avx2(uint32_t* items, const size_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    const __m256i shift = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+    uint32_t last = items[0];
+    size_t i = 1, w = 1;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i current = _mm256_loadu_si256((const __m256i*)(items + i));
+        const __m256i previous = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(current, shift),
+                _mm256_set1_epi32(last), 0x01);
+        const uint32_t keep = ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(current, previous))) & 0xff;
+
+        last = items[i + 7];
+        _mm256_storeu_si256((__m256i*)(items + w), _mm256_permutevar8x32_epi32(current, vector_set_compress(keep)));
+        w += _mm_popcnt_u32(keep);
+    }
+    return vector_unique32_scalar(items, i, n, w);
+}
+
+CCOLLECTION_TARGET("avx2,bmi2,popcnt")
+static size_t vector_unique64_avx2(uint64_t* items, const size_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    uint64_t last = items[0];
+    size_t i = 1, w = 1;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m256i current = _mm256_loadu_si256((const __m256i*)(items + i));
+        const __m256i previous = _mm256_blend_epi32(_mm256_permute4x64_epi64(current, _MM_SHUFFLE(2, 1, 0, 0)),
+                _mm256_set1_epi64x(last), 0x03);
+        const uint32_t keep = ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(current, previous))) & 0xf;
+
+        // every 64 bit lane is a pair of 32 bit lanes
+        last = items[i + 3];
+        _mm256_storeu_si256((__m256i*)(items + w),
+                _mm256_permutevar8x32_epi32(current, vector_set_compress(_pdep_u32(keep, 0x55) * 3)));
+        w += _mm_popcnt_u32(keep);
+    }
+    return vector_unique64_scalar(items, i, n, w);
+}
+
+/**
+ * block intersection: compare a block of each input all against all, then advance the block whose last key
+ * is smaller, or both. Keys found are emitted right away, they only grow from block to block.
+ */
+#define VECTOR_SET_INTERSECTION_AVX2(type, bits, lanes)                                                     \
+    CCOLLECTION_TARGET("avx2")                                                                              \
+    static size_t vector_intersection##bits##_avx2(const type* first, const size_t n1, const type* second,  \
+            const size_t n2, type* out)                                                                     \
+    {                                                                                                       \
+        size_t i = 0, j = 0, w = 0;                                                                         \
+        /* skewed sizes are left to galloping */                                                            \
+        if (n1 * VECTOR_GALLOP_RATIO >= n2 && n2 * VECTOR_GALLOP_RATIO >= n1)                               \
+        {                                                                                                   \
+            while (i + lanes <= n1 && j + lanes <= n2)                                                      \
+            {                                                                                               \
+                uint32_t match = vector_set_match##bits(first + i, second + j);                             \
+                while (match != 0)                                                                          \
+                {                                                                                           \
+                    const type key = first[i + __builtin_ctz(match)];                                       \
+                    VECTOR_SET_EMIT(out, w, key)                                                            \
+                    match &= match - 1;                                                                     \
+                }                                                                                           \
+                const type last1 = first[i + lanes - 1];                                                    \
+                const type last2 = second[j + lanes - 1];                                                   \
+                i += (last1 <= last2) ? lanes : 0;                                                          \
+                j += (last2 <= last1) ? lanes : 0;                                                          \
+            }                                                                                               \
+        }                                                                                                   \
+        return vector_intersection##bits##_scalar(first, i, n1, second, j, n2, out, w);                     \
+    }
+
+/**
+ * block difference: the keys of a block of first found in any block of second it met are collected until
+ * the block is left, then the others are emitted. The first block holding a key always meets the block of
+ * second holding it, later repeats are caught by last_found.
+ */
+#define VECTOR_SET_DIFFERENCE_AVX2(type, bits, lanes)                                                       \
+    CCOLLECTION_TARGET("avx2")                                                                              \
+    static size_t vector_difference##bits##_avx2(const type* first, const size_t n1, const type* second,    \
+            const size_t n2, type* out)                                                                     \
+    {                                                                                                       \
+        size_t i = 0, j = 0, w = 0;                                                                         \
+        uint32_t found = 0;                                                                                 \
+        bool seen = false;                                                                                  \
+        type last_found = 0;                                                                                \
+        if (n1 * VECTOR_GALLOP_RATIO >= n2)                                                                 \
+        {                                                                                                   \
+            while (i + lanes <= n1 && j + lanes <= n2)                                                      \
+            {                                                                                               \
+                found |= vector_set_match##bits(first + i, second + j);                                     \
+                const type last1 = first[i + lanes - 1];                                                    \
+                const type last2 = second[j + lanes - 1];                                                   \
+                j += (last2 <= last1) ? lanes : 0;                                                          \
+                if (last1 <= last2)                                                                         \
+                {                                                                                           \
+                    for (size_t k = 0; k < lanes; k++)                                                      \
+                    {                                                                                       \
+                        const type key = first[i + k];                                                      \
+                        if (found & (1u << k))                                                              \
+                        {                                                                                   \
+                            seen = true;                                                                    \
+                            last_found = key;                                                               \
+                        }                                                                                   \
+                        else if (!(seen && last_found == key))                                              \
+                        {                                                                                   \
+                            VECTOR_SET_EMIT(out, w, key)                                                    \
+                        }                                                                                   \
+                    }                                                                                       \
+                    i += lanes;                                                                             \
+                    found = 0;                                                                              \
+                }                                                                                           \
+            }                                                                                               \
+        }                                                                                                   \
+        return vector_difference##bits##_scalar(first, i, n1, second, j, n2, out, w, found, seen, last_found);\
+    }
+
+VECTOR_SET_INTERSECTION_AVX2(uint32_t, 32, 8)
+VECTOR_SET_INTERSECTION_AVX2(uint64_t, 64, 4)
+VECTOR_SET_DIFFERENCE_AVX2(uint32_t, 32, 8)
+VECTOR_SET_DIFFERENCE_AVX2(uint64_t, 64, 4)
+
+static const vector_set_kernels_t vector_set_kernels_avx2 = {
+    vector_unique32_avx2,
+    vector_unique64_avx2,
+    vector_intersection32_avx2,
+    vector_intersection64_avx2,
+    vector_difference32_avx2,
+    vector_difference64_avx2,
+};
+
+#endif
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static const vector_set_kernels_t *vector_set_active_kernels = &vector_set_kernels_generic;
+static pthread_once_t vector_set_kernels_once = PTHREAD_ONCE_INIT;
+
+static void vector_set_select_kernels(void)
+{
+#ifdef CCOLLECTION_SIMD
+    if (ccollection_cpu_avx2() && ccollection_cpu_bmi2() && ccollection_cpu_popcnt())
+    {
+        vector_set_active_kernels = &vector_set_kernels_avx2;
+    }
+#endif
+}
+
+static inline const vector_set_kernels_t* vector_set_kernels(void)
+{
+    pthread_once(&vector_set_kernels_once, vector_set_select_kernels);
+    return vector_set_active_kernels;
+}
+
+#define VECTOR_COMPARE_KEYS(type)                                                           \
+    static int vector_compare_##type(const item_t* first, const item_t* second)             \
+    {                                                                                       \
+        type a, b;                                                                          \
+        ccollection_copy(&a, first, sizeof(type));                                          \
+        ccollection_copy(&b, second, sizeof(type));                                         \
+        return (a > b) - (a < b);                                                           \
+    }
+
+VECTOR_COMPARE_KEYS(uint8_t)
+VECTOR_COMPARE_KEYS(uint16_t)
+VECTOR_COMPARE_KEYS(uint32_t)
+VECTOR_COMPARE_KEYS(uint64_t)
+
+vector_compare_t vector_compare_keys(const size_t size)
+{
+    switch (size)
+    {
+        case 1:
+            return vector_compare_uint8_t;
+        case 2:
+            return vector_compare_uint16_t;
+        case 4:
+            return vector_compare_uint32_t;
+        case 8:
+            return vector_compare_uint64_t;
+        default:
+            return NULL;
+    }
+}
+
+bool vector_packed_keys(const vector_t* vector)
+{
+    return vector->stride == vector->element_size && (vector->element_size == 4 || vector->element_size == 8);
+}
+
+/**
+ * check the arguments of a set operation, empty out and make room for bound elements. A NULL compare is
+ * replaced by the integer key comparison, keys tells whether the integer kernels apply.
+ */
+static cerror_t vector_set_prepare(const vector_t* first, const vector_t* second, vector_t* out,
+        vector_compare_t* compare, bool* keys, const size_t bound)
+{
+    ASSERT_E(first != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(second != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(out != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(out != first && out != second, EINVAL, ERROR_FAILED);
+    ASSERT_E(first->element_size == second->element_size && first->element_size == out->element_size,
+            EBADELEMSIZE, ERROR_FAILED);
+
+    *keys = (*compare == NULL) && vector_packed_keys(first) && vector_packed_keys(second) &&
+        vector_packed_keys(out);
+    if (*compare == NULL)
+    {
+        *compare = vector_compare_keys(first->element_size);
+        ASSERT_E(*compare != NULL, EBADELEMSIZE, ERROR_FAILED);
+    }
+
+    ASSERT(vector_make_writable(out) == ERROR_NONE, ERROR_FAILED);
+    out->size = 0;
+
+    return vector_reserve(out, MAX(bound, 1));
+}
+
+static inline void vector_set_append(vector_t* out, const uint8_t* item)
+{
+    ccollection_copy(VECTOR_ITEM(out, out->size), item, out->element_size);
+    out->size++;
+}
+
+static inline void vector_set_append_unique(vector_t* out, const uint8_t* item, vector_compare_t compare)
+{
+    if (out->size == 0 || compare(VECTOR_ITEM(out, out->size - 1), item) != 0)
+    {
+        vector_set_append(out, item);
+    }
+}
+
+/**
+ * first position at or after start whose element is not smaller than key
+ */
+static size_t vector_set_gallop(const vector_t* vector, const size_t start, const uint8_t* key,
+        vector_compare_t compare)
+{
+    const size_t n = vector->size;
+    if (start >= n || compare(VECTOR_ITEM(vector, start), key) >= 0)
+    {
+        return start;
+    }
+
+    size_t bound = 1;
+    while (start + bound < n && compare(VECTOR_ITEM(vector, start + bound), key) < 0)
+    {
+        bound <<= 1;
+    }
+    size_t low = start + bound / 2 + 1;
+    size_t high = MIN(start + bound, n);
+    while (low < high)
+    {
+        const size_t mid = low + (high - low) / 2;
+        if (compare(VECTOR_ITEM(vector, mid), key) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+//==============================================================================
+// Sorted sets
+//==============================================================================
+cerror_t vector_unique(vector_t* vector, vector_compare_t compare)
+{
+    ASSERT_E(vector != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_make_writable(vector) == ERROR_NONE, ERROR_FAILED);
+
+    if (compare == NULL && vector_packed_keys(vector))
+    {
+        vector->size = (vector->element_size == 4) ?
+            vector_set_kernels()->unique32((uint32_t*)vector->items, vector->size) :
+            vector_set_kernels()->unique64((uint64_t*)vector->items, vector->size);
+        return ERROR_NONE;
+    }
+
+    if (compare == NULL)
+    {
+        compare = vector_compare_keys(vector->element_size);
+        ASSERT_E(compare != NULL, EBADELEMSIZE, ERROR_FAILED);
+    }
+    if (vector->size == 0)
+    {
+        return ERROR_NONE;
+    }
+
+    size_t w = 1;
+    for (size_t i = 1; i < vector->size; i++)
+    {
+        if (compare(VECTOR_ITEM(vector, i), VECTOR_ITEM(vector, w - 1)) != 0)
+        {
+            if (i != w)
+            {
+                ccollection_copy(VECTOR_ITEM(vector, w), VECTOR_ITEM(vector, i), vector->stride);
+            }
+            w++;
+        }
+    }
+    vector->size = w;
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_merge(const vector_t* first, const vector_t* second, vector_t* out, vector_compare_t compare)
+{
+    bool keys = false;
+    ASSERT_E(first != NULL && second != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_set_prepare(first, second, out, &compare, &keys, first->size + second->size) == ERROR_NONE,
+            ERROR_FAILED);
+
+    if (keys)
+    {
+        out->size = (out->element_size == 4) ?
+            vector_merge32((const uint32_t*)first->items, first->size, (const uint32_t*)second->items,
+                    second->size, (uint32_t*)out->items) :
+            vector_merge64((const uint64_t*)first->items, first->size, (const uint64_t*)second->items,
+                    second->size, (uint64_t*)out->items);
+        STATS_PEAK(out, peak_size, out->size);
+        return ERROR_NONE;
+    }
+
+    size_t i = 0, j = 0;
+    while (i < first->size && j < second->size)
+    {
+        // ties take first, the merge is stable
+        if (compare(VECTOR_ITEM(second, j), VECTOR_ITEM(first, i)) < 0)
+        {
+            vector_set_append(out, VECTOR_ITEM(second, j++));
+        }
+        else
+        {
+            vector_set_append(out, VECTOR_ITEM(first, i++));
+        }
+    }
+    for (; i < first->size; i++)
+    {
+        vector_set_append(out, VECTOR_ITEM(first, i));
+    }
+    for (; j < second->size; j++)
+    {
+        vector_set_append(out, VECTOR_ITEM(second, j));
+    }
+    STATS_PEAK(out, peak_size, out->size);
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_union(const vector_t* first, const vector_t* second, vector_t* out, vector_compare_t compare)
+{
+    bool keys = false;
+    ASSERT_E(first != NULL && second != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_set_prepare(first, second, out, &compare, &keys, first->size + second->size) == ERROR_NONE,
+            ERROR_FAILED);
+
+    if (keys)
+    {
+        out->size = (out->element_size == 4) ?
+            vector_union32((const uint32_t*)first->items, first->size, (const uint32_t*)second->items,
+                    second->size, (uint32_t*)out->items) :
+            vector_union64((const uint64_t*)first->items, first->size, (const uint64_t*)second->items,
+                    second->size, (uint64_t*)out->items);
+        STATS_PEAK(out, peak_size, out->size);
+        return ERROR_NONE;
+    }
+
+    size_t i = 0, j = 0;
+    while (i < first->size && j < second->size)
+    {
+        const int order = compare(VECTOR_ITEM(first, i), VECTOR_ITEM(second, j));
+        vector_set_append_unique(out, (order <= 0) ? VECTOR_ITEM(first, i) : VECTOR_ITEM(second, j), compare);
+        i += (order <= 0);
+        j += (order >= 0);
+    }
+    for (; i < first->size; i++)
+    {
+        vector_set_append_unique(out, VECTOR_ITEM(first, i), compare);
+    }
+    for (; j < second->size; j++)
+    {
+        vector_set_append_unique(out, VECTOR_ITEM(second, j), compare);
+    }
+    STATS_PEAK(out, peak_size, out->size);
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_intersection(const vector_t* first, const vector_t* second, vector_t* out,
+        vector_compare_t compare)
+{
+    bool keys = false;
+    ASSERT_E(first != NULL && second != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_set_prepare(first, second, out, &compare, &keys, MIN(first->size, second->size)) == ERROR_NONE,
+            ERROR_FAILED);
+
+    if (keys)
+    {
+        out->size = (out->element_size == 4) ?
+            vector_set_kernels()->intersection32((const uint32_t*)first->items, first->size,
+                    (const uint32_t*)second->items, second->size, (uint32_t*)out->items) :
+            vector_set_kernels()->intersection64((const uint64_t*)first->items, first->size,
+                    (const uint64_t*)second->items, second->size, (uint64_t*)out->items);
+        STATS_PEAK(out, peak_size, out->size);
+        return ERROR_NONE;
+    }
+
+    // gallop through the larger vector when the sizes are skewed
+    const vector_t *small = (first->size <= second->size) ? first : second;
+    const vector_t *large = (small == first) ? second : first;
+    if (small->size * VECTOR_GALLOP_RATIO < large->size)
+    {
+        size_t j = 0;
+        for (size_t i = 0; i < small->size && j < large->size; i++)
+        {
+            j = vector_set_gallop(large, j, VECTOR_ITEM(small, i), compare);
+            if (j < large->size && compare(VECTOR_ITEM(large, j), VECTOR_ITEM(small, i)) == 0)
+            {
+                vector_set_append_unique(out, VECTOR_ITEM(small, i), compare);
+            }
+        }
+        STATS_PEAK(out, peak_size, out->size);
+        return ERROR_NONE;
+    }
+
+    size_t i = 0, j = 0;
+    while (i < first->size && j < second->size)
+    {
+        const int order = compare(VECTOR_ITEM(first, i), VECTOR_ITEM(second, j));
+        if (order == 0)
+        {
+            vector_set_append_unique(out, VECTOR_ITEM(first, i), compare);
+        }
+        i += (order <= 0);
+        j += (order >= 0);
+    }
+    STATS_PEAK(out, peak_size, out->size);
+
+    return ERROR_NONE;
+}
+
+cerror_t vector_difference(const vector_t* first, const vector_t* second, vector_t* out,
+        vector_compare_t compare)
+{
+    bool keys = false;
+    ASSERT_E(first != NULL && second != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT(vector_set_prepare(first, second, out, &compare, &keys, first->size) == ERROR_NONE, ERROR_FAILED);
+
+    if (keys)
+    {
+        out->size = (out->element_size == 4) ?
+            vector_set_kernels()->difference32((const uint32_t*)first->items, first->size,
+                    (const uint32_t*)second->items, second->size, (uint32_t*)out->items) :
+            vector_set_kernels()->difference64((const uint64_t*)first->items, first->size,
+                    (const uint64_t*)second->items, second->size, (uint64_t*)out->items);
+        STATS_PEAK(out, peak_size, out->size);
+        return ERROR_NONE;
+    }
+
+    // gallop through second when it is much larger, otherwise walk both
+    const bool gallop = (first->size * VECTOR_GALLOP_RATIO < second->size);
+    size_t j = 0;
+    for (size_t i = 0; i < first->size; i++)
+    {
+        const uint8_t *item = VECTOR_ITEM(first, i);
+        if (gallop)
+        {
+            j = vector_set_gallop(second, j, item, compare);
+        }
+        else
+        {
+            while (j < second->size && compare(VECTOR_ITEM(second, j), item) < 0)
+            {
+                j++;
+            }
+        }
+        if (j >= second->size || compare(VECTOR_ITEM(second, j), item) != 0)
+        {
+            vector_set_append_unique(out, item, compare);
+        }
+    }
+    STATS_PEAK(out, peak_size, out->size);
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
@@ -0,0 +1,761 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "src/vector-internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * merge blocks are kept at least this large by limiting the number of runs merged at once, unless the
+ * budget itself is smaller
+ */
+#define VECTOR_SORT_MIN_BLOCK   (256 << 10)
+
+/**
+ * a read or write handed to the I/O thread
+ */
+typedef struct vector_sort_job_t
+{
+    struct vector_sort_job_t *next; /** next queued job */
+    int fd;                     /** file to transfer from or to */
+    uint8_t *buffer;            /** memory to transfer to or from */
+    size_t length;              /** bytes to transfer */
+    off_t offset;               /** file position, -1 to use and advance the current one */
+    bool write;                 /** write instead of read */
+    bool pending;               /** submitted and not done yet */
+    size_t transferred;         /** bytes transferred, less than length only at end of file */
+    int error;                  /** errno of a failed transfer, 0 on success */
+} vector_sort_job_t;
+
+/**
+ * the I/O thread and its FIFO of jobs, files written sequentially stay in order
+ */
+typedef struct vector_sort_io_t
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;        /** signals queued and finished jobs */
+    vector_sort_job_t *head;    /** next job to run */
+    vector_sort_job_t *tail;    /** last job queued */
+    bool stop;                  /** exit once the queue is empty */
+} vector_sort_io_t;
+
+/**
+ * position of a sorted run in a temporary file
+ */
+typedef struct vector_sort_extent_t
+{
+    off_t offset;
+    size_t length;
+} vector_sort_extent_t;
+
+/**
+ * a run being merged, the block after the current one is read ahead
+ */
+typedef struct vector_sort_run_t
+{
+    int fd;                     /** file holding the run */
+    off_t offset;               /** next byte of the run to read */
+    off_t end;                  /** end of the run in fd */
+    uint8_t *blocks[2];         /** block being merged and block being read */
+    vector_sort_job_t jobs[2];  /** reads of the blocks */
+    int current;                /** block being merged */
+    const uint8_t *head;        /** next record, NULL once the run is exhausted */
+    const uint8_t *limit;       /** end of the records in the current block */
+} vector_sort_run_t;
+
+/**
+ * merge output, one block is filled while the other is written
+ */
+typedef struct vector_sort_writer_t
+{
+    int fd;                     /** file written */
+    off_t offset;               /** position of the next block, -1 to append at the current position */
+    uint8_t *blocks[2];         /** block being filled and block being written */
+    vector_sort_job_t jobs[2];  /** writes of the blocks */
+    int current;                /** block being filled */
+    size_t used;                /** bytes in the current block */
+} vector_sort_writer_t;
+
+/**
+ * external sort defenition
+ */
+typedef struct vector_sort_t
+{
+    vector_sort_io_t io;        /** background reads and writes */
+    size_t elem_size;           /** bytes per record */
+    size_t budget;              /** bytes of record buffers */
+    size_t block_size;          /** bytes per merge block, a multiple of elem_size */
+    vector_compare_t compare;   /** order of the runs, NULL for integer keys */
+    vector_compare_t merge;     /** order of the merge, never NULL */
+    const char *temp_dir;       /** directory of the temporary files */
+    int temp[2];                /** runs being merged and runs being written, -1 until created */
+} vector_sort_t;
+
+//==============================================================================
+// Background I/O
+//==============================================================================
+
+static void vector_sort_transfer(vector_sort_job_t* job)
+{
+    while (job->transferred < job->length)
+    {
+        uint8_t *buffer = job->buffer + job->transferred;
+        const size_t left = job->length - job->transferred;
+        ssize_t n;
+        if (job->offset < 0)
+        {
+            n = job->write ? write(job->fd, buffer, left) : read(job->fd, buffer, left);
+        }
+        else
+        {
+            const off_t offset = job->offset + job->transferred;
+            n = job->write ? pwrite(job->fd, buffer, left, offset) : pread(job->fd, buffer, left, offset);
+        }
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0)
+        {
+            job->error = errno;
+            return;
+        }
+        if (n == 0)
+        {
+            // end of file, a write that makes no progress is an error
+            job->error = job->write ? EIO : 0;
+            return;
+        }
+        job->transferred += n;
+    }
+}
+
+static void* vector_sort_io_main(void* arg)
+{
+    vector_sort_io_t *io = arg;
+
+    pthread_mutex_lock(&io->lock);
+    for (;;)
+    {
+        while (io->head == NULL && !io->stop)
+        {
+            pthread_cond_wait(&io->cond, &io->lock);
+        }
+        if (io->head == NULL)
+        {
+            break;
+        }
+
+        vector_sort_job_t *job = io->head;
+        io->head = job->next;
+        if (io->head == NULL)
+        {
+            io->tail = NULL;
+        }
+        pthread_mutex_unlock(&io->lock);
+
+        vector_sort_transfer(job);
+
+        pthread_mutex_lock(&io->lock);
+        job->pending = false;
+        pthread_cond_broadcast(&io->cond);
+    }
+    pthread_mutex_unlock(&io->lock);
+
+    return NULL;
+}
+
+static cerror_t vector_sort_io_start(vector_sort_io_t* io)
+{
+    io->head = NULL;
+    io->tail = NULL;
+    io->stop = false;
+    pthread_mutex_init(&io->lock, NULL);
+    pthread_cond_init(&io->cond, NULL);
+
+    int err = pthread_create(&io->thread, NULL, vector_sort_io_main, io);
+    if (err != 0)
+    {
+        pthread_cond_destroy(&io->cond);
+        pthread_mutex_destroy(&io->lock);
+        errno = err;
+        return ERROR_FAILED;
+    }
+
+    return ERROR_NONE;
+}
+
+/**
+ * run the jobs still queued and join the thread
+ */
+static void vector_sort_io_stop(vector_sort_io_t* io)
+{
+    pthread_mutex_lock(&io->lock);
+    io->stop = true;
+    pthread_cond_broadcast(&io->cond);
+    pthread_mutex_unlock(&io->lock);
+
+    pthread_join(io->thread, NULL);
+    pthread_cond_destroy(&io->cond);
+    pthread_mutex_destroy(&io->lock);
+}
+
+/**
+ * queue a transfer, empty ones complete right away
+ */
+static void vector_sort_submit(vector_sort_io_t* io, vector_sort_job_t* job, const int fd, uint8_t* buffer,
+        const size_t length, const off_t offset, const bool write)
+{
+    job->next = NULL;
+    job->fd = fd;
+    job->buffer = buffer;
+    job->length = length;
+    job->offset = offset;
+    job->write = write;
+    job->transferred = 0;
+    job->error = 0;
+    job->pending = (length > 0);
+    if (!job->pending)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&io->lock);
+    if (io->tail != NULL)
+    {
+        io->tail->next = job;
+    }
+    else
+    {
+        io->head = job;
+    }
+    io->tail = job;
+    pthread_cond_broadcast(&io->cond);
+    pthread_mutex_unlock(&io->lock);
+}
+
+/**
+ * wait for a job submitted earlier, fails with its errno
+ */
+static cerror_t vector_sort_wait(vector_sort_io_t* io, vector_sort_job_t* job)
+{
+    pthread_mutex_lock(&io->lock);
+    while (job->pending)
+    {
+        pthread_cond_wait(&io->cond, &io->lock);
+    }
+    pthread_mutex_unlock(&io->lock);
+
+    ASSERT_E(job->error == 0, job->error, ERROR_FAILED);
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+/**
+ * create an unlinked temporary file, it disappears when closed
+ */
+static int vector_sort_temp_file(const char* dir)
+{
+    char path[PATH_MAX];
+    ASSERT_E(snprintf(path, sizeof(path), "%s/ccollection-sort-XXXXXX", dir) < (int)sizeof(path),
+            ENAMETOOLONG, -1);
+
+    int fd = mkstemp(path);
+    ASSERT(fd >= 0, -1);
+    unlink(path);
+
+    return fd;
+}
+
+/**
+ * read the first blocks of a run
+ */
+static void vector_sort_run_fill(vector_sort_t* sort, vector_sort_run_t* run, const int block)
+{
+    const size_t length = (size_t)MIN((off_t)sort->block_size, run->end - run->offset);
+    vector_sort_submit(&sort->io, &run->jobs[block], run->fd, run->blocks[block], length, run->offset, false);
+    run->offset += length;
+}
+
+/**
+ * move on to the block read ahead and start reading the one after it into the block just merged
+ */
+static cerror_t vector_sort_run_next_block(vector_sort_t* sort, vector_sort_run_t* run)
+{
+    vector_sort_run_fill(sort, run, run->current);
+    run->current ^= 1;
+    ASSERT(vector_sort_wait(&sort->io, &run->jobs[run->current]) == ERROR_NONE, ERROR_FAILED);
+
+    const size_t length = run->jobs[run->current].transferred;
+    run->head = (length > 0) ? run->blocks[run->current] : NULL;
+    run->limit = run->head + length;
+
+    return ERROR_NONE;
+}
+
+static inline cerror_t vector_sort_run_advance(vector_sort_t* sort, vector_sort_run_t* run)
+{
+    run->head += sort->elem_size;
+    if (run->head == run->limit)
+    {
+        return vector_sort_run_next_block(sort, run);
+    }
+    return ERROR_NONE;
+}
+
+/**
+ * hand the current block to the I/O thread and switch to the other one once its previous write is done
+ */
+static cerror_t vector_sort_writer_flush(vector_sort_t* sort, vector_sort_writer_t* writer)
+{
+    if (writer->used == 0)
+    {
+        return ERROR_NONE;
+    }
+
+    vector_sort_submit(&sort->io, &writer->jobs[writer->current], writer->fd, writer->blocks[writer->current],
+            writer->used, writer->offset, true);
+    if (writer->offset >= 0)
+    {
+        writer->offset += writer->used;
+    }
+    writer->current ^= 1;
+    writer->used = 0;
+
+    return vector_sort_wait(&sort->io, &writer->jobs[writer->current]);
+}
+
+static inline cerror_t vector_sort_writer_put(vector_sort_t* sort, vector_sort_writer_t* writer,
+        const uint8_t* record)
+{
+    if (writer->used + sort->elem_size > sort->block_size)
+    {
+        ASSERT(vector_sort_writer_flush(sort, writer) == ERROR_NONE, ERROR_FAILED);
+    }
+    ccollection_copy(writer->blocks[writer->current] + writer->used, record, sort->elem_size);
+    writer->used += sort->elem_size;
+
+    return ERROR_NONE;
+}
+
+/**
+ * true if the head of run a goes before the head of run b, exhausted runs go last and ties keep run order
+ */
+static inline bool vector_sort_before(const vector_sort_t* sort, const vector_sort_run_t* runs, const size_t a,
+        const size_t b)
+{
+    if (runs[a].head == NULL)
+    {
+        return false;
+    }
+    if (runs[b].head == NULL)
+    {
+        return true;
+    }
+
+    const int order = sort->merge(runs[a].head, runs[b].head);
+    return order < 0 || (order == 0 && a < b);
+}
+
+/**
+ * play the matches below node of a loser tree whose leaves k..2k-1 are the runs, the loser of every match
+ * stays in tree[node] and the winner is returned
+ */
+static size_t vector_sort_tree_build(const vector_sort_t* sort, const vector_sort_run_t* runs, size_t* tree,
+        const size_t k, const size_t node)
+{
+    if (node >= k)
+    {
+        return node - k;
+    }
+
+    const size_t left = vector_sort_tree_build(sort, runs, tree, k, 2 * node);
+    const size_t right = vector_sort_tree_build(sort, runs, tree, k, 2 * node + 1);
+    if (vector_sort_before(sort, runs, left, right))
+    {
+        tree[node] = right;
+        return left;
+    }
+    tree[node] = left;
+    return right;
+}
+
+/**
+ * k-way merge of the runs at extents of in_fd into out_fd at out_offset, -1 to append. The budget is split
+ * into a read and a read ahead block per run and two output blocks.
+ */
+static cerror_t vector_sort_merge(vector_sort_t* sort, const vector_sort_extent_t* extents, const size_t k,
+        const int in_fd, const int out_fd, const off_t out_offset)
+{
+    const size_t blocks = 2 * k + 2;
+    sort->block_size = MAX(sort->budget / blocks / sort->elem_size, 1) * sort->elem_size;
+
+    vector_sort_run_t *runs = ccollection_calloc(k * sizeof(vector_sort_run_t));
+    size_t *tree = ccollection_calloc(k * sizeof(size_t));
+    uint8_t *memory = ccollection_calloc(blocks * sort->block_size);
+    vector_sort_writer_t writer = {0};
+    cerror_t err = ERROR_NONE;
+
+    writer.fd = out_fd;
+    writer.offset = out_offset;
+
+    if (runs == NULL || tree == NULL || memory == NULL)
+    {
+        err = ERROR_FAILED;
+        goto done;
+    }
+
+    for (size_t i = 0; i < k; i++)
+    {
+        vector_sort_run_t *run = &runs[i];
+        run->fd = in_fd;
+        run->offset = extents[i].offset;
+        run->end = extents[i].offset + extents[i].length;
+        run->blocks[0] = memory + 2 * i * sort->block_size;
+        run->blocks[1] = run->blocks[0] + sort->block_size;
+        // the first wait below picks up block 0 and refills it, so block 1 is read first
+        run->current = 0;
+        vector_sort_run_fill(sort, run, 1);
+    }
+    writer.blocks[0] = memory + 2 * k * sort->block_size;
+    writer.blocks[1] = writer.blocks[0] + sort->block_size;
+
+    for (size_t i = 0; i < k && err == ERROR_NONE; i++)
+    {
+        err = vector_sort_run_next_block(sort, &runs[i]);
+    }
+
+    if (err == ERROR_NONE)
+    {
+        tree[0] = vector_sort_tree_build(sort, runs, tree, k, 1);
+    }
+    while (err == ERROR_NONE && runs[tree[0]].head != NULL)
+    {
+        size_t winner = tree[0];
+        err = vector_sort_writer_put(sort, &writer, runs[winner].head);
+        if (err == ERROR_NONE)
+        {
+            err = vector_sort_run_advance(sort, &runs[winner]);
+        }
+
+        // replay the matches on the path of the winner's leaf
+        for (size_t node = (winner + k) / 2; node > 0; node /= 2)
+        {
+            if (vector_sort_before(sort, runs, tree[node], winner))
+            {
+                const size_t loser = winner;
+                winner = tree[node];
+                tree[node] = loser;
+            }
+        }
+        tree[0] = winner;
+    }
+
+    if (err == ERROR_NONE)
+    {
+        err = vector_sort_writer_flush(sort, &writer);
+    }
+
+done:
+    // no transfer may touch the blocks once they are freed
+    for (size_t i = 0; runs != NULL && i < k; i++)
+    {
+        vector_sort_wait(&sort->io, &runs[i].jobs[0]);
+        vector_sort_wait(&sort->io, &runs[i].jobs[1]);
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (vector_sort_wait(&sort->io, &writer.jobs[i]) != ERROR_NONE)
+        {
+            err = ERROR_FAILED;
+        }
+    }
+    ccollection_free(memory);
+    ccollection_free(tree);
+    ccollection_free(runs);
+
+    return err;
+}
+
+/**
+ * sort the input in runs of half the budget, reading the next run while the current one is sorted and
+ * written. The runs are appended to temp[0] and their extents pushed to extents, unless the whole input fits
+ * in one run which is written straight to output and sets done.
+ */
+static cerror_t vector_sort_spill_runs(vector_sort_t* sort, const int input, const int output, vector_t* extents,
+        bool* done)
+{
+    const size_t run_bytes = MAX(sort->budget / 2 / sort->elem_size, 1) * sort->elem_size;
+    vector_t *buffers[2] = { vector_new(sort->elem_size), vector_new(sort->elem_size) };
+    vector_sort_job_t reads[2], writes[2];
+    off_t temp_end = 0;
+    cerror_t err = ERROR_NONE;
+
+    memset(reads, 0, sizeof(reads));
+    memset(writes, 0, sizeof(writes));
+    if (buffers[0] == NULL || buffers[1] == NULL ||
+            vector_reserve(buffers[0], run_bytes / sort->elem_size) != ERROR_NONE ||
+            vector_reserve(buffers[1], run_bytes / sort->elem_size) != ERROR_NONE)
+    {
+        err = ERROR_FAILED;
+        goto done;
+    }
+
+    vector_sort_submit(&sort->io, &reads[0], input, buffers[0]->items, run_bytes, -1, false);
+    for (int current = 0;; current ^= 1)
+    {
+        vector_t *run = buffers[current];
+        const int next = current ^ 1;
+        if (vector_sort_wait(&sort->io, &reads[current]) != ERROR_NONE)
+        {
+            err = ERROR_FAILED;
+            break;
+        }
+
+        const size_t length = reads[current].transferred;
+        if (length % sort->elem_size != 0)
+        {
+            errno = EBADFORMAT;
+            err = ERROR_FAILED;
+            break;
+        }
+        if (length == 0)
+        {
+            break;
+        }
+
+        // the other buffer is free once its run is on disk, read the next run into it meanwhile
+        if (vector_sort_wait(&sort->io, &writes[next]) != ERROR_NONE)
+        {
+            err = ERROR_FAILED;
+            break;
+        }
+        vector_sort_submit(&sort->io, &reads[next], input, buffers[next]->items,
+                (length == run_bytes) ? run_bytes : 0, -1, false);
+
+        run->size = length / sort->elem_size;
+        if (vector_partial_sort(run, run->size, sort->compare) != ERROR_NONE)
+        {
+            err = ERROR_FAILED;
+            break;
+        }
+
+        if (extents->size == 0 && length < run_bytes)
+        {
+            // the whole input fits in one run
+            vector_sort_submit(&sort->io, &writes[current], output, run->items, length, -1, true);
+            err = vector_sort_wait(&sort->io, &writes[current]);
+            *done = true;
+            break;
+        }
+        if (sort->temp[0] < 0 && (sort->temp[0] = vector_sort_temp_file(sort->temp_dir)) < 0)
+        {
+            err = ERROR_FAILED;
+            break;
+        }
+
+        const vector_sort_extent_t extent = { temp_end, length };
+        vector_sort_submit(&sort->io, &writes[current], sort->temp[0], run->items, length, temp_end, true);
+        temp_end += length;
+        if (vector_push_back(extents, &extent) != ERROR_NONE)
+        {
+            err = ERROR_FAILED;
+            break;
+        }
+    }
+
+done:
+    for (int i = 0; i < 2; i++)
+    {
+        vector_sort_wait(&sort->io, &reads[i]);
+        if (vector_sort_wait(&sort->io, &writes[i]) != ERROR_NONE)
+        {
+            err = ERROR_FAILED;
+        }
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (buffers[i] != NULL)
+        {
+            vector_destroy(buffers[i]);
+        }
+    }
+
+    return err;
+}
+
+/**
+ * merge groups of runs until few enough are left to merge them into output with blocks of VECTOR_SORT_MIN_BLOCK,
+ * ping-ponging between the two temporary files
+ */
+static cerror_t vector_sort_merge_runs(vector_sort_t* sort, vector_t* extents, const int output)
+{
+    const size_t min_blocks = sort->budget / VECTOR_SORT_MIN_BLOCK;
+    const size_t fan_in = (min_blocks > 6) ? (min_blocks - 2) / 2 : 2;
+
+    while (extents->size > fan_in)
+    {
+        if (sort->temp[1] < 0 && (sort->temp[1] = vector_sort_temp_file(sort->temp_dir)) < 0)
+        {
+            return ERROR_FAILED;
+        }
+
+        vector_t *merged = vector_new(sizeof(vector_sort_extent_t));
+        ASSERT(merged != NULL, ERROR_FAILED);
+
+        const vector_sort_extent_t *runs = (const vector_sort_extent_t*)extents->items;
+        off_t offset = 0;
+        for (size_t first = 0; first < extents->size; first += fan_in)
+        {
+            const size_t k = MIN(fan_in, extents->size - first);
+            vector_sort_extent_t extent = { offset, 0 };
+            for (size_t i = 0; i < k; i++)
+            {
+                extent.length += runs[first + i].length;
+            }
+
+            if (vector_sort_merge(sort, runs + first, k, sort->temp[0], sort->temp[1], offset) != ERROR_NONE ||
+                    vector_push_back(merged, &extent) != ERROR_NONE)
+            {
+                vector_destroy(merged);
+                return ERROR_FAILED;
+            }
+            offset += extent.length;
+        }
+
+        // the merged runs are no longer needed, give their space back
+        ASSERT(ftruncate(sort->temp[0], 0) == 0, ERROR_FAILED);
+        const int temp = sort->temp[0];
+        sort->temp[0] = sort->temp[1];
+        sort->temp[1] = temp;
+        vector_swap(extents, merged);
+        vector_destroy(merged);
+    }
+
+    return vector_sort_merge(sort, (const vector_sort_extent_t*)extents->items, extents->size, sort->temp[0],
+            output, -1);
+}
+
+//==============================================================================
+// External sort
+//==============================================================================
+cerror_t vector_sort_fd(const int input, const int output, const size_t elem_size, vector_compare_t compare,
+        const vector_sort_options_t* options)
+{
+    ASSERT_E(input >= 0 && output >= 0, EBADF, ERROR_FAILED);
+    ASSERT_E(elem_size > 0, EBADELEMSIZE, ERROR_FAILED);
+
+    vector_sort_t sort;
+    memset(&sort, 0, sizeof(sort));
+    sort.elem_size = elem_size;
+    sort.compare = compare;
+    sort.merge = (compare != NULL) ? compare : vector_compare_keys(elem_size);
+    ASSERT_E(sort.merge != NULL, EBADELEMSIZE, ERROR_FAILED);
+
+    sort.budget = (options != NULL && options->memory_budget > 0) ? options->memory_budget :
+        VECTOR_SORT_DEFAULT_BUDGET;
+    sort.temp_dir = (options != NULL) ? options->temp_dir : NULL;
+    if (sort.temp_dir == NULL)
+    {
+        sort.temp_dir = (getenv("TMPDIR") != NULL) ? getenv("TMPDIR") : "/tmp";
+    }
+    sort.temp[0] = -1;
+    sort.temp[1] = -1;
+
+    vector_t *extents = vector_new(sizeof(vector_sort_extent_t));
+    ASSERT(extents != NULL, ERROR_FAILED);
+    if (vector_sort_io_start(&sort.io) != ERROR_NONE)
+    {
+        vector_destroy(extents);
+        return ERROR_FAILED;
+    }
+
+    bool done = false;
+    cerror_t err = vector_sort_spill_runs(&sort, input, output, extents, &done);
+    if (err == ERROR_NONE && !done && extents->size > 0)
+    {
+        err = vector_sort_merge_runs(&sort, extents, output);
+    }
+
+    // keep errno of a failure across the cleanup
+    const int error = errno;
+    vector_sort_io_stop(&sort.io);
+    for (int i = 0; i < 2; i++)
+    {
+        if (sort.temp[i] >= 0)
+        {
+            close(sort.temp[i]);
+        }
+    }
+    vector_destroy(extents);
+    errno = error;
+
+    return err;
+}
+
+cerror_t vector_sort_file(const char* input_path, const char* output_path, const size_t elem_size,
+        vector_compare_t compare, const vector_sort_options_t* options)
+{
+    ASSERT_E(input_path != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(output_path != NULL, EBADPOINTER, ERROR_FAILED);
+
+    int input = open(input_path, O_RDONLY);
+    ASSERT(input >= 0, ERROR_FAILED);
+
+    int output = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (output < 0)
+    {
+        close(input);
+        return ERROR_FAILED;
+    }
+
+    cerror_t err = vector_sort_fd(input, output, elem_size, compare, options);
+    const int error = errno;
+    close(input);
+    if (close(output) != 0 && err == ERROR_NONE)
+    {
+        return ERROR_FAILED;
+    }
+    errno = error;
+
+    return err;
+}
+
+EXTERN_C_END
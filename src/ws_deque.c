@@ -0,0 +1,287 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "include/ws_deque.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+EXTERN_C_BEGIN
+
+#define WORD_SIZE       sizeof(uint64_t)
+#define MAX_SLOT_WORDS  ((WS_DEQUE_MAX_ELEMENT_SIZE + WORD_SIZE - 1) / WORD_SIZE)
+
+/**
+ * circular array of capacity slots, capacity is a power of 2
+ */
+typedef struct ws_deque_buffer_t
+{
+    size_t capacity;                    /** number of slots */
+    struct ws_deque_buffer_t *retired;  /** buffer this one replaced */
+    _Atomic uint64_t items[];           /** capacity * slot_words words */
+} ws_deque_buffer_t;
+
+/**
+ * work stealing deque data structure defenition. Elements live in slots top .. bottom - 1 modulo capacity.
+ * Buffers replaced by growth may still be read by thieves, they are chained on retired and freed by
+ * ws_deque_destroy. As capacity doubles they never take more memory than the live buffer.
+ *
+ * A thief may copy a slot the owner is overwriting, but only when the element was already taken, in which
+ * case its CAS on top fails and the torn copy is thrown away. Slots are made of atomic words copied with
+ * relaxed loads and stores so that race is well defined, the thief copies into a local buffer and hands the
+ * element out only after its CAS succeeded.
+ */
+struct ws_deque_t
+{
+    _Atomic int64_t top;                        /** next element to steal, only ever incremented */
+    char pad_top[64 - sizeof(int64_t)];         /** keep thieves and owner on different cache lines */
+    _Atomic int64_t bottom;                     /** next slot to push to, owned by the owner thread */
+    _Atomic(ws_deque_buffer_t*) buffer;         /** current buffer */
+    size_t element_size;                        /** size of one element */
+    size_t slot_words;                          /** words one slot takes */
+};
+
+//==============================================================================
+// Internal functions
+//==============================================================================
+
+static ws_deque_buffer_t* ws_deque_buffer_new(const size_t capacity, const size_t slot_words)
+{
+    ws_deque_buffer_t *buffer = ccollection_calloc(sizeof(ws_deque_buffer_t) +
+            capacity * slot_words * sizeof(uint64_t));
+    ASSERT(buffer != NULL, NULL);
+
+    buffer->capacity = capacity;
+
+    return buffer;
+}
+
+static inline _Atomic uint64_t* ws_deque_slot(const ws_deque_t* deque, ws_deque_buffer_t* buffer,
+        const int64_t index)
+{
+    return buffer->items + ((size_t)index & (buffer->capacity - 1)) * deque->slot_words;
+}
+
+/**
+ * copy element_size bytes from item into a slot word by word
+ */
+static void ws_deque_slot_store(const ws_deque_t* deque, _Atomic uint64_t* slot, const item_t* item)
+{
+    const uint8_t *source = item;
+    for (size_t w = 0; w < deque->slot_words; w++)
+    {
+        uint64_t word = 0;
+        memcpy(&word, source + w * WORD_SIZE, MIN(WORD_SIZE, deque->element_size - w * WORD_SIZE));
+        atomic_store_explicit(&slot[w], word, memory_order_relaxed);
+    }
+}
+
+/**
+ * copy the words of a slot to words, which has room for slot_words words
+ */
+static void ws_deque_slot_load(const ws_deque_t* deque, _Atomic uint64_t* slot, uint64_t* words)
+{
+    for (size_t w = 0; w < deque->slot_words; w++)
+    {
+        words[w] = atomic_load_explicit(&slot[w], memory_order_relaxed);
+    }
+}
+
+/**
+ * replace a full buffer by one twice as large holding the same elements, called by the owner only
+ */
+static ws_deque_buffer_t* ws_deque_grow(ws_deque_t* deque, ws_deque_buffer_t* buffer, const int64_t top,
+        const int64_t bottom)
+{
+    ws_deque_buffer_t *grown = ws_deque_buffer_new(buffer->capacity * 2, deque->slot_words);
+    ASSERT(grown != NULL, NULL);
+
+    uint64_t words[MAX_SLOT_WORDS];
+    for (int64_t i = top; i < bottom; i++)
+    {
+        ws_deque_slot_load(deque, ws_deque_slot(deque, buffer, i), words);
+        ws_deque_slot_store(deque, ws_deque_slot(deque, grown, i), words);
+    }
+    grown->retired = buffer;
+    atomic_store_explicit(&deque->buffer, grown, memory_order_release);
+
+    return grown;
+}
+
+//==============================================================================
+// ctors and dtors
+//==============================================================================
+ws_deque_t* ws_deque_new(const size_t elem_size, const size_t capacity)
+{
+    errno = 0;
+    ASSERT_E(elem_size > 0 && elem_size <= WS_DEQUE_MAX_ELEMENT_SIZE, EBADELEMSIZE, NULL);
+
+    ws_deque_t *deque = ccollection_calloc(sizeof(ws_deque_t));
+    ASSERT(deque != NULL, NULL);
+
+    size_t slots = 2;
+    while (slots < capacity)
+    {
+        slots *= 2;
+    }
+
+    deque->element_size = elem_size;
+    deque->slot_words = (elem_size + WORD_SIZE - 1) / WORD_SIZE;
+
+    ws_deque_buffer_t *buffer = ws_deque_buffer_new(slots, deque->slot_words);
+    if (buffer == NULL)
+    {
+        ccollection_free(deque);
+        return NULL;
+    }
+
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->buffer, buffer);
+
+    return deque;
+}
+
+cerror_t ws_deque_destroy(ws_deque_t* deque)
+{
+    ASSERT_E(deque != NULL, EBADPOINTER, ERROR_FAILED);
+
+    ws_deque_buffer_t *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+    while (buffer != NULL)
+    {
+        ws_deque_buffer_t *retired = buffer->retired;
+        ccollection_free(buffer);
+        buffer = retired;
+    }
+    ccollection_free(deque);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Capacity
+//==============================================================================
+size_t ws_deque_get_size(const ws_deque_t* deque)
+{
+    ws_deque_t *mutable_deque = (ws_deque_t*)deque;
+    const int64_t bottom = atomic_load_explicit(&mutable_deque->bottom, memory_order_relaxed);
+    const int64_t top = atomic_load_explicit(&mutable_deque->top, memory_order_relaxed);
+
+    return bottom > top ? (size_t)(bottom - top) : 0;
+}
+
+//==============================================================================
+// Owner operations
+//==============================================================================
+cerror_t ws_deque_push(ws_deque_t* deque, const item_t* item)
+{
+    ASSERT_E(deque != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
+
+    const int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    const int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    ws_deque_buffer_t *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+
+    if (bottom - top > (int64_t)buffer->capacity - 1)
+    {
+        buffer = ws_deque_grow(deque, buffer, top, bottom);
+        ASSERT(buffer != NULL, ERROR_FAILED);
+    }
+    ws_deque_slot_store(deque, ws_deque_slot(deque, buffer, bottom), item);
+
+    // publish the element before thieves can see the new bottom
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+    return ERROR_NONE;
+}
+
+cerror_t ws_deque_pop(ws_deque_t* deque, item_t* item)
+{
+    ASSERT_E(deque != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
+
+    const int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    ws_deque_buffer_t *buffer = atomic_load_explicit(&deque->buffer, memory_order_relaxed);
+
+    // claim the bottom element before looking at top, thieves see the claim through the fence
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        errno = EEMPTY;
+        return ERROR_FAILED;
+    }
+
+    if (top == bottom)
+    {
+        // last element, race thieves for it. Only the owner writes slots, so it is still intact after the CAS
+        const bool won = atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+
+        ASSERT_E(won, EEMPTY, ERROR_FAILED);
+    }
+
+    uint64_t words[MAX_SLOT_WORDS];
+    ws_deque_slot_load(deque, ws_deque_slot(deque, buffer, bottom), words);
+    ccollection_copy(item, words, deque->element_size);
+
+    return ERROR_NONE;
+}
+
+//==============================================================================
+// Thief operations
+//==============================================================================
+cerror_t ws_deque_steal(ws_deque_t* deque, item_t* item)
+{
+    ASSERT_E(deque != NULL, EBADPOINTER, ERROR_FAILED);
+    ASSERT_E(item != NULL, EBADPOINTER, ERROR_FAILED);
+
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+
+    ASSERT_E(top < bottom, EEMPTY, ERROR_FAILED);
+
+    ws_deque_buffer_t *buffer = atomic_load_explicit(&deque->buffer, memory_order_acquire);
+    uint64_t words[MAX_SLOT_WORDS];
+    ws_deque_slot_load(deque, ws_deque_slot(deque, buffer, top), words);
+
+    // the copy is only ours if nobody moved top meanwhile
+    ASSERT_E(atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                memory_order_seq_cst, memory_order_relaxed), EAGAIN, ERROR_FAILED);
+
+    ccollection_copy(item, words, deque->element_size);
+
+    return ERROR_NONE;
+}
+
+EXTERN_C_END
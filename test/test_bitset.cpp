@@ -0,0 +1,221 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+static bitset_t* make_bitset(std::vector<bool>& model, const size_t size, const int percent, const unsigned seed)
+{
+    std::mt19937 random(seed);
+    bitset_t *bitset = bitset_new(size);
+    model.assign(size, false);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if ((int)(random() % 100) < percent)
+        {
+            bitset_set(bitset, i);
+            model[i] = true;
+        }
+    }
+    return bitset;
+}
+
+static void expect_equal(const bitset_t* bitset, const std::vector<bool>& model)
+{
+    ASSERT_EQ(bitset_get_size(bitset), model.size());
+    for (size_t i = 0; i < model.size(); i++)
+    {
+        ASSERT_EQ(bitset_test(bitset, i), model[i]) << "bit " << i;
+    }
+}
+
+TEST(bitsetTest, newBitset)
+{
+    bitset_t *bitset = bitset_new(100);
+    ASSERT_TRUE(bitset != NULL);
+    EXPECT_EQ(bitset_get_size(bitset), 100);
+    EXPECT_EQ(bitset_count(bitset), 0);
+    EXPECT_EQ(bitset_find_first(bitset), BITSET_NPOS);
+    bitset_destroy(bitset);
+
+    bitset = bitset_new(0);
+    ASSERT_TRUE(bitset != NULL);
+    EXPECT_EQ(bitset_count(bitset), 0);
+    EXPECT_EQ(bitset_select(bitset, 0), BITSET_NPOS);
+    bitset_destroy(bitset);
+}
+
+TEST(bitsetTest, setResetFlip)
+{
+    bitset_t *bitset = bitset_new(130);
+
+    EXPECT_EQ(bitset_set(bitset, 0), ERROR_NONE);
+    EXPECT_EQ(bitset_set(bitset, 64), ERROR_NONE);
+    EXPECT_EQ(bitset_set(bitset, 129), ERROR_NONE);
+    EXPECT_EQ(bitset_assign(bitset, 5, true), ERROR_NONE);
+    EXPECT_EQ(bitset_flip(bitset, 6), ERROR_NONE);
+    EXPECT_EQ(bitset_count(bitset), 5);
+
+    EXPECT_EQ(bitset_reset(bitset, 64), ERROR_NONE);
+    EXPECT_EQ(bitset_flip(bitset, 6), ERROR_NONE);
+    EXPECT_FALSE(bitset_test(bitset, 64));
+    EXPECT_FALSE(bitset_test(bitset, 6));
+    EXPECT_TRUE(bitset_test(bitset, 129));
+    EXPECT_EQ(bitset_count(bitset), 3);
+
+    EXPECT_EQ(bitset_set(bitset, 130), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+    EXPECT_FALSE(bitset_test(bitset, 130));
+
+    EXPECT_EQ(bitset_fill(bitset, true), ERROR_NONE);
+    EXPECT_EQ(bitset_count(bitset), 130);
+    EXPECT_EQ(bitset_cdata(bitset)[2], 3);
+    EXPECT_EQ(bitset_fill(bitset, false), ERROR_NONE);
+    EXPECT_EQ(bitset_count(bitset), 0);
+
+    bitset_destroy(bitset);
+}
+
+TEST(bitsetTest, pushBackAndResize)
+{
+    bitset_t *bitset = bitset_new(0);
+    std::vector<bool> model;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        ASSERT_EQ(bitset_push_back(bitset, i % 3 == 0), ERROR_NONE);
+        model.push_back(i % 3 == 0);
+    }
+    expect_equal(bitset, model);
+
+    // shrinking drops the bits, growing again brings them back clear
+    EXPECT_EQ(bitset_resize(bitset, 500), ERROR_NONE);
+    EXPECT_EQ(bitset_resize(bitset, 1000), ERROR_NONE);
+    for (int i = 500; i < 1000; i++)
+    {
+        model[i] = false;
+    }
+    expect_equal(bitset, model);
+
+    bitset_destroy(bitset);
+}
+
+TEST(bitsetTest, rankSelectFind)
+{
+    std::vector<bool> model;
+    bitset_t *bitset = make_bitset(model, 100003, 3, 1);
+
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < model.size(); i++)
+    {
+        if (model[i])
+        {
+            positions.push_back(i);
+        }
+    }
+    EXPECT_EQ(bitset_count(bitset), positions.size());
+
+    for (size_t k = 0; k < positions.size(); k++)
+    {
+        ASSERT_EQ(bitset_select(bitset, k), positions[k]);
+        ASSERT_EQ(bitset_rank(bitset, positions[k]), k);
+        ASSERT_EQ(bitset_rank(bitset, positions[k] + 1), k + 1);
+    }
+    EXPECT_EQ(bitset_select(bitset, positions.size()), BITSET_NPOS);
+    EXPECT_EQ(bitset_rank(bitset, model.size()), positions.size());
+
+    size_t k = 0;
+    for (size_t i = bitset_find_first(bitset); i != BITSET_NPOS; i = bitset_find_next(bitset, i + 1))
+    {
+        ASSERT_EQ(i, positions[k++]);
+    }
+    EXPECT_EQ(k, positions.size());
+
+    bitset_destroy(bitset);
+}
+
+TEST(bitsetTest, bulkOperations)
+{
+    const size_t sizes[] = { 1000, 100000, 99999 };
+
+    for (size_t other_size : sizes)
+    {
+        std::vector<bool> a, b;
+        bitset_t *left = make_bitset(a, 100000, 50, 2);
+        bitset_t *right = make_bitset(b, other_size, 30, 3);
+        b.resize(a.size(), false);
+
+        bitset_t *result = bitset_new(0);
+        std::vector<bool> expected(a.size());
+
+        for (int op = 0; op < 4; op++)
+        {
+            bitset_resize(result, 0);
+            bitset_resize(result, a.size());
+            bitset_or(result, left);
+
+            for (size_t i = 0; i < a.size(); i++)
+            {
+                expected[i] = op == 0 ? (a[i] && b[i]) : op == 1 ? (a[i] || b[i]) :
+                              op == 2 ? (a[i] != b[i]) : (a[i] && !b[i]);
+            }
+            cerror_t err = op == 0 ? bitset_and(result, right) : op == 1 ? bitset_or(result, right) :
+                           op == 2 ? bitset_xor(result, right) : bitset_andnot(result, right);
+            ASSERT_EQ(err, ERROR_NONE);
+            expect_equal(result, expected);
+
+            size_t count = 0;
+            for (bool bit : expected)
+            {
+                count += bit;
+            }
+            EXPECT_EQ(bitset_count(result), count);
+        }
+
+        bitset_destroy(result);
+        bitset_destroy(left);
+        bitset_destroy(right);
+    }
+}
+
+TEST(bitsetTest, longerOperandKeepsTailClear)
+{
+    bitset_t *bitset = bitset_new(70);
+    bitset_t *other = bitset_new(200);
+    bitset_fill(other, true);
+
+    EXPECT_EQ(bitset_or(bitset, other), ERROR_NONE);
+    EXPECT_EQ(bitset_count(bitset), 70);
+    EXPECT_EQ(bitset_cdata(bitset)[1], (1 << 6) - 1);
+
+    bitset_destroy(bitset);
+    bitset_destroy(other);
+}
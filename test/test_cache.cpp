@@ -0,0 +1,329 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+static cache_t* make_cache(const cache_policy_t policy, const size_t capacity,
+        cache_evict_fn evict = NULL, void* context = NULL)
+{
+    cache_options_t options = {};
+    options.policy = policy;
+    options.capacity = capacity;
+    options.evict = evict;
+    options.context = context;
+    return cache_new(sizeof(int), sizeof(int64_t), &options);
+}
+
+static void record_evict(const item_t* key, item_t* value, void* context)
+{
+    ((std::vector<int>*)context)->push_back(*(const int*)key);
+    EXPECT_EQ(*(int64_t*)value, *(const int*)key * 10);
+}
+
+static void put(cache_t* cache, const int key)
+{
+    int64_t value = key * 10;
+    ASSERT_EQ(cache_put(cache, &key, &value), ERROR_NONE);
+}
+
+static bool contains(cache_t* cache, const int key)
+{
+    int64_t value = -1;
+    if (cache_get(cache, &key, &value) != ERROR_NONE)
+    {
+        return false;
+    }
+    EXPECT_EQ(value, key * 10);
+    return true;
+}
+
+TEST(cacheTest, newCache)
+{
+    cache_options_t options = {};
+    options.capacity = 16;
+
+    cache_t *cache = cache_new(sizeof(int), sizeof(int), &options);
+    ASSERT_TRUE(cache != NULL);
+    EXPECT_EQ(cache_get_size(cache), 0);
+    EXPECT_EQ(cache_get_capacity(cache), 16);
+    cache_destroy(cache);
+
+    EXPECT_TRUE(cache_new(0, sizeof(int), &options) == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+    EXPECT_TRUE(cache_new(sizeof(int), sizeof(int), NULL) == NULL);
+    EXPECT_EQ(errno, EBADPOINTER);
+
+    options.capacity = 0;
+    EXPECT_TRUE(cache_new(sizeof(int), sizeof(int), &options) == NULL);
+    EXPECT_EQ(errno, EINVAL);
+}
+
+TEST(cacheTest, byteBudget)
+{
+    cache_options_t options = {};
+    options.policy = CACHE_POLICY_S3FIFO;
+    options.max_bytes = 1 << 20;
+
+    cache_t *cache = cache_new(16, 100, &options);
+    ASSERT_TRUE(cache != NULL);
+    EXPECT_GT(cache_get_capacity(cache), 1000);
+    EXPECT_LE(cache_get_memory(cache), options.max_bytes);
+    cache_destroy(cache);
+}
+
+TEST(cacheTest, getPutErase)
+{
+    cache_t *cache = make_cache(CACHE_POLICY_LRU, 8);
+
+    int key = 1;
+    int64_t value = 0;
+    EXPECT_EQ(cache_get(cache, &key, &value), ERROR_FAILED);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_TRUE(cache_find(cache, &key) == NULL);
+
+    put(cache, 1);
+    put(cache, 2);
+    EXPECT_TRUE(contains(cache, 1));
+    EXPECT_EQ(cache_get_size(cache), 2);
+
+    // replacing keeps a single entry
+    value = 42;
+    cache_put(cache, &key, &value);
+    EXPECT_EQ(*(int64_t*)cache_find(cache, &key), 42);
+    EXPECT_EQ(cache_get_size(cache), 2);
+
+    EXPECT_EQ(cache_erase(cache, &key), ERROR_NONE);
+    EXPECT_EQ(cache_erase(cache, &key), ERROR_FAILED);
+    EXPECT_EQ(errno, ENOENT);
+    EXPECT_FALSE(contains(cache, 1));
+    EXPECT_TRUE(contains(cache, 2));
+
+    EXPECT_EQ(cache_clear(cache), ERROR_NONE);
+    EXPECT_EQ(cache_get_size(cache), 0);
+    EXPECT_FALSE(contains(cache, 2));
+
+    cache_destroy(cache);
+}
+
+TEST(cacheTest, counters)
+{
+    cache_t *cache = make_cache(CACHE_POLICY_LRU, 2);
+
+    put(cache, 1);
+    put(cache, 2);
+    put(cache, 3);
+    contains(cache, 3);
+    contains(cache, 1);
+
+    cache_counters_t counters;
+    EXPECT_EQ(cache_get_counters(cache, &counters), ERROR_NONE);
+    EXPECT_EQ(counters.insertions, 3);
+    EXPECT_EQ(counters.evictions, 1);
+    EXPECT_EQ(counters.hits, 1);
+    EXPECT_EQ(counters.misses, 1);
+
+    cache_reset_counters(cache);
+    cache_get_counters(cache, &counters);
+    EXPECT_EQ(counters.hits + counters.misses + counters.insertions + counters.evictions, 0);
+
+    cache_destroy(cache);
+}
+
+TEST(cacheTest, lruEvictsLeastRecentlyUsed)
+{
+    std::vector<int> evicted;
+    cache_t *cache = make_cache(CACHE_POLICY_LRU, 3, record_evict, &evicted);
+
+    put(cache, 1);
+    put(cache, 2);
+    put(cache, 3);
+    contains(cache, 1);
+    put(cache, 4);
+    put(cache, 5);
+
+    EXPECT_EQ(evicted, std::vector<int>({2, 3}));
+    EXPECT_TRUE(contains(cache, 1));
+    EXPECT_TRUE(contains(cache, 4));
+    EXPECT_TRUE(contains(cache, 5));
+
+    cache_destroy(cache);
+}
+
+TEST(cacheTest, clockGivesSecondChance)
+{
+    std::vector<int> evicted;
+    cache_t *cache = make_cache(CACHE_POLICY_CLOCK, 3, record_evict, &evicted);
+
+    put(cache, 1);
+    put(cache, 2);
+    put(cache, 3);
+    contains(cache, 1);
+    put(cache, 4);
+
+    EXPECT_EQ(evicted, std::vector<int>({2}));
+    EXPECT_TRUE(contains(cache, 1));
+
+    cache_destroy(cache);
+}
+
+TEST(cacheTest, s3fifoResistsScans)
+{
+    cache_t *cache = make_cache(CACHE_POLICY_S3FIFO, 100);
+
+    // a hot set accessed repeatedly, then a long scan of keys used once
+    for (int round = 0; round < 3; round++)
+    {
+        for (int key = 0; key < 50; key++)
+        {
+            if (!contains(cache, key))
+            {
+                put(cache, key);
+            }
+        }
+    }
+    for (int key = 1000; key < 5000; key++)
+    {
+        put(cache, key);
+    }
+
+    int hot = 0;
+    for (int key = 0; key < 50; key++)
+    {
+        hot += contains(cache, key);
+    }
+    EXPECT_EQ(hot, 50);
+    EXPECT_EQ(cache_get_size(cache), 100);
+
+    cache_destroy(cache);
+}
+
+TEST(cacheTest, lruMatchesModel)
+{
+    const size_t capacity = 64;
+    cache_t *cache = make_cache(CACHE_POLICY_LRU, capacity);
+    std::list<int> order;
+    std::unordered_map<int, std::list<int>::iterator> model;
+
+    srand(7);
+    for (int i = 0; i < 50000; i++)
+    {
+        const int key = rand() % 200;
+        const int op = rand() % 10;
+        auto it = model.find(key);
+
+        if (op < 5)
+        {
+            ASSERT_EQ(contains(cache, key), it != model.end());
+            if (it != model.end())
+            {
+                order.splice(order.begin(), order, it->second);
+            }
+        }
+        else if (op < 9)
+        {
+            put(cache, key);
+            if (it != model.end())
+            {
+                order.splice(order.begin(), order, it->second);
+            }
+            else
+            {
+                if (model.size() == capacity)
+                {
+                    model.erase(order.back());
+                    order.pop_back();
+                }
+                order.push_front(key);
+                model[key] = order.begin();
+            }
+        }
+        else
+        {
+            ASSERT_EQ(cache_erase(cache, &key) == ERROR_NONE, it != model.end());
+            if (it != model.end())
+            {
+                order.erase(it->second);
+                model.erase(it);
+            }
+        }
+        ASSERT_EQ(cache_get_size(cache), model.size());
+    }
+
+    cache_destroy(cache);
+}
+
+TEST(cacheTest, policiesStayConsistent)
+{
+    const cache_policy_t policies[] = { CACHE_POLICY_LRU, CACHE_POLICY_CLOCK, CACHE_POLICY_S3FIFO };
+
+    for (cache_policy_t policy : policies)
+    {
+        std::vector<int> evicted;
+        cache_t *cache = make_cache(policy, 100, record_evict, &evicted);
+        std::map<int, bool> present;
+
+        srand(11);
+        for (int i = 0; i < 50000; i++)
+        {
+            const int key = rand() % 1000;
+            if (rand() % 8 == 0)
+            {
+                cache_erase(cache, &key);
+                present[key] = false;
+            }
+            else if (!contains(cache, key))
+            {
+                ASSERT_FALSE(present[key]);
+                put(cache, key);
+                present[key] = true;
+            }
+            for (int victim : evicted)
+            {
+                present[victim] = false;
+            }
+            evicted.clear();
+            ASSERT_LE(cache_get_size(cache), 100);
+        }
+
+        size_t count = 0;
+        for (auto &entry : present)
+        {
+            ASSERT_EQ(contains(cache, entry.first), entry.second);
+            count += entry.second;
+        }
+        EXPECT_EQ(count, cache_get_size(cache));
+
+        cache_destroy(cache);
+    }
+}
@@ -31,4 +31,9 @@ TEST(CCollection, ccollectionStrerror)
     EXPECT_STREQ(ccollection_strerror(EBADELEMSIZE), "Invalid element size");
     EXPECT_STREQ(ccollection_strerror(EBADPOINTER), "Bad pointer");
     EXPECT_STREQ(ccollection_strerror(EOUTOFRANGE), "Index out of range");
+    EXPECT_STREQ(ccollection_strerror(EBADFORMAT), "Invalid data format");
+    EXPECT_STREQ(ccollection_strerror(EREADONLY), "Container is read only");
+    EXPECT_STREQ(ccollection_strerror(EEMPTY), "Container is empty");
+    EXPECT_STREQ(ccollection_strerror(EBADHANDLE), "Invalid or stale handle");
+    EXPECT_STREQ(ccollection_strerror(EFULL), "Container is full");
 }
@@ -0,0 +1,231 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+TEST(concurrentVectorTest, newVector)
+{
+    concurrent_vector_t *vector = concurrent_vector_new(sizeof(int));
+
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(concurrent_vector_get_size(vector), 0);
+
+    concurrent_vector_destroy(vector);
+}
+
+TEST(concurrentVectorTest, newVectorBadSize)
+{
+    concurrent_vector_t *vector = concurrent_vector_new(0);
+    EXPECT_TRUE(vector == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+}
+
+TEST(concurrentVectorTest, pushAndGet)
+{
+    concurrent_vector_t *vector = concurrent_vector_new(sizeof(int));
+
+    const int count = 100000;
+    for (int i = 0; i < count; i++)
+    {
+        size_t index;
+        ASSERT_EQ(concurrent_vector_push_back(vector, &i, &index), ERROR_NONE);
+        ASSERT_EQ(index, i);
+    }
+    EXPECT_EQ(concurrent_vector_get_size(vector), count);
+
+    for (int i = 0; i < count; i++)
+    {
+        int out;
+        ASSERT_EQ(concurrent_vector_at(vector, i, &out), ERROR_NONE);
+        ASSERT_EQ(out, i);
+    }
+
+    int out;
+    EXPECT_EQ(concurrent_vector_at(vector, count, &out), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+
+    concurrent_vector_destroy(vector);
+}
+
+TEST(concurrentVectorTest, pointersStayValid)
+{
+    concurrent_vector_t *vector = concurrent_vector_new(sizeof(int));
+
+    int val = 42;
+    concurrent_vector_push_back(vector, &val, NULL);
+    int *first = (int*)concurrent_vector_get(vector, 0);
+
+    for (int i = 0; i < 100000; i++)
+    {
+        concurrent_vector_push_back(vector, &i, NULL);
+    }
+    EXPECT_EQ(concurrent_vector_get(vector, 0), first);
+    EXPECT_EQ(*first, 42);
+
+    concurrent_vector_destroy(vector);
+}
+
+TEST(concurrentVectorTest, pushBatchAcrossSegments)
+{
+    concurrent_vector_t *vector = concurrent_vector_new(sizeof(int));
+    std::vector<int> batch(1000);
+
+    for (int round = 0; round < 10; round++)
+    {
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            batch[i] = round * batch.size() + i;
+        }
+        size_t index;
+        ASSERT_EQ(concurrent_vector_push_back_n(vector, batch.data(), batch.size(), &index), ERROR_NONE);
+        EXPECT_EQ(index, round * batch.size());
+    }
+
+    iterator_t it;
+    int expected = 0;
+    for (concurrent_vector_cbegin(vector, &it); iterator_valid(&it); iterator_next(&it))
+    {
+        ASSERT_EQ(*(const int*)iterator_get(&it), expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, 10000);
+
+    concurrent_vector_destroy(vector);
+}
+
+TEST(concurrentVectorTest, emptyIterator)
+{
+    concurrent_vector_t *vector = concurrent_vector_new(sizeof(int));
+
+    iterator_t it;
+    ASSERT_EQ(concurrent_vector_cbegin(vector, &it), ERROR_NONE);
+    EXPECT_FALSE(iterator_valid(&it));
+
+    concurrent_vector_destroy(vector);
+}
+
+TEST(concurrentVectorTest, concurrentPush)
+{
+    concurrent_vector_t *vector = concurrent_vector_new(sizeof(long));
+
+    const int threads = 8;
+    const long per_thread = 50000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([vector, t, per_thread]() {
+            for (long i = 0; i < per_thread; i++)
+            {
+                long val = t * per_thread + i;
+                size_t index;
+                concurrent_vector_push_back(vector, &val, &index);
+
+                // our own element is readable right away
+                long out;
+                concurrent_vector_at(vector, index, &out);
+                EXPECT_EQ(out, val);
+            }
+        });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    ASSERT_EQ(concurrent_vector_get_size(vector), threads * per_thread);
+
+    std::vector<bool> seen(threads * per_thread, false);
+    for (size_t i = 0; i < threads * per_thread; i++)
+    {
+        long out;
+        ASSERT_EQ(concurrent_vector_at(vector, i, &out), ERROR_NONE);
+        ASSERT_FALSE(seen[out]);
+        seen[out] = true;
+    }
+
+    concurrent_vector_destroy(vector);
+}
+
+TEST(concurrentVectorTest, readWhileAppending)
+{
+    concurrent_vector_t *vector = concurrent_vector_new(sizeof(long));
+
+    const int threads = 4;
+    const long per_thread = 50000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([vector, per_thread]() {
+            for (long i = 0; i < per_thread; i++)
+            {
+                // 0 is never pushed, so a slot read before it was written would show up as 0
+                long val = i + 1;
+                concurrent_vector_push_back(vector, &val, NULL);
+            }
+        });
+    }
+
+    size_t size = 0;
+    while (size < threads * per_thread)
+    {
+        size = concurrent_vector_get_size(vector);
+        if (size > 0)
+        {
+            // the last reserved element may still be being written, it must not be handed out then
+            long out = 0;
+            if (concurrent_vector_at(vector, size - 1, &out) == ERROR_NONE)
+            {
+                ASSERT_NE(out, 0);
+            }
+            else
+            {
+                ASSERT_EQ(errno, EOUTOFRANGE);
+            }
+        }
+        std::this_thread::yield();
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    iterator_t it;
+    size_t count = 0;
+    for (concurrent_vector_cbegin(vector, &it); iterator_valid(&it); iterator_next(&it))
+    {
+        ASSERT_NE(*(const long*)iterator_get(&it), 0);
+        count++;
+    }
+    EXPECT_EQ(count, threads * per_thread);
+
+    concurrent_vector_destroy(vector);
+}
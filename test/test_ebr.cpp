@@ -0,0 +1,216 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+static std::atomic<int> freed_count(0);
+
+static void count_free(void* ptr)
+{
+    freed_count++;
+    free(ptr);
+}
+
+TEST(ebrTest, registerAndReuse)
+{
+    ebr_t *ebr = ebr_new();
+    ASSERT_TRUE(ebr != NULL);
+
+    ebr_thread_t *first = ebr_register(ebr);
+    ebr_thread_t *second = ebr_register(ebr);
+    ASSERT_TRUE(first != NULL);
+    ASSERT_TRUE(second != NULL);
+    EXPECT_NE(first, second);
+
+    EXPECT_EQ(ebr_unregister(first), ERROR_NONE);
+    EXPECT_EQ(ebr_register(ebr), first);
+
+    ebr_destroy(ebr);
+}
+
+TEST(ebrTest, unbalancedRegions)
+{
+    ebr_t *ebr = ebr_new();
+    ebr_thread_t *thread = ebr_register(ebr);
+
+    EXPECT_EQ(ebr_exit(thread), ERROR_FAILED);
+    EXPECT_EQ(errno, EINVAL);
+
+    ebr_enter(thread);
+    EXPECT_EQ(ebr_unregister(thread), ERROR_FAILED);
+    EXPECT_EQ(errno, EINVAL);
+    ebr_exit(thread);
+
+    ebr_destroy(ebr);
+}
+
+TEST(ebrTest, retireIsDeferred)
+{
+    ebr_t *ebr = ebr_new();
+    ebr_thread_t *writer = ebr_register(ebr);
+    ebr_thread_t *reader = ebr_register(ebr);
+
+    freed_count = 0;
+
+    // a reader inside a critical region holds back reclamation
+    ebr_enter(reader);
+    ebr_retire(writer, malloc(16), count_free);
+    for (int i = 0; i < 10; i++)
+    {
+        ebr_collect(writer);
+    }
+    EXPECT_EQ(freed_count, 0);
+
+    ebr_exit(reader);
+    for (int i = 0; i < 10; i++)
+    {
+        ebr_collect(writer);
+    }
+    EXPECT_EQ(freed_count, 1);
+
+    ebr_destroy(ebr);
+}
+
+TEST(ebrTest, nestedRegions)
+{
+    ebr_t *ebr = ebr_new();
+    ebr_thread_t *writer = ebr_register(ebr);
+    ebr_thread_t *reader = ebr_register(ebr);
+
+    freed_count = 0;
+
+    ebr_enter(reader);
+    ebr_enter(reader);
+    ebr_retire(writer, malloc(16), count_free);
+    ebr_exit(reader);
+    for (int i = 0; i < 10; i++)
+    {
+        ebr_collect(writer);
+    }
+    EXPECT_EQ(freed_count, 0);
+    ebr_exit(reader);
+
+    for (int i = 0; i < 10; i++)
+    {
+        ebr_collect(writer);
+    }
+    EXPECT_EQ(freed_count, 1);
+
+    ebr_destroy(ebr);
+}
+
+TEST(ebrTest, batchReclamation)
+{
+    ebr_t *ebr = ebr_new();
+    ebr_thread_t *thread = ebr_register(ebr);
+
+    freed_count = 0;
+
+    // no reader, retirements alone drive the epoch forward
+    for (int i = 0; i < 10000; i++)
+    {
+        ebr_retire(thread, malloc(16), count_free);
+    }
+    EXPECT_GT(freed_count, 9000);
+
+    ebr_destroy(ebr);
+    EXPECT_EQ(freed_count, 10000);
+}
+
+struct node_t
+{
+    std::atomic<bool> retired;
+    long value;
+};
+
+// retired nodes are only marked, so a reader seeing the mark would have read freed memory
+static void mark_retired(void* ptr)
+{
+    ((node_t*)ptr)->retired = true;
+}
+
+TEST(ebrTest, readersNeverSeeReclaimedMemory)
+{
+    ebr_t *ebr = ebr_new();
+    std::atomic<node_t*> shared(new node_t());
+    std::vector<node_t*> all;
+    all.push_back(shared.load());
+
+    std::atomic<bool> done(false);
+    std::atomic<long> violations(0);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++)
+    {
+        readers.emplace_back([&]() {
+            ebr_thread_t *thread = ebr_register(ebr);
+            while (!done)
+            {
+                ebr_enter(thread);
+                node_t *node = shared.load(std::memory_order_acquire);
+                for (int i = 0; i < 16; i++)
+                {
+                    if (node->retired)
+                    {
+                        violations++;
+                    }
+                }
+                ebr_exit(thread);
+            }
+            ebr_unregister(thread);
+        });
+    }
+
+    ebr_thread_t *writer = ebr_register(ebr);
+    for (long i = 0; i < 20000; i++)
+    {
+        node_t *node = new node_t();
+        node->value = i;
+        all.push_back(node);
+
+        node_t *old = shared.exchange(node, std::memory_order_acq_rel);
+        ebr_retire(writer, old, mark_retired);
+    }
+    done = true;
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(violations, 0);
+
+    ebr_destroy(ebr);
+    for (node_t *node : all)
+    {
+        delete node;
+    }
+}
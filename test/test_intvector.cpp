@@ -0,0 +1,159 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+static void expect_equal(const intvector_t* vector, const std::vector<uint64_t>& expected)
+{
+    ASSERT_EQ(intvector_get_size(vector), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        uint64_t value = 0;
+        ASSERT_EQ(intvector_at(vector, i, &value), ERROR_NONE);
+        ASSERT_EQ(value, expected[i]) << "index " << i;
+    }
+
+    std::vector<uint64_t> decoded(expected.size());
+    ASSERT_EQ(intvector_decode(vector, 0, expected.size(), decoded.data()), ERROR_NONE);
+    ASSERT_EQ(decoded, expected);
+}
+
+TEST(intvectorTest, newIntvector)
+{
+    intvector_t *vector = intvector_new();
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(intvector_get_size(vector), 0);
+
+    uint64_t value;
+    EXPECT_EQ(intvector_at(vector, 0, &value), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+
+    intvector_destroy(vector);
+}
+
+TEST(intvectorTest, sortedIdsCompress)
+{
+    std::mt19937_64 random(1);
+    std::vector<uint64_t> ids;
+    uint64_t id = UINT64_C(1) << 40;
+    for (int i = 0; i < 100000; i++)
+    {
+        id += 1 + random() % 200;
+        ids.push_back(id);
+    }
+
+    intvector_t *vector = intvector_new();
+    for (uint64_t value : ids)
+    {
+        ASSERT_EQ(intvector_push_back(vector, value), ERROR_NONE);
+    }
+    expect_equal(vector, ids);
+
+    // gaps below 256 pack into one byte per id
+    EXPECT_LT(intvector_get_memory(vector), ids.size() * 3 / 2);
+
+    intvector_destroy(vector);
+}
+
+TEST(intvectorTest, allWidths)
+{
+    std::mt19937_64 random(2);
+
+    for (unsigned bits = 0; bits <= 64; bits++)
+    {
+        const uint64_t mask = bits == 64 ? ~UINT64_C(0) : (UINT64_C(1) << bits) - 1;
+        std::vector<uint64_t> values(INTVECTOR_BLOCK_SIZE * 3 + 17);
+        for (auto &value : values)
+        {
+            value = 12345 + (random() & mask);
+        }
+        if (bits == 64)
+        {
+            values[5] = 0;
+            values[6] = ~UINT64_C(0);
+        }
+
+        intvector_t *vector = intvector_new();
+        ASSERT_EQ(intvector_push_back_n(vector, values.data(), values.size()), ERROR_NONE);
+        expect_equal(vector, values);
+        intvector_destroy(vector);
+    }
+}
+
+TEST(intvectorTest, partialDecode)
+{
+    std::vector<uint64_t> values;
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        values.push_back(i % 3 == 0 ? i * i : 1000000 - i);
+    }
+
+    intvector_t *vector = intvector_new();
+    intvector_push_back_n(vector, values.data(), values.size());
+
+    const size_t ranges[][2] = { {0, 0}, {5, 10}, {100, 300}, {127, 129}, {256, 744}, {990, 10} };
+    for (auto &range : ranges)
+    {
+        std::vector<uint64_t> decoded(range[1]);
+        ASSERT_EQ(intvector_decode(vector, range[0], range[1], decoded.data()), ERROR_NONE);
+        EXPECT_EQ(decoded, std::vector<uint64_t>(values.begin() + range[0], values.begin() + range[0] + range[1]));
+    }
+
+    uint64_t value;
+    EXPECT_EQ(intvector_decode(vector, 995, 10, &value), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+
+    intvector_destroy(vector);
+}
+
+TEST(intvectorTest, fromVector)
+{
+    vector_t *counters = vector_new(sizeof(uint16_t));
+    std::vector<uint64_t> expected;
+    for (int i = 0; i < 1000; i++)
+    {
+        uint16_t counter = (i * 37) % 50;
+        vector_push_back(counters, &counter);
+        expected.push_back(counter);
+    }
+
+    intvector_t *vector = intvector_from_vector(counters);
+    ASSERT_TRUE(vector != NULL);
+    expect_equal(vector, expected);
+    EXPECT_LT(intvector_get_memory(vector), 1000 * sizeof(uint16_t));
+    intvector_destroy(vector);
+    vector_destroy(counters);
+
+    vector_t *wide = vector_new(3);
+    EXPECT_TRUE(intvector_from_vector(wide) == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+    vector_destroy(wide);
+}
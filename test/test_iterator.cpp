@@ -0,0 +1,166 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+TEST(iteratorTest, emptyVector)
+{
+    vector_t *vector = vector_new(sizeof(int));
+    iterator_t it;
+
+    ASSERT_EQ(vector_cbegin(vector, &it), ERROR_NONE);
+    EXPECT_FALSE(iterator_valid(&it));
+
+    vector_destroy(vector);
+}
+
+TEST(iteratorTest, walkVector)
+{
+    vector_t *vector = vector_new(sizeof(int));
+
+    const int count = 1 << 12;
+    for (int i = 0; i < count; i++)
+    {
+        vector_push_back(vector, &i);
+    }
+
+    iterator_t it;
+    int expected = 0;
+    for (vector_cbegin(vector, &it); iterator_valid(&it); iterator_next(&it))
+    {
+        EXPECT_EQ(*(const int*)iterator_get(&it), expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, count);
+
+    vector_destroy(vector);
+}
+
+TEST(iteratorTest, modifyThroughIterator)
+{
+    vector_t *vector = vector_new(sizeof(int));
+
+    const int count = 100;
+    for (int i = 0; i < count; i++)
+    {
+        vector_push_back(vector, &i);
+    }
+
+    iterator_t it;
+    ASSERT_EQ(vector_begin(vector, &it), ERROR_NONE);
+    do
+    {
+        *(int*)iterator_get(&it) *= 2;
+    } while (iterator_next(&it));
+
+    for (int i = 0; i < count; i++)
+    {
+        int out;
+        vector_at(vector, i, &out);
+        EXPECT_EQ(out, i * 2);
+    }
+
+    vector_destroy(vector);
+}
+
+TEST(iteratorTest, paddedVectorWithPrefetch)
+{
+    vector_t *vector = vector_new_aligned_padded(sizeof(int), 64);
+
+    const int count = 1 << 10;
+    for (int i = 0; i < count; i++)
+    {
+        vector_push_back(vector, &i);
+    }
+
+    iterator_t it;
+    vector_cbegin(vector, &it);
+    iterator_set_prefetch(&it, 8);
+    EXPECT_EQ(it.prefetch, 8 * 64);
+
+    int expected = 0;
+    for (; iterator_valid(&it); iterator_next(&it))
+    {
+        EXPECT_EQ(*(const int*)iterator_get(&it), expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, count);
+
+    vector_destroy(vector);
+}
+
+TEST(iteratorTest, viewOnlyHasConstIterator)
+{
+    vector_t *vector = vector_new(sizeof(int));
+    int val = 5;
+    vector_push_back(vector, &val);
+
+    std::vector<uint8_t> buffer(vector_serialized_size(vector));
+    vector_serialize(vector, buffer.data(), buffer.size());
+    vector_t *view = vector_view(buffer.data(), buffer.size());
+
+    iterator_t it;
+    EXPECT_EQ(vector_begin(view, &it), ERROR_FAILED);
+    EXPECT_EQ(errno, EREADONLY);
+    ASSERT_EQ(vector_cbegin(view, &it), ERROR_NONE);
+    EXPECT_EQ(*(const int*)iterator_get(&it), 5);
+
+    vector_destroy(view);
+    vector_destroy(vector);
+}
+
+// container made of two runs, as a segmented container would hand them out
+static int first_run[3] = { 0, 1, 2 };
+static int second_run[2] = { 3, 4 };
+
+static bool refill_second_run(iterator_t* it)
+{
+    if (it->position != 0)
+    {
+        return false;
+    }
+    it->position = 1;
+    it->current = (uint8_t*)second_run;
+    it->end = (uint8_t*)(second_run + 2);
+    return true;
+}
+
+TEST(iteratorTest, refillNextRun)
+{
+    iterator_t it = { (uint8_t*)first_run, (uint8_t*)(first_run + 3), sizeof(int), 0,
+        refill_second_run, NULL, 0 };
+
+    int expected = 0;
+    for (; iterator_valid(&it); iterator_next(&it))
+    {
+        EXPECT_EQ(*(const int*)iterator_get(&it), expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, 5);
+}
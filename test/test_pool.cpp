@@ -0,0 +1,227 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+struct record_t
+{
+    int64_t id;
+    char name[20];
+};
+
+TEST(poolTest, newPool)
+{
+    pool_t *pool = pool_new(sizeof(record_t));
+    ASSERT_TRUE(pool != NULL);
+    EXPECT_EQ(pool_get_size(pool), 0);
+    EXPECT_EQ(pool_get_capacity(pool), 0);
+    pool_destroy(pool);
+
+    EXPECT_TRUE(pool_new(0) == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+}
+
+TEST(poolTest, acquireRelease)
+{
+    pool_t *pool = pool_new(sizeof(record_t));
+    std::set<record_t*> records;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        record_t *record = (record_t*)pool_acquire(pool);
+        ASSERT_TRUE(record != NULL);
+        EXPECT_EQ((uintptr_t)record % alignof(record_t), 0);
+        record->id = i;
+        snprintf(record->name, sizeof(record->name), "record %d", i);
+        records.insert(record);
+    }
+    EXPECT_EQ(records.size(), 1000);
+    EXPECT_EQ(pool_get_size(pool), 1000);
+    EXPECT_GE(pool_get_capacity(pool), 1000);
+
+    for (record_t *record : records)
+    {
+        char name[20];
+        snprintf(name, sizeof(name), "record %d", (int)record->id);
+        EXPECT_STREQ(record->name, name);
+    }
+
+    // released slots are handed out again, last in first out
+    record_t *first = *records.begin();
+    EXPECT_EQ(pool_release(pool, first), ERROR_NONE);
+    EXPECT_EQ(pool_get_size(pool), 999);
+    EXPECT_EQ(pool_acquire(pool), first);
+
+    const size_t capacity = pool_get_capacity(pool);
+    for (record_t *record : records)
+    {
+        pool_release(pool, record);
+    }
+    EXPECT_EQ(pool_get_size(pool), 0);
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_EQ(records.count((record_t*)pool_acquire(pool)), 1);
+    }
+    EXPECT_EQ(pool_get_capacity(pool), capacity);
+
+    pool_destroy(pool);
+}
+
+TEST(poolTest, smallElements)
+{
+    pool_t *pool = pool_new(1);
+    std::set<uint8_t*> slots;
+
+    for (int i = 0; i < 100; i++)
+    {
+        uint8_t *slot = (uint8_t*)pool_acquire(pool);
+        *slot = i;
+        slots.insert(slot);
+    }
+    EXPECT_EQ(slots.size(), 100);
+
+    pool_destroy(pool);
+}
+
+TEST(poolTest, reserve)
+{
+    pool_t *pool = pool_new(sizeof(int));
+    pool_acquire(pool);
+
+    EXPECT_EQ(pool_reserve(pool, 10000), ERROR_NONE);
+    EXPECT_GE(pool_get_capacity(pool), 10000);
+    EXPECT_EQ(pool_get_size(pool), 1);
+
+    pool_destroy(pool);
+}
+
+TEST(poolTest, reserveKeepsSlabSize)
+{
+    pool_t *pool = pool_new(sizeof(int));
+
+    // far more than one capped slab holds
+    const size_t reserved = 1 << 22;
+    ASSERT_EQ(pool_reserve(pool, reserved), ERROR_NONE);
+    const size_t capacity = pool_get_capacity(pool);
+
+    while (pool_get_capacity(pool) == capacity)
+    {
+        ASSERT_TRUE(pool_acquire(pool) != NULL);
+    }
+    // growing after the reserve falls back to the regular small slabs
+    EXPECT_LT(pool_get_capacity(pool) - capacity, reserved / 4);
+
+    pool_destroy(pool);
+}
+
+TEST(poolTest, cacheBatches)
+{
+    pool_t *pool = pool_new(sizeof(record_t));
+    pool_cache_t *cache = pool_cache_new(pool, 8);
+    ASSERT_TRUE(cache != NULL);
+
+    record_t *record = (record_t*)pool_cache_acquire(cache);
+    ASSERT_TRUE(record != NULL);
+    EXPECT_EQ(pool_get_size(pool), 8);
+
+    std::vector<record_t*> records;
+    for (int i = 0; i < 20; i++)
+    {
+        records.push_back((record_t*)pool_cache_acquire(cache));
+    }
+    EXPECT_EQ(pool_get_size(pool), 24);
+
+    for (record_t *item : records)
+    {
+        EXPECT_EQ(pool_cache_release(cache, item), ERROR_NONE);
+    }
+    EXPECT_LE(pool_get_size(pool), 1 + 2 * 8);
+
+    pool_cache_release(cache, record);
+    EXPECT_EQ(pool_cache_destroy(cache), ERROR_NONE);
+    EXPECT_EQ(pool_get_size(pool), 0);
+
+    pool_destroy(pool);
+}
+
+TEST(poolTest, concurrentCaches)
+{
+    const int thread_count = 4;
+    const int rounds = 20000;
+
+    pool_t *pool = pool_new(sizeof(record_t));
+    std::vector<std::thread> threads;
+    std::vector<int> failures(thread_count, 0);
+
+    for (int t = 0; t < thread_count; t++)
+    {
+        threads.emplace_back([&, t]() {
+            pool_cache_t *cache = pool_cache_new(pool, 0);
+            std::vector<record_t*> live;
+
+            for (int i = 0; i < rounds; i++)
+            {
+                if (live.size() < 64 && (i % 3 != 0 || live.empty()))
+                {
+                    record_t *record = (record_t*)pool_cache_acquire(cache);
+                    record->id = ((int64_t)t << 32) | i;
+                    live.push_back(record);
+                }
+                else
+                {
+                    record_t *record = live.back();
+                    live.pop_back();
+                    failures[t] += (record->id >> 32) != t;
+                    pool_cache_release(cache, record);
+                }
+            }
+            for (record_t *record : live)
+            {
+                pool_cache_release(cache, record);
+            }
+            pool_cache_destroy(cache);
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int t = 0; t < thread_count; t++)
+    {
+        EXPECT_EQ(failures[t], 0);
+    }
+    EXPECT_EQ(pool_get_size(pool), 0);
+
+    pool_destroy(pool);
+}
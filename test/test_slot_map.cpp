@@ -0,0 +1,247 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+TEST(slotMapTest, newSlotMap)
+{
+    slot_map_t *map = slot_map_new(sizeof(int));
+    ASSERT_TRUE(map != NULL);
+    EXPECT_EQ(slot_map_get_size(map), 0);
+    EXPECT_FALSE(slot_map_contains(map, SLOT_HANDLE_NULL));
+    slot_map_destroy(map);
+
+    EXPECT_TRUE(slot_map_new(0) == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+}
+
+TEST(slotMapTest, insertAndGet)
+{
+    slot_map_t *map = slot_map_new(sizeof(int));
+    std::vector<slot_handle_t> handles;
+
+    for (int i = 0; i < 100; i++)
+    {
+        slot_handle_t handle = SLOT_HANDLE_NULL;
+        ASSERT_EQ(slot_map_insert(map, &i, &handle), ERROR_NONE);
+        EXPECT_NE(handle, SLOT_HANDLE_NULL);
+        handles.push_back(handle);
+    }
+    EXPECT_EQ(slot_map_get_size(map), 100);
+
+    for (int i = 0; i < 100; i++)
+    {
+        int item = -1;
+        EXPECT_EQ(slot_map_at(map, handles[i], &item), ERROR_NONE);
+        EXPECT_EQ(item, i);
+        EXPECT_EQ(*(int*)slot_map_get(map, handles[i]), i);
+    }
+
+    slot_map_destroy(map);
+}
+
+TEST(slotMapTest, eraseKeepsHandles)
+{
+    slot_map_t *map = slot_map_new(sizeof(int));
+    std::vector<slot_handle_t> handles(10);
+
+    for (int i = 0; i < 10; i++)
+    {
+        slot_map_insert(map, &i, &handles[i]);
+    }
+
+    EXPECT_EQ(slot_map_erase(map, handles[0]), ERROR_NONE);
+    EXPECT_EQ(slot_map_erase(map, handles[5]), ERROR_NONE);
+    EXPECT_EQ(slot_map_get_size(map), 8);
+
+    // the erased positions were filled by the last elements
+    const int *data = (const int*)slot_map_cdata(map);
+    EXPECT_EQ(data[0], 9);
+    EXPECT_EQ(data[5], 8);
+
+    for (int i = 0; i < 10; i++)
+    {
+        int item = -1;
+        if (i == 0 || i == 5)
+        {
+            EXPECT_FALSE(slot_map_contains(map, handles[i]));
+            EXPECT_EQ(slot_map_at(map, handles[i], &item), ERROR_FAILED);
+            EXPECT_EQ(errno, EBADHANDLE);
+        }
+        else
+        {
+            EXPECT_EQ(slot_map_at(map, handles[i], &item), ERROR_NONE);
+            EXPECT_EQ(item, i);
+        }
+    }
+
+    EXPECT_EQ(slot_map_erase(map, handles[5]), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADHANDLE);
+
+    slot_map_destroy(map);
+}
+
+TEST(slotMapTest, staleHandleAfterReuse)
+{
+    slot_map_t *map = slot_map_new(sizeof(int));
+    slot_handle_t first, second;
+    int item = 1;
+
+    slot_map_insert(map, &item, &first);
+    slot_map_erase(map, first);
+
+    item = 2;
+    slot_map_insert(map, &item, &second);
+
+    // same slot, different generation
+    EXPECT_EQ((uint32_t)first, (uint32_t)second);
+    EXPECT_NE(first, second);
+    EXPECT_FALSE(slot_map_contains(map, first));
+    EXPECT_TRUE(slot_map_get(map, first) == NULL);
+    EXPECT_EQ(*(int*)slot_map_get(map, second), 2);
+
+    // handles that were never issued
+    EXPECT_FALSE(slot_map_contains(map, second + 1));
+    EXPECT_FALSE(slot_map_contains(map, second + 100));
+
+    slot_map_destroy(map);
+}
+
+TEST(slotMapTest, iterateWithHandles)
+{
+    slot_map_t *map = slot_map_new(sizeof(int));
+    std::map<slot_handle_t, int> expected;
+
+    for (int i = 0; i < 50; i++)
+    {
+        slot_handle_t handle;
+        slot_map_insert(map, &i, &handle);
+        expected[handle] = i;
+    }
+    for (auto it = expected.begin(); it != expected.end(); )
+    {
+        if (it->second % 3 == 0)
+        {
+            slot_map_erase(map, it->first);
+            it = expected.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    size_t count = 0;
+    iterator_t it;
+    for (slot_map_cbegin(map, &it); iterator_valid(&it); iterator_next(&it))
+    {
+        slot_handle_t handle = slot_map_handle_of(map, iterator_get(&it));
+        ASSERT_EQ(expected.count(handle), 1);
+        EXPECT_EQ(*(const int*)iterator_get(&it), expected[handle]);
+        count++;
+    }
+    EXPECT_EQ(count, expected.size());
+
+    EXPECT_EQ(slot_map_handle_at(map, 0), slot_map_handle_of(map, slot_map_cdata(map)));
+    EXPECT_EQ(slot_map_handle_at(map, count), SLOT_HANDLE_NULL);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+
+    slot_map_destroy(map);
+}
+
+TEST(slotMapTest, clear)
+{
+    slot_map_t *map = slot_map_new(sizeof(int));
+    std::vector<slot_handle_t> handles(20);
+
+    for (int i = 0; i < 20; i++)
+    {
+        slot_map_insert(map, &i, &handles[i]);
+    }
+    EXPECT_EQ(slot_map_clear(map), ERROR_NONE);
+    EXPECT_EQ(slot_map_get_size(map), 0);
+
+    for (int i = 0; i < 20; i++)
+    {
+        EXPECT_FALSE(slot_map_contains(map, handles[i]));
+    }
+
+    // cleared slots are reused with new generations
+    for (int i = 0; i < 20; i++)
+    {
+        slot_handle_t handle;
+        slot_map_insert(map, &i, &handle);
+        EXPECT_LT((uint32_t)handle, 20);
+        EXPECT_FALSE(slot_map_contains(map, handles[i]));
+    }
+
+    slot_map_destroy(map);
+}
+
+TEST(slotMapTest, randomChurn)
+{
+    slot_map_t *map = slot_map_new(sizeof(int));
+    std::map<slot_handle_t, int> expected;
+    std::vector<slot_handle_t> erased;
+
+    srand(42);
+    for (int i = 0; i < 10000; i++)
+    {
+        if (expected.empty() || rand() % 3 != 0)
+        {
+            slot_handle_t handle;
+            ASSERT_EQ(slot_map_insert(map, &i, &handle), ERROR_NONE);
+            expected[handle] = i;
+        }
+        else
+        {
+            auto it = expected.begin();
+            std::advance(it, rand() % expected.size());
+            ASSERT_EQ(slot_map_erase(map, it->first), ERROR_NONE);
+            erased.push_back(it->first);
+            expected.erase(it);
+        }
+    }
+
+    ASSERT_EQ(slot_map_get_size(map), expected.size());
+    for (auto &entry : expected)
+    {
+        int item = -1;
+        ASSERT_EQ(slot_map_at(map, entry.first, &item), ERROR_NONE);
+        EXPECT_EQ(item, entry.second);
+    }
+    for (slot_handle_t handle : erased)
+    {
+        EXPECT_FALSE(slot_map_contains(map, handle));
+    }
+
+    slot_map_destroy(map);
+}
@@ -0,0 +1,133 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+#include "src/vector-internal.h"
+
+#ifdef CCOLLECTION_STATS
+
+static void count_vectors(const char* type, const void* container, const ccollection_stats_t* stats,
+        void* context)
+{
+    if (strcmp(type, "vector") == 0)
+    {
+        (*(int*)context)++;
+    }
+}
+
+TEST(statsTest, vectorCounters)
+{
+    vector_t *vector = vector_new(sizeof(int));
+
+    ccollection_stats_t stats;
+    ASSERT_EQ(vector_get_stats(vector, &stats), ERROR_NONE);
+    EXPECT_EQ(stats.allocations, 1);
+    EXPECT_EQ(stats.reallocations, 0);
+    EXPECT_EQ(stats.peak_capacity, 1);
+
+    for (int i = 0; i < 8; i++)
+    {
+        vector_push_back(vector, &i);
+    }
+    ASSERT_EQ(vector_get_stats(vector, &stats), ERROR_NONE);
+    // capacity doubled 1 -> 2 -> 4 -> 8
+    EXPECT_EQ(stats.reallocations, 3);
+    EXPECT_EQ(stats.peak_size, 8);
+    EXPECT_EQ(stats.peak_capacity, 8);
+    EXPECT_EQ(stats.bytes_moved, 0);
+
+    int val = -1;
+    vector_insert(vector, 0, &val);
+    vector_erase(vector, 0);
+    ASSERT_EQ(vector_get_stats(vector, &stats), ERROR_NONE);
+    EXPECT_EQ(stats.bytes_moved, 2 * 8 * sizeof(int));
+
+    for (int i = 0; i < 8; i++)
+    {
+        vector_pop_back(vector);
+    }
+    // shrink explicitly, how pop_back shrinks is up to the vector
+    ASSERT_EQ(vector_resize(vector, vector_get_capacity(vector) / 2), ERROR_NONE);
+    ASSERT_EQ(vector_get_stats(vector, &stats), ERROR_NONE);
+    EXPECT_GT(stats.shrinks, 0);
+    EXPECT_EQ(stats.peak_size, 9);
+
+    vector_destroy(vector);
+}
+
+TEST(statsTest, globalAndRegistry)
+{
+    ccollection_stats_t before, after;
+    ASSERT_EQ(ccollection_stats_global(&before), ERROR_NONE);
+
+    int live = 0;
+    ASSERT_EQ(ccollection_stats_foreach(count_vectors, &live), ERROR_NONE);
+
+    vector_t *first = vector_new(sizeof(int));
+    vector_t *second = vector_new_aligned(sizeof(int), 64);
+
+    int now = 0;
+    ccollection_stats_foreach(count_vectors, &now);
+    EXPECT_EQ(now, live + 2);
+
+    ASSERT_EQ(ccollection_stats_global(&after), ERROR_NONE);
+    EXPECT_EQ(after.allocations, before.allocations + 2);
+
+    FILE *file = tmpfile();
+    EXPECT_EQ(ccollection_stats_dump(file), ERROR_NONE);
+    EXPECT_GT(ftell(file), 0);
+    fclose(file);
+
+    vector_destroy(first);
+    vector_destroy(second);
+
+    now = 0;
+    ccollection_stats_foreach(count_vectors, &now);
+    EXPECT_EQ(now, live);
+}
+
+#else
+
+TEST(statsTest, disabled)
+{
+    vector_t *vector = vector_new(sizeof(int));
+    ccollection_stats_t stats;
+
+    EXPECT_EQ(vector_get_stats(vector, &stats), ERROR_FAILED);
+    EXPECT_EQ(errno, ENOTSUP);
+    EXPECT_EQ(ccollection_stats_global(&stats), ERROR_FAILED);
+    EXPECT_EQ(errno, ENOTSUP);
+    EXPECT_EQ(ccollection_stats_dump(stdout), ERROR_FAILED);
+    EXPECT_EQ(errno, ENOTSUP);
+
+    vector_destroy(vector);
+}
+
+#endif
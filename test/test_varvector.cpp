@@ -0,0 +1,205 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+static std::string get(const varvector_t* vector, const size_t index)
+{
+    size_t length = 0;
+    const char *data = (const char*)varvector_get(vector, index, &length);
+    return data != NULL ? std::string(data, length) : std::string("<null>");
+}
+
+static void push(varvector_t* vector, const std::string& value)
+{
+    ASSERT_EQ(varvector_push_back(vector, value.data(), value.size()), ERROR_NONE);
+}
+
+TEST(varvectorTest, newVarvector)
+{
+    varvector_t *vector = varvector_new();
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(varvector_get_size(vector), 0);
+    EXPECT_EQ(varvector_get_bytes(vector), 0);
+    EXPECT_EQ(varvector_pop_back(vector), ERROR_FAILED);
+    EXPECT_EQ(errno, EEMPTY);
+    varvector_destroy(vector);
+}
+
+TEST(varvectorTest, pushAndGet)
+{
+    varvector_t *vector = varvector_new();
+    std::vector<std::string> expected;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        expected.push_back(std::string(i % 37, 'a' + i % 26) + std::to_string(i));
+        push(vector, expected.back());
+    }
+    push(vector, "");
+    expected.push_back("");
+
+    ASSERT_EQ(varvector_get_size(vector), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(get(vector, i), expected[i]);
+    }
+
+    size_t length = 0;
+    EXPECT_TRUE(varvector_get(vector, expected.size(), &length) == NULL);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+
+    // payloads are packed back to back in element order
+    const varvector_span_t *spans = varvector_spans(vector);
+    size_t bytes = 0;
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(spans[i].offset, bytes);
+        bytes += spans[i].length;
+    }
+    EXPECT_EQ(varvector_get_bytes(vector), bytes);
+    EXPECT_EQ(varvector_get_arena_size(vector), bytes);
+
+    varvector_destroy(vector);
+}
+
+TEST(varvectorTest, pushBackN)
+{
+    varvector_t *vector = varvector_new();
+    push(vector, "first");
+
+    const char data[] = "onetwothree";
+    const size_t lengths[] = { 3, 3, 0, 5 };
+    EXPECT_EQ(varvector_push_back_n(vector, data, lengths, 4), ERROR_NONE);
+
+    ASSERT_EQ(varvector_get_size(vector), 5);
+    EXPECT_EQ(get(vector, 0), "first");
+    EXPECT_EQ(get(vector, 1), "one");
+    EXPECT_EQ(get(vector, 2), "two");
+    EXPECT_EQ(get(vector, 3), "");
+    EXPECT_EQ(get(vector, 4), "three");
+
+    varvector_destroy(vector);
+}
+
+TEST(varvectorTest, appendOwnElement)
+{
+    varvector_t *vector = varvector_new();
+    push(vector, "payload");
+
+    // the arena grows while the source points into it
+    for (int i = 0; i < 20; i++)
+    {
+        size_t length = 0;
+        const void *data = varvector_get(vector, 0, &length);
+        ASSERT_EQ(varvector_push_back(vector, data, length), ERROR_NONE);
+    }
+    for (int i = 0; i <= 20; i++)
+    {
+        EXPECT_EQ(get(vector, i), "payload");
+    }
+
+    varvector_destroy(vector);
+}
+
+TEST(varvectorTest, setAndErase)
+{
+    varvector_t *vector = varvector_new();
+    push(vector, "alpha");
+    push(vector, "beta");
+    push(vector, "gamma");
+
+    EXPECT_EQ(varvector_set(vector, 1, "b", 1), ERROR_NONE);
+    EXPECT_EQ(get(vector, 1), "b");
+    EXPECT_EQ(varvector_set(vector, 0, "a much longer alpha", 19), ERROR_NONE);
+    EXPECT_EQ(get(vector, 0), "a much longer alpha");
+    EXPECT_EQ(varvector_get_bytes(vector), 19 + 1 + 5);
+    EXPECT_GT(varvector_get_arena_size(vector), varvector_get_bytes(vector));
+
+    EXPECT_EQ(varvector_erase(vector, 1), ERROR_NONE);
+    ASSERT_EQ(varvector_get_size(vector), 2);
+    EXPECT_EQ(get(vector, 0), "a much longer alpha");
+    EXPECT_EQ(get(vector, 1), "gamma");
+
+    EXPECT_EQ(varvector_set(vector, 5, "x", 1), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+
+    EXPECT_EQ(varvector_compact(vector), ERROR_NONE);
+    EXPECT_EQ(varvector_get_arena_size(vector), varvector_get_bytes(vector));
+    EXPECT_EQ(get(vector, 0), "a much longer alpha");
+    EXPECT_EQ(get(vector, 1), "gamma");
+    EXPECT_EQ(varvector_spans(vector)[1].offset, 19);
+
+    EXPECT_EQ(varvector_clear(vector), ERROR_NONE);
+    EXPECT_EQ(varvector_get_size(vector), 0);
+    EXPECT_EQ(varvector_get_arena_size(vector), 0);
+
+    varvector_destroy(vector);
+}
+
+TEST(varvectorTest, automaticCompaction)
+{
+    varvector_t *vector = varvector_new();
+    std::vector<std::string> expected;
+
+    srand(3);
+    for (int i = 0; i < 20000; i++)
+    {
+        const int op = rand() % 4;
+        if (op < 2 || expected.empty())
+        {
+            expected.push_back(std::string(rand() % 64, 'a' + rand() % 26));
+            push(vector, expected.back());
+        }
+        else if (op == 2)
+        {
+            const size_t index = rand() % expected.size();
+            expected[index] = std::string(rand() % 64, 'A' + rand() % 26);
+            ASSERT_EQ(varvector_set(vector, index, expected[index].data(), expected[index].size()), ERROR_NONE);
+        }
+        else
+        {
+            const size_t index = rand() % expected.size();
+            expected.erase(expected.begin() + index);
+            ASSERT_EQ(varvector_erase(vector, index), ERROR_NONE);
+        }
+        ASSERT_LE(varvector_get_arena_size(vector), MAX(2 * varvector_get_bytes(vector) + 64, 4096));
+    }
+
+    ASSERT_EQ(varvector_get_size(vector), expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        EXPECT_EQ(get(vector, i), expected[i]);
+    }
+
+    varvector_destroy(vector);
+}
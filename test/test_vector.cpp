@@ -98,6 +98,47 @@ TEST(vectorTest, vectorPopBack)
 
     vector_destroy(vector);
 }
+TEST(vectorTest, shrinkAfterPopAndErase)
+{
+    vector_t *vector = vector_new(sizeof(int));
+
+    ASSERT_TRUE(vector != NULL);
+
+    for (int i = 0; i < 64; i++)
+    {
+        vector_push_back(vector, &i);
+    }
+    EXPECT_EQ(vector_get_capacity(vector), 64);
+
+    // capacity halves once the size drops below a quarter of it
+    for (int i = 0; i < 48; i++)
+    {
+        vector_pop_back(vector);
+    }
+    EXPECT_EQ(vector_get_size(vector), 16);
+    EXPECT_EQ(vector_get_capacity(vector), 64);
+
+    vector_pop_back(vector);
+    EXPECT_EQ(vector_get_capacity(vector), 32);
+
+    for (int i = 0; i < 8; i++)
+    {
+        vector_erase(vector, 0);
+    }
+    EXPECT_EQ(vector_get_size(vector), 7);
+    EXPECT_EQ(vector_get_capacity(vector), 16);
+
+    // the remaining elements survive the shrinks
+    for (int i = 0; i < 7; i++)
+    {
+        int out;
+        ASSERT_EQ(vector_at(vector, i, &out), ERROR_NONE);
+        EXPECT_EQ(out, i + 8);
+    }
+
+    vector_destroy(vector);
+}
+
 TEST(vectorTest, pushAfterPop)
 {
     vector_t *vector = vector_new(sizeof(int));
@@ -471,3 +512,122 @@ TEST(vectorTest, clearVector)
 
     vector_destroy(vector);
 }
+
+TEST(vectorTest, initEmbeddedHeader)
+{
+    struct
+    {
+        int tag;
+        vector_header_t header;
+    } owner;
+
+    vector_t *vector = vector_init(&owner.header, sizeof(int));
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ((void*)vector, (void*)&owner.header);
+
+    for (int i = 0; i < 100; i++)
+    {
+        ASSERT_EQ(vector_push_back(vector, &i), ERROR_NONE);
+    }
+    EXPECT_EQ(vector_get_size(vector), 100);
+
+    int val = 0;
+    vector_at(vector, 42, &val);
+    EXPECT_EQ(val, 42);
+
+    EXPECT_EQ(vector_deinit(vector), ERROR_NONE);
+
+    vector_t *heap = vector_new(sizeof(int));
+    EXPECT_EQ(vector_deinit(heap), ERROR_FAILED);
+    EXPECT_EQ(errno, EINVAL);
+    vector_destroy(heap);
+}
+
+TEST(vectorTest, wrapNeverReallocates)
+{
+    int buffer[8];
+    vector_header_t header;
+
+    vector_t *vector = vector_init_wrap(&header, buffer, 8, sizeof(int));
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_get_capacity(vector), 8);
+
+    for (int i = 0; i < 8; i++)
+    {
+        ASSERT_EQ(vector_push_back(vector, &i), ERROR_NONE);
+    }
+    EXPECT_EQ(vector_cdata(vector), (const item_t*)buffer);
+    EXPECT_EQ(buffer[7], 7);
+
+    int val = 8;
+    EXPECT_EQ(vector_push_back(vector, &val), ERROR_FAILED);
+    EXPECT_EQ(errno, EFULL);
+    EXPECT_EQ(vector_get_size(vector), 8);
+
+    // erasing and clearing keep the whole buffer
+    for (int i = 0; i < 7; i++)
+    {
+        vector_pop_back(vector);
+    }
+    EXPECT_EQ(vector_get_capacity(vector), 8);
+    EXPECT_EQ(vector_clear(vector), ERROR_NONE);
+    EXPECT_EQ(vector_get_capacity(vector), 8);
+    EXPECT_EQ(vector_cdata(vector), (const item_t*)buffer);
+
+    EXPECT_EQ(vector_assign_n(vector, 8, &val), ERROR_NONE);
+    EXPECT_EQ(buffer[0], 8);
+    EXPECT_EQ(vector_assign_n(vector, 9, &val), ERROR_FAILED);
+    EXPECT_EQ(errno, EFULL);
+
+    EXPECT_EQ(vector_destroy(vector), ERROR_NONE);
+}
+
+TEST(vectorTest, wrapHeapHeader)
+{
+    int buffer[4] = {1, 2, 3, 4};
+
+    EXPECT_TRUE(vector_wrap(NULL, 4, sizeof(int)) == NULL);
+    EXPECT_EQ(errno, EBADPOINTER);
+    EXPECT_TRUE(vector_wrap(buffer, 0, sizeof(int)) == NULL);
+    EXPECT_EQ(errno, EINVAL);
+
+    vector_t *vector = vector_wrap(buffer, 4, sizeof(int));
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_get_size(vector), 0);
+
+    int val = 5;
+    vector_push_back(vector, &val);
+
+    // clones copy the caller's buffer instead of sharing it
+    vector_t *clone = vector_clone(vector);
+    ASSERT_TRUE(clone != NULL);
+    EXPECT_NE(vector_cdata(clone), vector_cdata(vector));
+    val = 6;
+    EXPECT_EQ(vector_push_back(clone, &val), ERROR_NONE);
+    EXPECT_EQ(vector_get_size(vector), 1);
+
+    vector_destroy(clone);
+    vector_destroy(vector);
+    EXPECT_EQ(buffer[0], 5);
+}
+
+TEST(vectorTest, swapEmbeddedAndHeap)
+{
+    vector_header_t header;
+    vector_t *embedded = vector_init(&header, sizeof(int));
+    vector_t *heap = vector_new(sizeof(int));
+
+    int val = 1;
+    vector_push_back(embedded, &val);
+    val = 2;
+    vector_push_back(heap, &val);
+    vector_push_back(heap, &val);
+
+    ASSERT_EQ(vector_swap(embedded, heap), ERROR_NONE);
+    EXPECT_EQ(vector_get_size(embedded), 2);
+    EXPECT_EQ(vector_get_size(heap), 1);
+
+    // each header keeps its own ownership
+    EXPECT_EQ(vector_deinit(embedded), ERROR_NONE);
+    EXPECT_EQ(vector_destroy(heap), ERROR_NONE);
+}
@@ -0,0 +1,197 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+struct record_t
+{
+    uint32_t key;
+    uint8_t payload[20];
+};
+
+TEST(vectorAlignedTest, newAlignedVector)
+{
+    vector_t *vector = vector_new_aligned(sizeof(float), 64);
+
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_get_size(vector), 0);
+    EXPECT_EQ(vector_get_capacity(vector), 1);
+    EXPECT_EQ(vector_get_stride(vector), sizeof(float));
+    EXPECT_EQ((uintptr_t)vector_cdata(vector) % 64, 0);
+
+    vector_destroy(vector);
+}
+
+TEST(vectorAlignedTest, badAlignment)
+{
+    vector_t *vector = vector_new_aligned(sizeof(float), 48);
+    EXPECT_TRUE(vector == NULL);
+    EXPECT_EQ(errno, EINVAL);
+
+    vector = vector_new_aligned(0, 64);
+    EXPECT_TRUE(vector == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+}
+
+TEST(vectorAlignedTest, alignmentKeptOnGrowth)
+{
+    vector_t *vector = vector_new_aligned(sizeof(float), 64);
+
+    ASSERT_TRUE(vector != NULL);
+
+    const int count = 1 << 16;
+    for (int i = 0; i < count; i++)
+    {
+        float val = i;
+        ASSERT_EQ(vector_push_back(vector, &val), ERROR_NONE);
+        ASSERT_EQ((uintptr_t)vector_cdata(vector) % 64, 0);
+    }
+
+    const float *data = (const float*)vector_cdata(vector);
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(data[i], (float)i);
+    }
+
+    for (int i = 0; i < count - 1; i++)
+    {
+        ASSERT_EQ(vector_pop_back(vector), ERROR_NONE);
+    }
+    EXPECT_EQ((uintptr_t)vector_cdata(vector) % 64, 0);
+
+    vector_destroy(vector);
+}
+
+TEST(vectorAlignedTest, paddedStride)
+{
+    vector_t *vector = vector_new_aligned_padded(sizeof(record_t), 32);
+
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_get_stride(vector), 32);
+
+    const int count = 1 << 10;
+    for (int i = 0; i < count; i++)
+    {
+        record_t record;
+        record.key = i;
+        memset(record.payload, i & 0xff, sizeof(record.payload));
+        ASSERT_EQ(vector_push_back(vector, &record), ERROR_NONE);
+    }
+
+    // insert and erase in the middle shift whole padded slots
+    record_t record = { 12345, { 0 } };
+    EXPECT_EQ(vector_insert(vector, 10, &record), ERROR_NONE);
+    EXPECT_EQ(vector_erase(vector, 11), ERROR_NONE);
+
+    const uint8_t *data = (const uint8_t*)vector_cdata(vector);
+    for (int i = 0; i < count; i++)
+    {
+        record_t out;
+        ASSERT_EQ(vector_at(vector, i, &out), ERROR_NONE);
+        ASSERT_EQ((uintptr_t)(data + i * vector_get_stride(vector)) % 32, 0);
+        if (i == 10)
+        {
+            EXPECT_EQ(out.key, 12345);
+        }
+        else
+        {
+            EXPECT_EQ(out.key, i);
+            EXPECT_EQ(out.payload[19], i & 0xff);
+        }
+    }
+
+    vector_destroy(vector);
+}
+
+TEST(vectorAlignedTest, serializePadded)
+{
+    vector_t *vector = vector_new_aligned_padded(sizeof(record_t), 64);
+
+    const int count = 1 << 12;
+    for (int i = 0; i < count; i++)
+    {
+        record_t record = { (uint32_t)i, { 1 } };
+        vector_push_back(vector, &record);
+    }
+
+    // the payload is packed, padding is not serialized
+    std::vector<uint8_t> buffer(vector_serialized_size(vector));
+    EXPECT_LT(buffer.size(), count * vector_get_stride(vector));
+    EXPECT_EQ(vector_serialize(vector, buffer.data(), buffer.size()), ERROR_NONE);
+
+    vector_t *copy = vector_deserialize(buffer.data(), buffer.size());
+    ASSERT_TRUE(copy != NULL);
+    ASSERT_EQ(vector_get_size(copy), count);
+    EXPECT_EQ(vector_get_stride(copy), sizeof(record_t));
+
+    for (int i = 0; i < count; i++)
+    {
+        record_t out;
+        vector_at(copy, i, &out);
+        EXPECT_EQ(out.key, i);
+    }
+
+    vector_destroy(copy);
+
+    // the stream is identical to the buffer
+    FILE *file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+    EXPECT_EQ(vector_serialize_fd(vector, fileno(file)), ERROR_NONE);
+
+    std::vector<uint8_t> streamed(buffer.size());
+    rewind(file);
+    EXPECT_EQ(fread(streamed.data(), 1, streamed.size(), file), streamed.size());
+    EXPECT_TRUE(streamed == buffer);
+    fclose(file);
+
+    vector_destroy(vector);
+}
+
+TEST(vectorAlignedTest, dataOfViewIsReadOnly)
+{
+    vector_t *vector = vector_new(sizeof(int));
+    int val = 3;
+    vector_push_back(vector, &val);
+
+    std::vector<uint8_t> buffer(vector_serialized_size(vector));
+    vector_serialize(vector, buffer.data(), buffer.size());
+
+    vector_t *view = vector_view(buffer.data(), buffer.size());
+    ASSERT_TRUE(view != NULL);
+    EXPECT_TRUE(vector_data(view) == NULL);
+    EXPECT_EQ(errno, EREADONLY);
+    EXPECT_EQ(*(const int*)vector_cdata(view), 3);
+    EXPECT_EQ(*(int*)vector_data(vector), 3);
+
+    vector_destroy(view);
+    vector_destroy(vector);
+}
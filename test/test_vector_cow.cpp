@@ -0,0 +1,257 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+static vector_t* make_vector(const size_t count)
+{
+    vector_t *vector = vector_new(sizeof(int));
+    for (int i = 0; i < (int)count; i++)
+    {
+        vector_push_back(vector, &i);
+    }
+    return vector;
+}
+
+TEST(vectorCowTest, cloneSharesItems)
+{
+    vector_t *vector = make_vector(100);
+    vector_t *clone = vector_clone(vector);
+
+    ASSERT_TRUE(clone != NULL);
+    EXPECT_EQ(vector_get_size(clone), 100);
+    EXPECT_EQ(vector_cdata(clone), vector_cdata(vector));
+
+    for (int i = 0; i < 100; i++)
+    {
+        int item = -1;
+        vector_at(clone, i, &item);
+        EXPECT_EQ(item, i);
+    }
+
+    vector_destroy(vector);
+    vector_destroy(clone);
+}
+
+TEST(vectorCowTest, copyOnWrite)
+{
+    vector_t *vector = make_vector(100);
+    vector_t *clone = vector_clone(vector);
+    vector_t *other = vector_clone(clone);
+
+    int item = 1000;
+    EXPECT_EQ(vector_push_back(clone, &item), ERROR_NONE);
+    EXPECT_NE(vector_cdata(clone), vector_cdata(vector));
+    EXPECT_EQ(vector_cdata(other), vector_cdata(vector));
+    EXPECT_EQ(vector_get_size(clone), 101);
+    EXPECT_EQ(vector_get_size(vector), 100);
+
+    EXPECT_EQ(vector_erase(vector, 0), ERROR_NONE);
+    EXPECT_EQ(vector_get_size(vector), 99);
+    vector_at(vector, 0, &item);
+    EXPECT_EQ(item, 1);
+
+    // the last reference owns the items without copying
+    const item_t *items = vector_cdata(other);
+    EXPECT_EQ(vector_pop_back(other), ERROR_NONE);
+    EXPECT_EQ(vector_cdata(other), items);
+
+    for (int i = 0; i < 100; i++)
+    {
+        vector_at(clone, i, &item);
+        EXPECT_EQ(item, i);
+    }
+
+    vector_destroy(vector);
+    vector_destroy(clone);
+    vector_destroy(other);
+}
+
+TEST(vectorCowTest, destroyOriginalFirst)
+{
+    vector_t *vector = make_vector(10);
+    vector_t *clone = vector_clone(vector);
+    vector_destroy(vector);
+
+    int item = -1;
+    vector_at(clone, 9, &item);
+    EXPECT_EQ(item, 9);
+    EXPECT_EQ(vector_pop_back(clone), ERROR_NONE);
+    EXPECT_EQ(vector_get_size(clone), 9);
+
+    vector_destroy(clone);
+}
+
+TEST(vectorCowTest, alignedClone)
+{
+    vector_t *vector = vector_new_aligned(sizeof(float), 64);
+    for (int i = 0; i < 50; i++)
+    {
+        float item = i;
+        vector_push_back(vector, &item);
+    }
+
+    vector_t *clone = vector_clone(vector);
+    float item = 50;
+    EXPECT_EQ(vector_push_back(clone, &item), ERROR_NONE);
+    EXPECT_NE(vector_cdata(clone), vector_cdata(vector));
+    EXPECT_EQ((uintptr_t)vector_cdata(clone) % 64, 0);
+
+    for (int i = 0; i <= 50; i++)
+    {
+        vector_at(clone, i, &item);
+        EXPECT_EQ(item, i);
+    }
+
+    vector_destroy(vector);
+    vector_destroy(clone);
+}
+
+TEST(vectorCowTest, cloneView)
+{
+    vector_t *vector = make_vector(10);
+    std::vector<uint8_t> buffer(vector_serialized_size(vector));
+    vector_serialize(vector, buffer.data(), buffer.size());
+
+    vector_t *view = vector_view(buffer.data(), buffer.size());
+    vector_t *clone = vector_clone(view);
+    ASSERT_TRUE(clone != NULL);
+    EXPECT_EQ(vector_cdata(clone), vector_cdata(view));
+
+    int item = 0;
+    EXPECT_EQ(vector_push_back(clone, &item), ERROR_FAILED);
+    EXPECT_EQ(errno, EREADONLY);
+
+    vector_destroy(clone);
+    vector_destroy(view);
+    vector_destroy(vector);
+}
+
+TEST(vectorCowTest, badArguments)
+{
+    EXPECT_TRUE(vector_clone(NULL) == NULL);
+    EXPECT_EQ(errno, EBADPOINTER);
+    EXPECT_TRUE(vector_snapshot_new(NULL) == NULL);
+    EXPECT_EQ(errno, EBADPOINTER);
+}
+
+TEST(vectorCowTest, snapshotPublish)
+{
+    ebr_t *ebr = ebr_new();
+    ebr_thread_t *writer = ebr_register(ebr);
+    vector_snapshot_t *snapshot = vector_snapshot_new(make_vector(10));
+    ASSERT_TRUE(snapshot != NULL);
+
+    vector_t *acquired = vector_snapshot_acquire(snapshot, writer);
+    ASSERT_TRUE(acquired != NULL);
+
+    // derive the next version from the current one
+    vector_t *next = vector_snapshot_acquire(snapshot, writer);
+    int item = 10;
+    vector_push_back(next, &item);
+    EXPECT_EQ(vector_snapshot_publish(snapshot, next, writer), ERROR_NONE);
+
+    const vector_t *current = vector_snapshot_read_begin(snapshot, writer);
+    EXPECT_EQ(vector_get_size(current), 11);
+    vector_snapshot_read_end(snapshot, writer);
+    EXPECT_EQ(vector_get_size(acquired), 10);
+
+    vector_destroy(acquired);
+    vector_snapshot_destroy(snapshot);
+    ebr_destroy(ebr);
+}
+
+TEST(vectorCowTest, concurrentReaders)
+{
+    const int versions = 2000;
+    const int reader_count = 3;
+
+    ebr_t *ebr = ebr_new();
+    vector_snapshot_t *snapshot = vector_snapshot_new(make_vector(1));
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_count; r++)
+    {
+        readers.emplace_back([&, r]() {
+            ebr_thread_t *thread = ebr_register(ebr);
+            while (!done.load())
+            {
+                // every published version holds 0 .. size - 1
+                if (r % 2 == 0)
+                {
+                    vector_t *acquired = vector_snapshot_acquire(snapshot, thread);
+                    const int *items = (const int*)vector_cdata(acquired);
+                    for (size_t i = 0; i < vector_get_size(acquired); i++)
+                    {
+                        failures += items[i] != (int)i;
+                    }
+                    vector_destroy(acquired);
+                }
+                else
+                {
+                    const vector_t *current = vector_snapshot_read_begin(snapshot, thread);
+                    const int *items = (const int*)vector_cdata(current);
+                    for (size_t i = 0; i < vector_get_size(current); i++)
+                    {
+                        failures += items[i] != (int)i;
+                    }
+                    vector_snapshot_read_end(snapshot, thread);
+                }
+            }
+            ebr_unregister(thread);
+        });
+    }
+
+    ebr_thread_t *writer = ebr_register(ebr);
+    for (int i = 1; i < versions; i++)
+    {
+        vector_t *next = vector_snapshot_acquire(snapshot, writer);
+        vector_push_back(next, &i);
+        ASSERT_EQ(vector_snapshot_publish(snapshot, next, writer), ERROR_NONE);
+    }
+    done = true;
+
+    for (auto &reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+
+    const vector_t *current = vector_snapshot_read_begin(snapshot, writer);
+    EXPECT_EQ(vector_get_size(current), versions);
+    vector_snapshot_read_end(snapshot, writer);
+
+    vector_snapshot_destroy(snapshot);
+    ebr_destroy(ebr);
+}
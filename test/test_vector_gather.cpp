@@ -0,0 +1,209 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+template <typename T>
+static vector_t* filled_vector(const size_t count)
+{
+    vector_t *vector = vector_new(sizeof(T));
+    for (size_t i = 0; i < count; i++)
+    {
+        T val = (T)(i * 3 + 1);
+        vector_push_back(vector, &val);
+    }
+    return vector;
+}
+
+static std::vector<pos_t> random_indices(const size_t n, const size_t size)
+{
+    std::vector<pos_t> indices(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        indices[i] = rand() % size;
+    }
+    return indices;
+}
+
+template <typename T>
+static void check_gather(const size_t distance)
+{
+    const size_t size = 4096;
+    vector_t *vector = filled_vector<T>(size);
+    // odd batch sizes leave a tail after the SIMD blocks
+    std::vector<pos_t> indices = random_indices(1001, size);
+    std::vector<T> out(indices.size());
+
+    ASSERT_EQ(vector_gather_prefetch(vector, indices.data(), indices.size(), out.data(), distance), ERROR_NONE);
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        T val;
+        vector_at(vector, indices[i], &val);
+        ASSERT_EQ(out[i], val);
+    }
+
+    vector_destroy(vector);
+}
+
+TEST(vectorGatherTest, gather32)
+{
+    check_gather<uint32_t>(VECTOR_PREFETCH_DISTANCE);
+    check_gather<uint32_t>(0);
+    check_gather<uint32_t>(5000);
+}
+
+TEST(vectorGatherTest, gather64)
+{
+    check_gather<uint64_t>(VECTOR_PREFETCH_DISTANCE);
+    check_gather<uint64_t>(0);
+}
+
+TEST(vectorGatherTest, gatherOtherSizes)
+{
+    check_gather<uint8_t>(VECTOR_PREFETCH_DISTANCE);
+    check_gather<uint16_t>(VECTOR_PREFETCH_DISTANCE);
+
+    struct triple { uint32_t a, b, c; };
+    vector_t *vector = vector_new(sizeof(triple));
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        triple val = {i, i + 1, i + 2};
+        vector_push_back(vector, &val);
+    }
+
+    const pos_t indices[] = {99, 0, 50, 50};
+    triple out[4];
+    ASSERT_EQ(vector_gather(vector, indices, 4, out), ERROR_NONE);
+    for (int i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(out[i].a, (uint32_t)indices[i]);
+        EXPECT_EQ(out[i].c, (uint32_t)indices[i] + 2);
+    }
+
+    vector_destroy(vector);
+}
+
+TEST(vectorGatherTest, gatherPaddedStride)
+{
+    vector_t *vector = vector_new_aligned_padded(sizeof(uint32_t), 16);
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        vector_push_back(vector, &i);
+    }
+
+    std::vector<pos_t> indices = random_indices(37, 64);
+    std::vector<uint32_t> out(indices.size());
+    ASSERT_EQ(vector_gather(vector, indices.data(), indices.size(), out.data()), ERROR_NONE);
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        EXPECT_EQ(out[i], (uint32_t)indices[i]);
+    }
+
+    vector_destroy(vector);
+}
+
+TEST(vectorGatherTest, gatherOutOfRange)
+{
+    vector_t *vector = filled_vector<uint32_t>(16);
+    uint32_t out[3] = {0, 0, 0};
+
+    const pos_t past_end[] = {1, 2, 16};
+    EXPECT_EQ(vector_gather(vector, past_end, 3, out), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+    // nothing is copied when the batch is rejected
+    EXPECT_EQ(out[0], 0);
+
+    const pos_t negative[] = {1, -1, 2};
+    EXPECT_EQ(vector_gather(vector, negative, 3, out), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+
+    EXPECT_EQ(vector_gather(vector, NULL, 0, NULL), ERROR_NONE);
+    EXPECT_EQ(vector_gather(vector, NULL, 1, out), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADPOINTER);
+
+    vector_destroy(vector);
+}
+
+TEST(vectorGatherTest, scatter)
+{
+    vector_t *vector = filled_vector<uint64_t>(1000);
+    std::vector<pos_t> indices(1000);
+    std::vector<uint64_t> in(1000);
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        // reverse permutation
+        indices[i] = 999 - i;
+        in[i] = i;
+    }
+
+    ASSERT_EQ(vector_scatter(vector, indices.data(), indices.size(), in.data()), ERROR_NONE);
+    for (pos_t i = 0; i < 1000; i++)
+    {
+        uint64_t val;
+        vector_at(vector, i, &val);
+        ASSERT_EQ(val, (uint64_t)(999 - i));
+    }
+
+    // the last of duplicate indices wins
+    const pos_t duplicates[] = {3, 3, 3};
+    const uint64_t values[] = {7, 8, 9};
+    ASSERT_EQ(vector_scatter_prefetch(vector, duplicates, 3, values, 0), ERROR_NONE);
+    uint64_t val;
+    vector_at(vector, 3, &val);
+    EXPECT_EQ(val, 9);
+
+    const pos_t past_end[] = {0, 1000};
+    EXPECT_EQ(vector_scatter(vector, past_end, 2, values), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+    vector_at(vector, 0, &val);
+    EXPECT_EQ(val, 999);
+
+    vector_destroy(vector);
+}
+
+TEST(vectorGatherTest, scatterCopyOnWrite)
+{
+    vector_t *vector = filled_vector<uint32_t>(100);
+    vector_t *clone = vector_clone(vector);
+
+    const pos_t indices[] = {10, 20};
+    const uint32_t in[] = {0, 0};
+    ASSERT_EQ(vector_scatter(clone, indices, 2, in), ERROR_NONE);
+
+    uint32_t val;
+    vector_at(clone, 10, &val);
+    EXPECT_EQ(val, 0);
+    vector_at(vector, 10, &val);
+    EXPECT_EQ(val, 31);
+
+    vector_destroy(clone);
+    vector_destroy(vector);
+}
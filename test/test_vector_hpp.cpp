@@ -0,0 +1,332 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/vector.hpp"
+
+struct point
+{
+    int32_t x;
+    int32_t y;
+
+    bool operator<(const point& other) const
+    {
+        return x != other.x ? x < other.x : y < other.y;
+    }
+
+    bool operator==(const point& other) const
+    {
+        return x == other.x && y == other.y;
+    }
+};
+
+struct alignas(64) line
+{
+    uint64_t value;
+};
+
+static_assert(!std::is_copy_constructible<ccollection::vector<int>>::value, "vector must not copy");
+static_assert(std::is_nothrow_move_constructible<ccollection::vector<int>>::value, "vector must move");
+static_assert(sizeof(ccollection::vector<int>) == sizeof(vector_t*), "vector must be a single pointer");
+
+TEST(vectorHppTest, pushAndAccess)
+{
+    ccollection::vector<uint32_t> vector;
+    EXPECT_TRUE(vector.empty());
+
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        vector.push_back(i * 3);
+    }
+
+    EXPECT_EQ(100u, vector.size());
+    EXPECT_EQ(sizeof(uint32_t), vector_get_stride(vector.get()));
+    EXPECT_EQ(0u, vector.front());
+    EXPECT_EQ(297u, vector.back());
+    EXPECT_EQ(30u, vector[10]);
+    EXPECT_EQ(30u, vector.at(10));
+
+    vector[10] = 7;
+    uint32_t item = 0;
+    EXPECT_EQ(ERROR_NONE, vector_at(vector.get(), 10, &item));
+    EXPECT_EQ(7u, item);
+
+    vector.pop_back();
+    EXPECT_EQ(99u, vector.size());
+}
+
+TEST(vectorHppTest, errors)
+{
+    ccollection::vector<uint32_t> vector(3, 1);
+
+    try
+    {
+        vector.at(3);
+        FAIL();
+    }
+    catch (const std::system_error& error)
+    {
+        EXPECT_EQ(EOUTOFRANGE, error.code().value());
+        EXPECT_EQ(&ccollection::error_category(), &error.code().category());
+        EXPECT_NE(std::string::npos, std::string(error.what()).find("Index out of range"));
+    }
+
+    vector.clear();
+    EXPECT_THROW(vector.pop_back(), std::system_error);
+}
+
+TEST(vectorHppTest, constructors)
+{
+    ccollection::vector<int> none(size_t(0));
+    EXPECT_TRUE(none.empty());
+    ccollection::vector<int> zero(0);
+    EXPECT_TRUE(zero.empty());
+
+    ccollection::vector<int> filled(5, -2);
+    EXPECT_EQ(std::vector<int>(5, -2), std::vector<int>(filled.begin(), filled.end()));
+
+    ccollection::vector<int> listed = {4, 1, 3};
+    EXPECT_EQ(std::vector<int>({4, 1, 3}), std::vector<int>(listed.begin(), listed.end()));
+
+    std::vector<int> source(1000);
+    std::iota(source.begin(), source.end(), 0);
+    ccollection::vector<int> ranged(source.begin(), source.end());
+    EXPECT_TRUE(std::equal(source.begin(), source.end(), ranged.begin()));
+    EXPECT_EQ(1000u, ranged.capacity());
+
+    ccollection::vector<line> aligned(3, line{9});
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(aligned.data()) % alignof(line));
+    EXPECT_EQ(9u, aligned[2].value);
+}
+
+TEST(vectorHppTest, moveAndRelease)
+{
+    ccollection::vector<int> first = {1, 2, 3};
+    vector_t *raw = first.get();
+
+    ccollection::vector<int> second(std::move(first));
+    EXPECT_EQ(raw, second.get());
+    EXPECT_EQ(nullptr, first.get());
+
+    ccollection::vector<int> third = {7};
+    third = std::move(second);
+    EXPECT_EQ(raw, third.get());
+    EXPECT_EQ(3u, third.size());
+
+    using std::swap;
+    ccollection::vector<int> fourth;
+    swap(third, fourth);
+    EXPECT_EQ(raw, fourth.get());
+    EXPECT_TRUE(third.empty());
+
+    vector_t *released = fourth.release();
+    EXPECT_EQ(raw, released);
+    EXPECT_EQ(nullptr, fourth.get());
+    EXPECT_EQ(ERROR_NONE, vector_destroy(released));
+}
+
+TEST(vectorHppTest, cloneSharesUntilWrite)
+{
+    ccollection::vector<int> vector = {1, 2, 3};
+    const ccollection::vector<int> copy = vector.clone();
+
+    EXPECT_EQ(vector.cbegin(), copy.begin());
+
+    vector[0] = 10;
+    EXPECT_NE(vector.cbegin(), copy.begin());
+    EXPECT_EQ(1, copy[0]);
+    EXPECT_EQ(10, vector[0]);
+}
+
+TEST(vectorHppTest, insertEraseResize)
+{
+    ccollection::vector<int> vector = {1, 3};
+
+    ccollection::vector<int>::iterator it = vector.insert(vector.begin() + 1, 2);
+    EXPECT_EQ(2, *it);
+    it = vector.erase(vector.begin());
+    EXPECT_EQ(2, *it);
+    EXPECT_EQ(std::vector<int>({2, 3}), std::vector<int>(vector.begin(), vector.end()));
+
+    vector.resize(5, 9);
+    EXPECT_EQ(std::vector<int>({2, 3, 9, 9, 9}), std::vector<int>(vector.begin(), vector.end()));
+    vector.resize(1);
+    EXPECT_EQ(std::vector<int>({2}), std::vector<int>(vector.begin(), vector.end()));
+
+    ccollection::vector<point> points;
+    EXPECT_EQ(4, points.emplace_back(point{4, 5}).x);
+}
+
+TEST(vectorHppTest, assign)
+{
+    ccollection::vector<int> vector = {1, 2, 3, 4, 5};
+
+    vector.assign(2, 9);
+    EXPECT_EQ(std::vector<int>({9, 9}), std::vector<int>(vector.begin(), vector.end()));
+
+    vector.assign(4, vector[0]);
+    EXPECT_EQ(std::vector<int>({9, 9, 9, 9}), std::vector<int>(vector.begin(), vector.end()));
+
+    vector.assign(0, 1);
+    EXPECT_TRUE(vector.empty());
+}
+
+TEST(vectorHppTest, selfReference)
+{
+    // each call grows the vector while value refers to an element of it
+    ccollection::vector<uint64_t> vector = {7};
+    for (int i = 0; i < 10; i++)
+    {
+        vector.push_back(vector[0]);
+    }
+    vector.insert(vector.begin(), vector.back());
+    vector.resize(vector.capacity() + 1, vector[1]);
+
+    EXPECT_EQ(vector.size(), (size_t)std::count(vector.begin(), vector.end(), 7u));
+}
+
+TEST(vectorHppTest, standardAlgorithms)
+{
+    ccollection::vector<int> vector;
+    for (int i = 0; i < 1000; i++)
+    {
+        vector.push_back((i * 7919) % 1000);
+    }
+
+    std::sort(vector.begin(), vector.end());
+    EXPECT_TRUE(std::is_sorted(vector.cbegin(), vector.cend()));
+    EXPECT_EQ(499500, std::accumulate(vector.begin(), vector.end(), 0));
+    EXPECT_EQ(999, *vector.rbegin());
+    EXPECT_EQ(250, *std::lower_bound(vector.begin(), vector.end(), 250));
+
+    int sum = 0;
+    for (const int value : vector)
+    {
+        sum += value;
+    }
+    EXPECT_EQ(499500, sum);
+}
+
+TEST(vectorHppTest, libraryAlgorithms)
+{
+    EXPECT_EQ(nullptr, ccollection::compare<uint64_t>());
+    EXPECT_EQ(nullptr, ccollection::compare<uint8_t>());
+    EXPECT_NE(nullptr, ccollection::compare<int32_t>());
+    EXPECT_NE(nullptr, ccollection::compare<point>());
+
+    ccollection::vector<uint64_t> keys;
+    std::vector<uint64_t> expected;
+    for (uint64_t i = 0; i < 5000; i++)
+    {
+        keys.push_back((i * 2654435761u) % 1024);
+        expected.push_back((i * 2654435761u) % 1024);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    keys.nth_element(2500);
+    EXPECT_EQ(expected[2500], keys[2500]);
+
+    keys.sort();
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), keys.begin()));
+
+    keys.unique();
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    EXPECT_EQ(expected.size(), keys.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), keys.begin()));
+
+    ccollection::vector<point> points = {{2, 1}, {-1, 5}, {2, 0}, {-1, 5}, {0, 0}};
+    points.partial_sort(2);
+    EXPECT_EQ((point{-1, 5}), points[0]);
+    EXPECT_EQ((point{-1, 5}), points[1]);
+    points.sort();
+    points.unique();
+    std::vector<point> sorted = {{-1, 5}, {0, 0}, {2, 0}, {2, 1}};
+    EXPECT_TRUE(std::equal(sorted.begin(), sorted.end(), points.begin()));
+    EXPECT_EQ(4u, points.size());
+}
+
+TEST(vectorHppTest, inlineOrderedAlgorithms)
+{
+    EXPECT_TRUE(ccollection::inline_ordered<int32_t>());
+    EXPECT_TRUE(ccollection::inline_ordered<double>());
+    EXPECT_FALSE(ccollection::inline_ordered<uint32_t>());
+    EXPECT_FALSE(ccollection::inline_ordered<point>());
+
+    ccollection::vector<int64_t> keys;
+    std::vector<int64_t> expected;
+    for (int64_t i = 0; i < 5000; i++)
+    {
+        keys.push_back((i * 2654435761) % 1024 - 512);
+        expected.push_back((i * 2654435761) % 1024 - 512);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    keys.nth_element(2500);
+    EXPECT_EQ(expected[2500], keys[2500]);
+    EXPECT_THROW(keys.nth_element(5000), std::system_error);
+
+    keys.partial_sort(10);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.begin() + 10, keys.begin()));
+
+    keys.sort();
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), keys.begin()));
+
+    keys.unique();
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    EXPECT_EQ(expected.size(), keys.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), keys.begin()));
+
+    ccollection::vector<double> values = {2.5, -1.0, 0.0, -1.0, 3.25};
+    values.sort();
+    values.unique();
+    std::vector<double> sorted = {-1.0, 0.0, 2.5, 3.25};
+    EXPECT_EQ(sorted.size(), values.size());
+    EXPECT_TRUE(std::equal(sorted.begin(), sorted.end(), values.begin()));
+}
+
+TEST(vectorHppTest, layoutMatchesLibrary)
+{
+    ccollection::vector<uint32_t> vector = {1, 2, 3};
+    const vector_layout_t *layout = vector_layout(vector.get());
+
+    EXPECT_EQ(vector_cdata(vector.get()), layout->items);
+    EXPECT_EQ(vector_get_size(vector.get()), layout->size);
+    EXPECT_EQ(vector_get_capacity(vector.get()), layout->capacity);
+    EXPECT_TRUE(vector_layout_writable(layout));
+
+    // a clone shares the buffer, writing through the wrapper gives it its own
+    ccollection::vector<uint32_t> copy = vector.clone();
+    EXPECT_FALSE(vector_layout_writable(vector_layout(copy.get())));
+    copy[0] = 9;
+    EXPECT_TRUE(vector_layout_writable(vector_layout(copy.get())));
+    EXPECT_EQ(1u, vector.cbegin()[0]);
+}
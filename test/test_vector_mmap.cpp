@@ -0,0 +1,164 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+class vectorMmapTest : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        strcpy(path, "/tmp/ccollection_mmap_XXXXXX");
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+    }
+    void TearDown()
+    {
+        unlink(path);
+    }
+
+    char path[64];
+};
+
+TEST_F(vectorMmapTest, newMappedVector)
+{
+    vector_t *vector = vector_new_mapped(path, sizeof(int));
+
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_is_empty(vector), true);
+    EXPECT_EQ(vector_get_size(vector), 0);
+    EXPECT_EQ(vector_get_capacity(vector), 1);
+
+    vector_destroy(vector);
+}
+
+TEST_F(vectorMmapTest, newMappedVectorBadSize)
+{
+    vector_t *vector = vector_new_mapped(path, 0);
+    EXPECT_TRUE(vector == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+}
+
+TEST_F(vectorMmapTest, pushAndReopen)
+{
+    vector_t *vector = vector_new_mapped(path, sizeof(int));
+
+    ASSERT_TRUE(vector != NULL);
+
+    const int count = 1 << 16;
+
+    for (int i = 0; i < count; i++)
+    {
+        EXPECT_EQ(vector_push_back(vector, &i), ERROR_NONE);
+    }
+    EXPECT_EQ(vector_flush(vector), ERROR_NONE);
+    vector_destroy(vector);
+
+    vector = vector_open_mapped(path);
+    ASSERT_TRUE(vector != NULL);
+    ASSERT_EQ(vector_get_size(vector), count);
+
+    for (int i = 0; i < count; i++)
+    {
+        int out;
+        EXPECT_EQ(vector_at(vector, i, &out), ERROR_NONE);
+        EXPECT_EQ(out, i);
+    }
+
+    // keep modifying the reopened vector
+    int val = -1;
+    EXPECT_EQ(vector_insert(vector, 0, &val), ERROR_NONE);
+    EXPECT_EQ(vector_erase(vector, count), ERROR_NONE);
+    vector_destroy(vector);
+
+    vector = vector_open_mapped(path);
+    ASSERT_TRUE(vector != NULL);
+    ASSERT_EQ(vector_get_size(vector), count);
+
+    int out;
+    vector_at(vector, 0, &out);
+    EXPECT_EQ(out, -1);
+    vector_at(vector, count - 1, &out);
+    EXPECT_EQ(out, count - 2);
+
+    vector_destroy(vector);
+}
+
+TEST_F(vectorMmapTest, reserveGrowsFile)
+{
+    vector_t *vector = vector_new_mapped(path, sizeof(double));
+
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_reserve(vector, 1000), ERROR_NONE);
+    EXPECT_EQ(vector_get_capacity(vector), 1000);
+    vector_destroy(vector);
+
+    vector = vector_open_mapped(path);
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_get_size(vector), 0);
+    EXPECT_EQ(vector_get_capacity(vector), 1000);
+    vector_destroy(vector);
+}
+
+TEST_F(vectorMmapTest, openBadFormat)
+{
+    FILE *file = fopen(path, "w");
+    ASSERT_TRUE(file != NULL);
+    for (int i = 0; i < 128; i++)
+    {
+        fputc('x', file);
+    }
+    fclose(file);
+
+    vector_t *vector = vector_open_mapped(path);
+    EXPECT_TRUE(vector == NULL);
+    EXPECT_EQ(errno, EBADFORMAT);
+}
+
+TEST_F(vectorMmapTest, openMissingFile)
+{
+    unlink(path);
+
+    vector_t *vector = vector_open_mapped(path);
+    EXPECT_TRUE(vector == NULL);
+    EXPECT_EQ(errno, ENOENT);
+}
+
+TEST_F(vectorMmapTest, flushHeapVector)
+{
+    vector_t *vector = vector_new(sizeof(int));
+
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_flush(vector), ERROR_NONE);
+    vector_destroy(vector);
+}
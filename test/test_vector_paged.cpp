@@ -0,0 +1,130 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+static void fill_and_check(vector_t* vector, const int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(vector_push_back(vector, &i), ERROR_NONE);
+    }
+    ASSERT_EQ(vector_get_size(vector), count);
+
+    for (int i = 0; i < count; i++)
+    {
+        int out;
+        ASSERT_EQ(vector_at(vector, i, &out), ERROR_NONE);
+        ASSERT_EQ(out, i);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(vector_pop_back(vector), ERROR_NONE);
+    }
+    EXPECT_EQ(vector_is_empty(vector), true);
+}
+
+TEST(vectorPagedTest, newPagedVector)
+{
+    vector_t *vector = vector_new_paged(sizeof(int), NULL);
+
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_get_size(vector), 0);
+    EXPECT_EQ(vector_get_capacity(vector), 1);
+
+    vector_destroy(vector);
+}
+
+TEST(vectorPagedTest, newPagedVectorBadSize)
+{
+    vector_t *vector = vector_new_paged(0, NULL);
+    EXPECT_TRUE(vector == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+}
+
+TEST(vectorPagedTest, defaultPages)
+{
+    vector_page_options_t options = { VECTOR_PAGES_DEFAULT, VECTOR_NUMA_DEFAULT, 0 };
+    vector_t *vector = vector_new_paged(sizeof(int), &options);
+
+    ASSERT_TRUE(vector != NULL);
+    fill_and_check(vector, 1 << 18);
+    EXPECT_EQ(vector_get_pages(vector), VECTOR_PAGES_DEFAULT);
+    vector_destroy(vector);
+}
+
+TEST(vectorPagedTest, transparentHugePages)
+{
+    vector_page_options_t options = { VECTOR_PAGES_TRANSPARENT, VECTOR_NUMA_DEFAULT, 0 };
+    vector_t *vector = vector_new_paged(sizeof(int), &options);
+
+    ASSERT_TRUE(vector != NULL);
+    fill_and_check(vector, 1 << 20);
+    EXPECT_EQ(vector_get_pages(vector), VECTOR_PAGES_TRANSPARENT);
+    vector_destroy(vector);
+}
+
+TEST(vectorPagedTest, hugetlbFallsBack)
+{
+    // passes whether or not the hugetlb pool has pages
+    vector_page_options_t options = { VECTOR_PAGES_HUGETLB, VECTOR_NUMA_DEFAULT, 0 };
+    vector_t *vector = vector_new_paged(sizeof(int), &options);
+
+    ASSERT_TRUE(vector != NULL);
+    fill_and_check(vector, 1 << 20);
+    const vector_pages_t pages = vector_get_pages(vector);
+    EXPECT_TRUE(pages == VECTOR_PAGES_HUGETLB || pages == VECTOR_PAGES_TRANSPARENT);
+    vector_destroy(vector);
+}
+
+TEST(vectorPagedTest, numaInterleave)
+{
+    vector_page_options_t options = { VECTOR_PAGES_TRANSPARENT, VECTOR_NUMA_INTERLEAVE, 1 };
+    vector_t *vector = vector_new_paged(sizeof(int), &options);
+
+    ASSERT_TRUE(vector != NULL);
+    fill_and_check(vector, 1 << 18);
+    vector_destroy(vector);
+}
+
+TEST(vectorPagedTest, reserveAndClear)
+{
+    vector_t *vector = vector_new_paged(sizeof(double), NULL);
+
+    ASSERT_TRUE(vector != NULL);
+    EXPECT_EQ(vector_reserve(vector, 1 << 20), ERROR_NONE);
+    EXPECT_EQ(vector_get_capacity(vector), 1 << 20);
+
+    double val = 1.5;
+    EXPECT_EQ(vector_assign_n(vector, 1000, &val), ERROR_NONE);
+    EXPECT_EQ(vector_clear(vector), ERROR_NONE);
+    EXPECT_EQ(vector_get_size(vector), 0);
+    EXPECT_EQ(vector_get_capacity(vector), 1);
+
+    vector_destroy(vector);
+}
@@ -0,0 +1,285 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+template <typename T>
+static vector_t* to_vector(const std::vector<T>& keys)
+{
+    vector_t *vector = vector_new(sizeof(T));
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        vector_push_back(vector, &keys[i]);
+    }
+    return vector;
+}
+
+template <typename T>
+static std::vector<T> to_std(const vector_t* vector)
+{
+    std::vector<T> keys(vector_get_size(vector));
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        vector_at(vector, i, &keys[i]);
+    }
+    return keys;
+}
+
+/**
+ * random keys, sorted, reversed, all equal and organ pipe inputs
+ */
+template <typename T>
+static std::vector<std::vector<T>> inputs(const size_t n)
+{
+    std::vector<std::vector<T>> all(5, std::vector<T>(n));
+    for (size_t i = 0; i < n; i++)
+    {
+        all[0][i] = (T)rand();
+        all[1][i] = (T)i;
+        all[2][i] = (T)(n - i);
+        all[3][i] = 7;
+        all[4][i] = (T)MIN(i, n - i);
+    }
+    return all;
+}
+
+template <typename T>
+static void check_nth_element(const size_t n)
+{
+    for (const std::vector<T>& keys : inputs<T>(n))
+    {
+        std::vector<T> sorted = keys;
+        std::sort(sorted.begin(), sorted.end());
+
+        for (pos_t nth : {(pos_t)0, (pos_t)(n / 2), (pos_t)(n - 1), (pos_t)(rand() % n)})
+        {
+            vector_t *vector = to_vector(keys);
+            ASSERT_EQ(vector_nth_element(vector, nth, NULL), ERROR_NONE);
+
+            std::vector<T> result = to_std<T>(vector);
+            ASSERT_EQ(result[nth], sorted[nth]);
+            for (size_t i = 0; i < n; i++)
+            {
+                ASSERT_TRUE((i < (size_t)nth) ? result[i] <= result[nth] : result[i] >= result[nth]);
+            }
+            std::sort(result.begin(), result.end());
+            ASSERT_EQ(result, sorted);
+
+            vector_destroy(vector);
+        }
+    }
+}
+
+TEST(vectorSelectTest, nthElement)
+{
+    check_nth_element<uint32_t>(10000);
+    check_nth_element<uint64_t>(10000);
+    check_nth_element<uint16_t>(5000);
+    check_nth_element<uint32_t>(1);
+    check_nth_element<uint32_t>(17);
+}
+
+TEST(vectorSelectTest, nthElementOutOfRange)
+{
+    vector_t *vector = vector_new(sizeof(uint32_t));
+    EXPECT_EQ(vector_nth_element(vector, 0, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+
+    uint32_t val = 1;
+    vector_push_back(vector, &val);
+    EXPECT_EQ(vector_nth_element(vector, -1, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EOUTOFRANGE);
+    EXPECT_EQ(vector_nth_element(vector, 0, NULL), ERROR_NONE);
+
+    vector_destroy(vector);
+
+    vector = vector_new(3);
+    vector_push_back(vector, "ab");
+    EXPECT_EQ(vector_nth_element(vector, 0, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+    vector_destroy(vector);
+}
+
+template <typename T>
+static void check_partial_sort(const size_t n, const size_t count)
+{
+    for (const std::vector<T>& keys : inputs<T>(n))
+    {
+        std::vector<T> expected = keys;
+        std::sort(expected.begin(), expected.end());
+        expected.resize(MIN(count, n));
+
+        vector_t *vector = to_vector(keys);
+        ASSERT_EQ(vector_partial_sort(vector, count, NULL), ERROR_NONE);
+        std::vector<T> result = to_std<T>(vector);
+        result.resize(MIN(count, n));
+        ASSERT_EQ(result, expected);
+
+        vector_destroy(vector);
+    }
+}
+
+TEST(vectorSelectTest, partialSort)
+{
+    check_partial_sort<uint32_t>(10000, 100);
+    check_partial_sort<uint64_t>(10000, 100);
+    check_partial_sort<uint32_t>(10000, 10000);
+    check_partial_sort<uint64_t>(5000, 20000);
+    check_partial_sort<uint8_t>(1000, 50);
+    check_partial_sort<uint32_t>(100, 0);
+}
+
+struct record
+{
+    float score;
+    int id;
+};
+
+static int compare_score(const item_t* first, const item_t* second)
+{
+    const float a = ((const record*)first)->score, b = ((const record*)second)->score;
+    return (a > b) - (a < b);
+}
+
+TEST(vectorSelectTest, comparator)
+{
+    std::vector<record> records(5000);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        records[i] = {(float)(rand() % 1000) / 10, (int)i};
+    }
+    std::vector<float> scores(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        scores[i] = records[i].score;
+    }
+    std::sort(scores.begin(), scores.end());
+
+    vector_t *vector = to_vector(records);
+    ASSERT_EQ(vector_nth_element(vector, 2500, compare_score), ERROR_NONE);
+    record median;
+    vector_at(vector, 2500, &median);
+    EXPECT_EQ(median.score, scores[2500]);
+
+    ASSERT_EQ(vector_partial_sort(vector, 10, compare_score), ERROR_NONE);
+    for (pos_t i = 0; i < 10; i++)
+    {
+        record item;
+        vector_at(vector, i, &item);
+        EXPECT_EQ(item.score, scores[i]);
+        EXPECT_EQ(records[item.id].score, item.score);
+    }
+
+    vector_destroy(vector);
+}
+
+template <typename T>
+static void check_topk(const size_t k, const size_t batches, const size_t batch)
+{
+    vector_topk_t *topk = vector_topk_new(sizeof(T), k, NULL);
+    ASSERT_TRUE(topk != NULL);
+
+    std::vector<T> all;
+    for (size_t b = 0; b < batches; b++)
+    {
+        std::vector<T> keys(batch);
+        for (size_t i = 0; i < batch; i++)
+        {
+            keys[i] = (T)(rand() % 100000);
+        }
+        all.insert(all.end(), keys.begin(), keys.end());
+        ASSERT_EQ(vector_topk_push_n(topk, keys.data(), keys.size()), ERROR_NONE);
+    }
+
+    std::sort(all.begin(), all.end(), std::greater<T>());
+    all.resize(MIN(k, all.size()));
+    EXPECT_EQ(vector_topk_get_size(topk), all.size());
+
+    vector_t *out = vector_new(sizeof(T));
+    ASSERT_EQ(vector_topk_get(topk, out), ERROR_NONE);
+    EXPECT_EQ(to_std<T>(out), all);
+
+    vector_destroy(out);
+    vector_topk_destroy(topk);
+}
+
+TEST(vectorSelectTest, topk)
+{
+    check_topk<uint32_t>(100, 50, 1000);
+    check_topk<uint64_t>(100, 50, 1000);
+    check_topk<uint16_t>(10, 20, 333);
+    check_topk<uint32_t>(100, 1, 30);
+    check_topk<uint32_t>(1, 10, 100);
+}
+
+TEST(vectorSelectTest, topkVectorsAndClear)
+{
+    vector_topk_t *topk = vector_topk_new(sizeof(record), 3, compare_score);
+    vector_t *batch = vector_new_aligned_padded(sizeof(record), 16);
+    for (int i = 0; i < 100; i++)
+    {
+        record item = {(float)((i * 37) % 100), i};
+        vector_push_back(batch, &item);
+    }
+    ASSERT_EQ(vector_topk_push_vector(topk, batch), ERROR_NONE);
+
+    vector_t *out = vector_new(sizeof(record));
+    ASSERT_EQ(vector_topk_get(topk, out), ERROR_NONE);
+    ASSERT_EQ(vector_get_size(out), 3);
+    for (pos_t i = 0; i < 3; i++)
+    {
+        record item;
+        vector_at(out, i, &item);
+        EXPECT_EQ(item.score, 99 - i);
+    }
+
+    EXPECT_EQ(vector_topk_clear(topk), ERROR_NONE);
+    EXPECT_EQ(vector_topk_get_size(topk), 0);
+    record low = {1, 0};
+    vector_topk_push_n(topk, &low, 1);
+    ASSERT_EQ(vector_topk_get(topk, out), ERROR_NONE);
+    EXPECT_EQ(vector_get_size(out), 1);
+
+    vector_t *wrong = vector_new(sizeof(int));
+    EXPECT_EQ(vector_topk_push_vector(topk, wrong), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+    EXPECT_TRUE(vector_topk_new(sizeof(record), 0, compare_score) == NULL);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_TRUE(vector_topk_new(3, 3, NULL) == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+
+    vector_destroy(wrong);
+    vector_destroy(out);
+    vector_destroy(batch);
+    vector_topk_destroy(topk);
+}
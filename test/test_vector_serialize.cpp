@@ -0,0 +1,200 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+static vector_t* make_vector(const int count)
+{
+    vector_t *vector = vector_new(sizeof(int));
+
+    for (int i = 0; i < count; i++)
+    {
+        int val = i * 3;
+        vector_push_back(vector, &val);
+    }
+    return vector;
+}
+
+TEST(vectorSerializeTest, roundTripBuffer)
+{
+    const int count = 1 << 12;
+    vector_t *vector = make_vector(count);
+
+    ASSERT_TRUE(vector != NULL);
+
+    size_t size = vector_serialized_size(vector);
+    EXPECT_GT(size, count * sizeof(int));
+
+    std::vector<uint8_t> buffer(size);
+    EXPECT_EQ(vector_serialize(vector, buffer.data(), buffer.size()), ERROR_NONE);
+
+    vector_t *copy = vector_deserialize(buffer.data(), buffer.size());
+    ASSERT_TRUE(copy != NULL);
+    ASSERT_EQ(vector_get_size(copy), count);
+
+    for (int i = 0; i < count; i++)
+    {
+        int out;
+        vector_at(copy, i, &out);
+        EXPECT_EQ(out, i * 3);
+    }
+
+    // the copy owns its items
+    int val = 7;
+    EXPECT_EQ(vector_push_back(copy, &val), ERROR_NONE);
+
+    vector_destroy(copy);
+    vector_destroy(vector);
+}
+
+TEST(vectorSerializeTest, emptyVector)
+{
+    vector_t *vector = vector_new(sizeof(double));
+
+    std::vector<uint8_t> buffer(vector_serialized_size(vector));
+    EXPECT_EQ(vector_serialize(vector, buffer.data(), buffer.size()), ERROR_NONE);
+
+    vector_t *copy = vector_deserialize(buffer.data(), buffer.size());
+    ASSERT_TRUE(copy != NULL);
+    EXPECT_EQ(vector_is_empty(copy), true);
+
+    vector_destroy(copy);
+    vector_destroy(vector);
+}
+
+TEST(vectorSerializeTest, bufferTooSmall)
+{
+    vector_t *vector = make_vector(10);
+
+    std::vector<uint8_t> buffer(vector_serialized_size(vector) - 1);
+    EXPECT_EQ(vector_serialize(vector, buffer.data(), buffer.size()), ERROR_FAILED);
+    EXPECT_EQ(errno, ENOBUFS);
+
+    vector_destroy(vector);
+}
+
+TEST(vectorSerializeTest, corruptPayload)
+{
+    vector_t *vector = make_vector(100);
+
+    std::vector<uint8_t> buffer(vector_serialized_size(vector));
+    vector_serialize(vector, buffer.data(), buffer.size());
+    buffer[buffer.size() - 1] ^= 0xff;
+
+    EXPECT_TRUE(vector_deserialize(buffer.data(), buffer.size()) == NULL);
+    EXPECT_EQ(errno, EBADFORMAT);
+
+    // truncated
+    vector_serialize(vector, buffer.data(), buffer.size());
+    EXPECT_TRUE(vector_deserialize(buffer.data(), buffer.size() - 4) == NULL);
+    EXPECT_EQ(errno, EBADFORMAT);
+
+    // bad magic
+    buffer[0] = 'x';
+    EXPECT_TRUE(vector_deserialize(buffer.data(), buffer.size()) == NULL);
+    EXPECT_EQ(errno, EBADFORMAT);
+
+    vector_destroy(vector);
+}
+
+TEST(vectorSerializeTest, roundTripFd)
+{
+    const int count = 1 << 16;
+    vector_t *vector = make_vector(count);
+
+    char path[] = "/tmp/ccollection_serialize_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    unlink(path);
+
+    EXPECT_EQ(vector_serialize_fd(vector, fd), ERROR_NONE);
+    // two vectors back to back in the same stream
+    EXPECT_EQ(vector_serialize_fd(vector, fd), ERROR_NONE);
+    lseek(fd, 0, SEEK_SET);
+
+    for (int n = 0; n < 2; n++)
+    {
+        vector_t *copy = vector_deserialize_fd(fd);
+        ASSERT_TRUE(copy != NULL);
+        ASSERT_EQ(vector_get_size(copy), count);
+
+        for (int i = 0; i < count; i++)
+        {
+            int out;
+            vector_at(copy, i, &out);
+            EXPECT_EQ(out, i * 3);
+        }
+        vector_destroy(copy);
+    }
+
+    // end of stream
+    EXPECT_TRUE(vector_deserialize_fd(fd) == NULL);
+    EXPECT_EQ(errno, EBADFORMAT);
+
+    close(fd);
+    vector_destroy(vector);
+}
+
+TEST(vectorSerializeTest, viewIsReadOnly)
+{
+    const int count = 1 << 10;
+    vector_t *vector = make_vector(count);
+
+    std::vector<uint8_t> buffer(vector_serialized_size(vector));
+    vector_serialize(vector, buffer.data(), buffer.size());
+    vector_destroy(vector);
+
+    vector_t *view = vector_view(buffer.data(), buffer.size());
+    ASSERT_TRUE(view != NULL);
+    ASSERT_EQ(vector_get_size(view), count);
+
+    int out;
+    vector_at(view, 10, &out);
+    EXPECT_EQ(out, 30);
+
+    int val = 1;
+    EXPECT_EQ(vector_push_back(view, &val), ERROR_FAILED);
+    EXPECT_EQ(errno, EREADONLY);
+    EXPECT_EQ(vector_insert(view, 0, &val), ERROR_FAILED);
+    EXPECT_EQ(errno, EREADONLY);
+    EXPECT_EQ(vector_pop_back(view), ERROR_FAILED);
+    EXPECT_EQ(errno, EREADONLY);
+    EXPECT_EQ(vector_assign_n(view, 2, &val), ERROR_FAILED);
+    EXPECT_EQ(errno, EREADONLY);
+    EXPECT_EQ(vector_clear(view), ERROR_FAILED);
+    EXPECT_EQ(errno, EREADONLY);
+    EXPECT_EQ(vector_reserve(view, count * 2), ERROR_FAILED);
+    EXPECT_EQ(errno, EREADONLY);
+    EXPECT_EQ(vector_get_size(view), count);
+
+    vector_destroy(view);
+}
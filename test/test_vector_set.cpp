@@ -0,0 +1,278 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+template <typename T>
+static std::vector<T> sorted_keys(const size_t n, const size_t range)
+{
+    std::vector<T> keys(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        keys[i] = (T)(rand() % range);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+template <typename T>
+static vector_t* to_vector(const std::vector<T>& keys, vector_t* vector = NULL)
+{
+    if (vector == NULL)
+    {
+        vector = vector_new(sizeof(T));
+    }
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        vector_push_back(vector, &keys[i]);
+    }
+    return vector;
+}
+
+template <typename T>
+static std::vector<T> to_std(const vector_t* vector)
+{
+    std::vector<T> keys(vector_get_size(vector));
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        vector_at(vector, i, &keys[i]);
+    }
+    return keys;
+}
+
+template <typename T>
+static std::vector<T> unique_keys(std::vector<T> keys)
+{
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+/**
+ * compare all operations with the standard algorithms on the deduplicated inputs
+ */
+template <typename T>
+static void check_sets(const std::vector<T>& a, const std::vector<T>& b, vector_t* first, vector_t* second,
+        vector_t* out, vector_compare_t compare)
+{
+    const std::vector<T> ua = unique_keys(a), ub = unique_keys(b);
+    std::vector<T> expected;
+
+    ASSERT_EQ(vector_merge(first, second, out, compare), ERROR_NONE);
+    std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    ASSERT_EQ(to_std<T>(out), expected);
+
+    expected.clear();
+    ASSERT_EQ(vector_union(first, second, out, compare), ERROR_NONE);
+    std::set_union(ua.begin(), ua.end(), ub.begin(), ub.end(), std::back_inserter(expected));
+    ASSERT_EQ(to_std<T>(out), expected);
+
+    expected.clear();
+    ASSERT_EQ(vector_intersection(first, second, out, compare), ERROR_NONE);
+    std::set_intersection(ua.begin(), ua.end(), ub.begin(), ub.end(), std::back_inserter(expected));
+    ASSERT_EQ(to_std<T>(out), expected);
+
+    expected.clear();
+    ASSERT_EQ(vector_difference(first, second, out, compare), ERROR_NONE);
+    std::set_difference(ua.begin(), ua.end(), ub.begin(), ub.end(), std::back_inserter(expected));
+    ASSERT_EQ(to_std<T>(out), expected);
+
+    expected.clear();
+    ASSERT_EQ(vector_difference(second, first, out, compare), ERROR_NONE);
+    std::set_difference(ub.begin(), ub.end(), ua.begin(), ua.end(), std::back_inserter(expected));
+    ASSERT_EQ(to_std<T>(out), expected);
+}
+
+template <typename T>
+static void check_keys(const size_t n1, const size_t n2, const size_t range)
+{
+    const std::vector<T> a = sorted_keys<T>(n1, range), b = sorted_keys<T>(n2, range);
+    vector_t *first = to_vector(a), *second = to_vector(b);
+    vector_t *out = vector_new(sizeof(T));
+
+    check_sets(a, b, first, second, out, NULL);
+
+    vector_destroy(first);
+    vector_destroy(second);
+    vector_destroy(out);
+}
+
+TEST(vectorSetTest, keys32)
+{
+    for (int round = 0; round < 20; round++)
+    {
+        // dense ranges give long runs of matches and duplicates, sparse ones few
+        check_keys<uint32_t>(rand() % 500, rand() % 500, 300);
+        check_keys<uint32_t>(rand() % 500, rand() % 500, 100000);
+    }
+    check_keys<uint32_t>(0, 100, 1000);
+    check_keys<uint32_t>(100, 0, 1000);
+    check_keys<uint32_t>(0, 0, 1000);
+}
+
+TEST(vectorSetTest, keys64)
+{
+    for (int round = 0; round < 20; round++)
+    {
+        check_keys<uint64_t>(rand() % 500, rand() % 500, 300);
+        check_keys<uint64_t>(rand() % 500, rand() % 500, 100000);
+    }
+}
+
+TEST(vectorSetTest, skewedSizes)
+{
+    // galloping through the larger input
+    check_keys<uint32_t>(10, 10000, 20000);
+    check_keys<uint32_t>(10000, 10, 20000);
+    check_keys<uint64_t>(7, 5000, 10000);
+    check_keys<uint64_t>(5000, 7, 10000);
+    check_keys<uint16_t>(10, 10000, 20000);
+    check_keys<uint16_t>(10000, 10, 20000);
+}
+
+TEST(vectorSetTest, otherKeySizes)
+{
+    for (int round = 0; round < 10; round++)
+    {
+        check_keys<uint8_t>(rand() % 300, rand() % 300, 200);
+        check_keys<uint16_t>(rand() % 300, rand() % 300, 1000);
+    }
+}
+
+TEST(vectorSetTest, paddedKeys)
+{
+    const std::vector<uint32_t> a = sorted_keys<uint32_t>(200, 300), b = sorted_keys<uint32_t>(150, 300);
+    vector_t *first = to_vector(a, vector_new_aligned_padded(sizeof(uint32_t), 16));
+    vector_t *second = to_vector(b);
+    vector_t *out = vector_new_aligned_padded(sizeof(uint32_t), 16);
+
+    check_sets(a, b, first, second, out, NULL);
+
+    vector_destroy(first);
+    vector_destroy(second);
+    vector_destroy(out);
+}
+
+static int compare_descending(const item_t* first, const item_t* second)
+{
+    const int a = *(const int*)first, b = *(const int*)second;
+    return (b > a) - (b < a);
+}
+
+TEST(vectorSetTest, comparator)
+{
+    std::vector<int> a = sorted_keys<int>(300, 200), b = sorted_keys<int>(300, 200);
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        a[i] -= 100;
+    }
+    std::reverse(a.begin(), a.end());
+    std::reverse(b.begin(), b.end());
+    vector_t *first = to_vector(a), *second = to_vector(b);
+    vector_t *out = vector_new(sizeof(int));
+    const std::vector<int> ua = unique_keys(a), ub = unique_keys(b);
+    std::vector<int> expected;
+
+    ASSERT_EQ(vector_union(first, second, out, compare_descending), ERROR_NONE);
+    std::set_union(ua.begin(), ua.end(), ub.begin(), ub.end(), std::back_inserter(expected), std::greater<int>());
+    EXPECT_EQ(to_std<int>(out), expected);
+
+    expected.clear();
+    ASSERT_EQ(vector_intersection(first, second, out, compare_descending), ERROR_NONE);
+    std::set_intersection(ua.begin(), ua.end(), ub.begin(), ub.end(), std::back_inserter(expected),
+            std::greater<int>());
+    EXPECT_EQ(to_std<int>(out), expected);
+
+    ASSERT_EQ(vector_unique(first, compare_descending), ERROR_NONE);
+    EXPECT_EQ(to_std<int>(first), ua);
+
+    vector_destroy(first);
+    vector_destroy(second);
+    vector_destroy(out);
+}
+
+template <typename T>
+static void check_unique(const size_t n, const size_t range)
+{
+    const std::vector<T> keys = sorted_keys<T>(n, range);
+    vector_t *vector = to_vector(keys);
+
+    ASSERT_EQ(vector_unique(vector, NULL), ERROR_NONE);
+    ASSERT_EQ(to_std<T>(vector), unique_keys(keys));
+
+    vector_destroy(vector);
+}
+
+TEST(vectorSetTest, unique)
+{
+    for (int round = 0; round < 20; round++)
+    {
+        check_unique<uint32_t>(rand() % 1000, 10 + rand() % 2000);
+        check_unique<uint64_t>(rand() % 1000, 10 + rand() % 2000);
+        check_unique<uint16_t>(rand() % 1000, 10 + rand() % 2000);
+    }
+    check_unique<uint32_t>(0, 10);
+    check_unique<uint32_t>(1000, 1);
+}
+
+TEST(vectorSetTest, badArguments)
+{
+    vector_t *first = vector_new(sizeof(uint32_t)), *second = vector_new(sizeof(uint32_t));
+    vector_t *wide = vector_new(sizeof(uint64_t));
+    vector_t *odd = vector_new(3);
+
+    EXPECT_EQ(vector_union(first, second, first, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_EQ(vector_union(first, second, wide, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+    EXPECT_EQ(vector_union(first, NULL, wide, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADPOINTER);
+    EXPECT_EQ(vector_unique(odd, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+
+    // a fixed capacity out must hold the largest possible result
+    uint32_t buffer[4];
+    vector_t *fixed = vector_wrap(buffer, 4, sizeof(uint32_t));
+    const std::vector<uint32_t> keys = {1, 2, 3};
+    to_vector(keys, first);
+    to_vector(keys, second);
+    EXPECT_EQ(vector_intersection(first, second, fixed, NULL), ERROR_NONE);
+    EXPECT_EQ(vector_get_size(fixed), 3);
+    EXPECT_EQ(vector_merge(first, second, fixed, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EFULL);
+
+    vector_destroy(fixed);
+    vector_destroy(first);
+    vector_destroy(second);
+    vector_destroy(wide);
+    vector_destroy(odd);
+}
@@ -0,0 +1,223 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+class vectorSortTest : public ::testing::Test
+{
+protected:
+    void SetUp()
+    {
+        strcpy(input, "/tmp/ccollection_sort_in_XXXXXX");
+        strcpy(output, "/tmp/ccollection_sort_out_XXXXXX");
+        close(mkstemp(input));
+        close(mkstemp(output));
+    }
+    void TearDown()
+    {
+        unlink(input);
+        unlink(output);
+    }
+
+    template <typename T>
+    void write_records(const std::vector<T>& records)
+    {
+        FILE *file = fopen(input, "wb");
+        ASSERT_TRUE(file != NULL);
+        if (!records.empty())
+        {
+            fwrite(records.data(), sizeof(T), records.size(), file);
+        }
+        fclose(file);
+    }
+
+    template <typename T>
+    std::vector<T> read_records()
+    {
+        FILE *file = fopen(output, "rb");
+        fseek(file, 0, SEEK_END);
+        std::vector<T> records(ftell(file) / sizeof(T));
+        fseek(file, 0, SEEK_SET);
+        EXPECT_EQ(fread(records.data(), sizeof(T), records.size(), file), records.size());
+        fclose(file);
+        return records;
+    }
+
+    template <typename T>
+    void check_sort(const size_t n, const size_t budget)
+    {
+        std::vector<T> records(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            records[i] = (T)rand();
+        }
+        write_records(records);
+
+        vector_sort_options_t options = {};
+        options.memory_budget = budget;
+        ASSERT_EQ(vector_sort_file(input, output, sizeof(T), NULL, &options), ERROR_NONE);
+
+        std::sort(records.begin(), records.end());
+        ASSERT_EQ(read_records<T>(), records);
+    }
+
+    char input[64];
+    char output[64];
+};
+
+TEST_F(vectorSortTest, singleRun)
+{
+    check_sort<uint32_t>(10000, 0);
+    check_sort<uint64_t>(10000, 1 << 20);
+}
+
+TEST_F(vectorSortTest, mergeRuns)
+{
+    // 4 runs of 1MB, merged 3 at a time
+    check_sort<uint32_t>(1 << 20, 2 << 20);
+    check_sort<uint64_t>(1 << 19, 2 << 20);
+}
+
+TEST_F(vectorSortTest, mergePasses)
+{
+    // tiny budgets merge two runs at a time over several passes
+    check_sort<uint32_t>(100000, 4096);
+    check_sort<uint64_t>(12345, 1000);
+    check_sort<uint32_t>(1000, 8);
+    check_sort<uint32_t>(1024, 4096);
+}
+
+TEST_F(vectorSortTest, emptyInput)
+{
+    check_sort<uint32_t>(0, 4096);
+}
+
+struct entry
+{
+    uint32_t key;
+    uint32_t value;
+    uint32_t check;
+};
+
+static int compare_entry(const item_t* first, const item_t* second)
+{
+    const uint32_t a = ((const entry*)first)->key, b = ((const entry*)second)->key;
+    return (a > b) - (a < b);
+}
+
+TEST_F(vectorSortTest, comparator)
+{
+    std::vector<entry> records(50000);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        records[i].key = rand() % 1000;
+        records[i].value = i;
+        records[i].check = records[i].key ^ records[i].value;
+    }
+    write_records(records);
+
+    vector_sort_options_t options = {};
+    options.memory_budget = 64 << 10;
+    options.temp_dir = "/tmp";
+    ASSERT_EQ(vector_sort_file(input, output, sizeof(entry), compare_entry, &options), ERROR_NONE);
+
+    const std::vector<entry> sorted = read_records<entry>();
+    ASSERT_EQ(sorted.size(), records.size());
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        ASSERT_EQ(sorted[i].check, sorted[i].key ^ sorted[i].value);
+        if (i > 0)
+        {
+            ASSERT_LE(sorted[i - 1].key, sorted[i].key);
+        }
+    }
+}
+
+TEST_F(vectorSortTest, pipes)
+{
+    std::vector<uint64_t> records(200000);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        records[i] = ((uint64_t)rand() << 32) | rand();
+    }
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    std::thread producer([&]() {
+        const uint8_t *data = (const uint8_t*)records.data();
+        size_t left = records.size() * sizeof(uint64_t);
+        while (left > 0)
+        {
+            const ssize_t n = write(fds[1], data, std::min(left, (size_t)10000));
+            data += n;
+            left -= n;
+        }
+        close(fds[1]);
+    });
+
+    int out = open(output, O_WRONLY | O_TRUNC);
+    vector_sort_options_t options = {};
+    options.memory_budget = 256 << 10;
+    EXPECT_EQ(vector_sort_fd(fds[0], out, sizeof(uint64_t), NULL, &options), ERROR_NONE);
+    producer.join();
+    close(fds[0]);
+    close(out);
+
+    std::sort(records.begin(), records.end());
+    EXPECT_EQ(read_records<uint64_t>(), records);
+}
+
+TEST_F(vectorSortTest, badInput)
+{
+    const std::vector<uint8_t> bytes(4099, 1);
+    write_records(bytes);
+
+    EXPECT_EQ(vector_sort_file(input, output, sizeof(uint32_t), NULL, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADFORMAT);
+
+    EXPECT_EQ(vector_sort_file(input, output, 3, NULL, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+
+    EXPECT_EQ(vector_sort_file("/nonexistent/input", output, sizeof(uint32_t), NULL, NULL), ERROR_FAILED);
+    EXPECT_EQ(errno, ENOENT);
+
+    vector_sort_options_t options = {};
+    options.memory_budget = 64;
+    options.temp_dir = "/nonexistent";
+    EXPECT_EQ(vector_sort_file(input, output, 1, NULL, &options), ERROR_FAILED);
+    EXPECT_EQ(errno, ENOENT);
+}
@@ -0,0 +1,186 @@
+/**
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2016 Vikash Kesarwani
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "include/ccollection.h"
+
+TEST(wsDequeTest, newDeque)
+{
+    ws_deque_t *deque = ws_deque_new(sizeof(int), 0);
+
+    ASSERT_TRUE(deque != NULL);
+    EXPECT_EQ(ws_deque_get_size(deque), 0);
+
+    ws_deque_destroy(deque);
+}
+
+TEST(wsDequeTest, newDequeBadSize)
+{
+    ws_deque_t *deque = ws_deque_new(0, 16);
+    EXPECT_TRUE(deque == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+
+    deque = ws_deque_new(WS_DEQUE_MAX_ELEMENT_SIZE + 1, 16);
+    EXPECT_TRUE(deque == NULL);
+    EXPECT_EQ(errno, EBADELEMSIZE);
+}
+
+TEST(wsDequeTest, emptyDeque)
+{
+    ws_deque_t *deque = ws_deque_new(sizeof(int), 4);
+    int out = -1;
+
+    EXPECT_EQ(ws_deque_pop(deque, &out), ERROR_FAILED);
+    EXPECT_EQ(errno, EEMPTY);
+    EXPECT_EQ(ws_deque_steal(deque, &out), ERROR_FAILED);
+    EXPECT_EQ(errno, EEMPTY);
+    EXPECT_EQ(out, -1);
+
+    ws_deque_destroy(deque);
+}
+
+TEST(wsDequeTest, popIsLifoStealIsFifo)
+{
+    ws_deque_t *deque = ws_deque_new(sizeof(int), 2);
+
+    // grows several times
+    const int count = 1000;
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(ws_deque_push(deque, &i), ERROR_NONE);
+    }
+    EXPECT_EQ(ws_deque_get_size(deque), count);
+
+    int out;
+    for (int i = 0; i < count / 2; i++)
+    {
+        ASSERT_EQ(ws_deque_steal(deque, &out), ERROR_NONE);
+        EXPECT_EQ(out, i);
+    }
+    for (int i = count - 1; i >= count / 2; i--)
+    {
+        ASSERT_EQ(ws_deque_pop(deque, &out), ERROR_NONE);
+        EXPECT_EQ(out, i);
+    }
+    EXPECT_EQ(ws_deque_get_size(deque), 0);
+    EXPECT_EQ(ws_deque_pop(deque, &out), ERROR_FAILED);
+
+    ws_deque_destroy(deque);
+}
+
+TEST(wsDequeTest, largeElements)
+{
+    struct task_t { long id; char payload[56]; };
+    ws_deque_t *deque = ws_deque_new(sizeof(task_t), 8);
+
+    for (long i = 0; i < 100; i++)
+    {
+        task_t task = { i, { 0 } };
+        task.payload[55] = (char)i;
+        ws_deque_push(deque, &task);
+    }
+    for (long i = 99; i >= 0; i--)
+    {
+        task_t task;
+        ASSERT_EQ(ws_deque_pop(deque, &task), ERROR_NONE);
+        EXPECT_EQ(task.id, i);
+        EXPECT_EQ(task.payload[55], (char)i);
+    }
+
+    ws_deque_destroy(deque);
+}
+
+TEST(wsDequeTest, stressOwnerAndThieves)
+{
+    ws_deque_t *deque = ws_deque_new(sizeof(int), 16);
+
+    const int count = 200000;
+    const int thieves = 4;
+
+    std::vector<std::atomic<int>> taken(count);
+    for (auto &t : taken)
+    {
+        t = 0;
+    }
+    std::atomic<bool> done(false);
+    std::atomic<int> consumed(0);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thieves; t++)
+    {
+        workers.emplace_back([&]() {
+            while (!done || ws_deque_get_size(deque) > 0)
+            {
+                // a lost race must leave out alone
+                int out = -1;
+                if (ws_deque_steal(deque, &out) == ERROR_NONE)
+                {
+                    taken[out]++;
+                    consumed++;
+                }
+                else
+                {
+                    EXPECT_EQ(out, -1);
+                }
+            }
+        });
+    }
+
+    // owner pushes everything and pops every third element back
+    int out;
+    for (int i = 0; i < count; i++)
+    {
+        ws_deque_push(deque, &i);
+        if (i % 3 == 0 && ws_deque_pop(deque, &out) == ERROR_NONE)
+        {
+            taken[out]++;
+            consumed++;
+        }
+    }
+    while (ws_deque_pop(deque, &out) == ERROR_NONE)
+    {
+        taken[out]++;
+        consumed++;
+    }
+    done = true;
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(consumed, count);
+    for (int i = 0; i < count; i++)
+    {
+        ASSERT_EQ(taken[i], 1) << "element " << i;
+    }
+
+    ws_deque_destroy(deque);
+}